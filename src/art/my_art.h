@@ -0,0 +1,941 @@
+#ifndef CONTAINERS_SRC_ART_MY_ART_H_
+#define CONTAINERS_SRC_ART_MY_ART_H_
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/my_vector.h"
+
+namespace my {
+namespace art {
+
+// Keys are turned into byte strings whose memcmp order is the key order,
+// and no encoded key is a prefix of another:
+//   unsigned integers  big endian
+//   signed integers    big endian with the sign bit flipped
+//   strings            0x00 escaped as 0x00 0xFF, then a 0x00 0x00 end
+template <typename Key, typename = void>
+struct key_codec {
+  static_assert(sizeof(Key) == 0, "type needs a my::art::key_codec");
+};
+
+template <typename Key>
+struct key_codec<
+    Key, typename std::enable_if<std::is_integral<Key>::value &&
+                                 !std::is_same<Key, bool>::value>::type> {
+  static void encode(const Key &key, std::string &out) {
+    using U = typename std::make_unsigned<Key>::type;
+    U bits = U(key);
+    if (std::is_signed<Key>::value) bits ^= U(U(1) << (sizeof(Key) * 8 - 1));
+    out.resize(sizeof(Key));
+    for (size_t i = 0; i < sizeof(Key); i++)
+      out[i] = char(bits >> (8 * (sizeof(Key) - 1 - i)));
+  }
+};
+
+template <>
+struct key_codec<std::string> {
+  static void encode(const std::string &key, std::string &out) {
+    out.clear();
+    out.reserve(key.size() + 2);
+    for (char c : key) {
+      out.push_back(c);
+      if (c == 0) out.push_back(char(0xFF));
+    }
+    out.push_back(0);
+    out.push_back(0);
+  }
+};
+
+constexpr size_t kMaxPrefix = 10;  // prefix bytes kept in a node
+
+enum node_type : uint8_t { kNode4, kNode16, kNode48, kNode256 };
+
+using ref = uintptr_t;  // child pointer, a leaf if the low bit is set
+
+struct inner {  // common header of the four node sizes
+  node_type type;
+  uint16_t count = 0;       // children in use
+  uint32_t prefix_len = 0;  // compressed path above the children
+  uint8_t prefix[kMaxPrefix] = {};
+
+  explicit inner(node_type t) : type(t) {}
+};
+
+struct node4 : inner {
+  uint8_t keys[4] = {};  // sorted
+  ref child[4] = {};
+  node4() : inner(kNode4) {}
+};
+
+struct node16 : inner {
+  uint8_t keys[16] = {};  // sorted
+  ref child[16] = {};
+  node16() : inner(kNode16) {}
+};
+
+struct node48 : inner {
+  uint8_t index[256] = {};  // 1 + slot in child, 0 if absent
+  ref child[48] = {};
+  node48() : inner(kNode48) {}
+};
+
+struct node256 : inner {
+  ref child[256] = {};
+  node256() : inner(kNode256) {}
+};
+
+inline int find16(const uint8_t *keys, unsigned count, uint8_t byte) {
+#if defined(__SSE2__)
+  __m128i cmp = _mm_cmpeq_epi8(
+      _mm_set1_epi8(char(byte)),
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)));
+  unsigned mask = _mm_movemask_epi8(cmp) & ((1u << count) - 1);
+  return mask ? __builtin_ctz(mask) : -1;
+#else
+  for (unsigned i = 0; i < count; i++)
+    if (keys[i] == byte) return int(i);
+  return -1;
+#endif
+}
+
+inline unsigned upper16(const uint8_t *keys, unsigned count, uint8_t byte) {
+#if defined(__SSE2__)  // unsigned compare through the flipped sign bit
+  __m128i bias = _mm_set1_epi8(char(0x80));
+  __m128i greater = _mm_cmpgt_epi8(
+      _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys)),
+                    bias),
+      _mm_xor_si128(_mm_set1_epi8(char(byte)), bias));
+  unsigned mask = _mm_movemask_epi8(greater) & ((1u << count) - 1);
+  return mask ? __builtin_ctz(mask) : count;
+#else
+  unsigned i = 0;
+  while (i < count && keys[i] <= byte) i++;
+  return i;
+#endif
+}
+
+}  // namespace art
+
+// Adaptive radix tree (Leis et al.) shared by art_map and art_set. Inner
+// nodes grow and shrink between 4, 16, 48 and 256 children; a chain of
+// single children is folded into the prefix of the node below. The leaves
+// hold the elements and form a sorted doubly linked list for iteration.
+template <typename Key, typename Slot>
+class radix_tree {
+ public:
+  using size_type = size_t;
+
+ private:
+  using ref = art::ref;
+  using inner = art::inner;
+  using codec = art::key_codec<Key>;
+
+  struct leaf {
+    leaf *prev = nullptr, *next = nullptr;
+    std::string bytes;  // encoded key
+    Slot value;
+
+    template <typename... Args>
+    leaf(std::string &&encoded, Args &&...args)
+        : bytes(std::move(encoded)), value(std::forward<Args>(args)...) {}
+  };
+
+ public:
+  //------------------ITERATOR------------------// walks the leaf list
+  class iterator {
+   public:
+    iterator(const radix_tree *tree = nullptr, leaf *pos = nullptr)
+        : owner(tree), current(pos) {}
+    Slot &operator*() const { return current->value; }
+    Slot *operator->() const { return &current->value; }
+
+    iterator &operator++() {
+      current = current->next;
+      return *this;
+    }
+    iterator &operator--() {  // from end() to the last element
+      current = current ? current->prev : owner->tail;
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return current == other.current;
+    }
+    bool operator!=(const iterator &other) const {
+      return current != other.current;
+    }
+
+   private:
+    const radix_tree *owner;
+    leaf *current;
+    friend class radix_tree;
+  };  // class iterator
+
+  radix_tree() {}
+  radix_tree(const radix_tree &other) {
+    for (leaf *l = other.head; l; l = l->next)
+      emplace_key(key_of(l->value), l->value);
+  }
+  radix_tree(radix_tree &&other) noexcept { swap(other); }
+  radix_tree &operator=(const radix_tree &other) {
+    if (this != &other) {
+      radix_tree tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+  radix_tree &operator=(radix_tree &&other) noexcept {
+    if (this != &other) {
+      radix_tree tmp(std::move(other));
+      swap(tmp);
+    }
+    return *this;
+  }
+  ~radix_tree() { clear(); }
+
+  iterator begin() const { return iterator(this, head); }
+  iterator end() const { return iterator(this, nullptr); }
+  bool empty() const { return count == 0; }
+  size_type size() const { return count; }
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(leaf);
+  }
+
+  void clear() {
+    destroy(root);
+    root = 0;
+    head = tail = nullptr;
+    count = 0;
+  }
+  void swap(radix_tree &other) noexcept {
+    std::swap(root, other.root);
+    std::swap(head, other.head);
+    std::swap(tail, other.tail);
+    std::swap(count, other.count);
+  }
+
+  iterator find(const Key &key) const;
+  iterator lower_bound(const Key &key) const;
+  iterator upper_bound(const Key &key) const {
+    iterator it = lower_bound(key);
+    if (it != end() && !(key < key_of(*it)) && !(key_of(*it) < key)) ++it;
+    return it;
+  }
+  bool contains(const Key &key) const { return find(key) != end(); }
+
+  template <typename... Args>  // builds Slot(args...) if key is missing
+  std::pair<iterator, bool> emplace_key(const Key &key, Args &&...args);
+  bool erase(const Key &key);
+  void erase(iterator it) {
+    if (it.current) erase(key_of(it.current->value));
+  }
+
+ private:
+  ref root = 0;
+  leaf *head = nullptr, *tail = nullptr;
+  size_type count = 0;
+
+  static const Key &key_of(const Slot &slot) {
+    if constexpr (std::is_same<Slot, Key>::value)
+      return slot;
+    else
+      return slot.first;
+  }
+  static bool is_leaf(ref r) { return r & 1; }
+  static leaf *as_leaf(ref r) { return reinterpret_cast<leaf *>(r & ~ref(1)); }
+  static inner *as_inner(ref r) { return reinterpret_cast<inner *>(r); }
+  static ref tag(leaf *l) { return reinterpret_cast<ref>(l) | 1; }
+  static ref raw(inner *n) { return reinterpret_cast<ref>(n); }
+
+  static ref *find_child(inner *n, uint8_t byte);
+  static ref next_child(inner *n, int byte);  // smallest child above byte
+  static void add_child(ref &slot, inner *n, uint8_t byte, ref child);
+  static void remove_child(ref &slot, inner *n, uint8_t byte, ref *where);
+  static leaf *minimum(ref r);
+  static leaf *maximum(ref r);
+  static size_t prefix_mismatch(inner *n, const std::string &key,
+                                size_t depth);
+  static void destroy(ref r);
+
+  template <typename Make>
+  leaf *insert_rec(ref &slot, const std::string &key, size_t depth,
+                   Make &make, bool &inserted);
+  leaf *erase_rec(ref &slot, const std::string &key, size_t depth);
+  leaf *lower_rec(ref r, const std::string &key, size_t depth) const;
+  void link(leaf *l, leaf *successor);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Slot>
+art::ref *radix_tree<Key, Slot>::find_child(inner *n, uint8_t byte) {
+  switch (n->type) {
+    case art::kNode4: {
+      art::node4 *p = static_cast<art::node4 *>(n);
+      for (unsigned i = 0; i < p->count; i++)
+        if (p->keys[i] == byte) return &p->child[i];
+      return nullptr;
+    }
+    case art::kNode16: {
+      art::node16 *p = static_cast<art::node16 *>(n);
+      int i = art::find16(p->keys, p->count, byte);
+      return i < 0 ? nullptr : &p->child[i];
+    }
+    case art::kNode48: {
+      art::node48 *p = static_cast<art::node48 *>(n);
+      return p->index[byte] ? &p->child[p->index[byte] - 1] : nullptr;
+    }
+    default: {
+      art::node256 *p = static_cast<art::node256 *>(n);
+      return p->child[byte] ? &p->child[byte] : nullptr;
+    }
+  }
+}
+
+template <typename Key, typename Slot>
+art::ref radix_tree<Key, Slot>::next_child(inner *n, int byte) {
+  switch (n->type) {
+    case art::kNode4: {
+      art::node4 *p = static_cast<art::node4 *>(n);
+      for (unsigned i = 0; i < p->count; i++)
+        if (p->keys[i] > byte) return p->child[i];
+      return 0;
+    }
+    case art::kNode16: {
+      art::node16 *p = static_cast<art::node16 *>(n);
+      if (byte < 0) return p->child[0];
+      unsigned i = art::upper16(p->keys, p->count, uint8_t(byte));
+      return i < p->count ? p->child[i] : 0;
+    }
+    case art::kNode48: {
+      art::node48 *p = static_cast<art::node48 *>(n);
+      for (int b = byte + 1; b < 256; b++)
+        if (p->index[b]) return p->child[p->index[b] - 1];
+      return 0;
+    }
+    default: {
+      art::node256 *p = static_cast<art::node256 *>(n);
+      for (int b = byte + 1; b < 256; b++)
+        if (p->child[b]) return p->child[b];
+      return 0;
+    }
+  }
+}
+
+template <typename Key, typename Slot>
+void radix_tree<Key, Slot>::add_child(ref &slot, inner *n, uint8_t byte,
+                                      ref child) {
+  switch (n->type) {
+    case art::kNode4: {
+      art::node4 *p = static_cast<art::node4 *>(n);
+      if (p->count < 4) {
+        unsigned pos = 0;
+        while (pos < p->count && p->keys[pos] < byte) pos++;
+        std::memmove(p->keys + pos + 1, p->keys + pos, p->count - pos);
+        std::memmove(p->child + pos + 1, p->child + pos,
+                     (p->count - pos) * sizeof(ref));
+        p->keys[pos] = byte;
+        p->child[pos] = child;
+        p->count++;
+        return;
+      }
+      art::node16 *grown = new art::node16;  // full, move up to 16
+      static_cast<inner &>(*grown) = *p;
+      grown->type = art::kNode16;
+      std::memcpy(grown->keys, p->keys, sizeof(p->keys));
+      std::memcpy(grown->child, p->child, sizeof(p->child));
+      delete p;
+      slot = raw(grown);
+      add_child(slot, grown, byte, child);
+      return;
+    }
+    case art::kNode16: {
+      art::node16 *p = static_cast<art::node16 *>(n);
+      if (p->count < 16) {
+        unsigned pos = art::upper16(p->keys, p->count, byte);
+        std::memmove(p->keys + pos + 1, p->keys + pos, p->count - pos);
+        std::memmove(p->child + pos + 1, p->child + pos,
+                     (p->count - pos) * sizeof(ref));
+        p->keys[pos] = byte;
+        p->child[pos] = child;
+        p->count++;
+        return;
+      }
+      art::node48 *grown = new art::node48;
+      static_cast<inner &>(*grown) = *p;
+      grown->type = art::kNode48;
+      for (unsigned i = 0; i < 16; i++) {
+        grown->index[p->keys[i]] = uint8_t(i + 1);
+        grown->child[i] = p->child[i];
+      }
+      delete p;
+      slot = raw(grown);
+      add_child(slot, grown, byte, child);
+      return;
+    }
+    case art::kNode48: {
+      art::node48 *p = static_cast<art::node48 *>(n);
+      if (p->count < 48) {
+        unsigned pos = 0;
+        while (p->child[pos]) pos++;
+        p->child[pos] = child;
+        p->index[byte] = uint8_t(pos + 1);
+        p->count++;
+        return;
+      }
+      art::node256 *grown = new art::node256;
+      static_cast<inner &>(*grown) = *p;
+      grown->type = art::kNode256;
+      for (unsigned b = 0; b < 256; b++)
+        if (p->index[b]) grown->child[b] = p->child[p->index[b] - 1];
+      delete p;
+      slot = raw(grown);
+      add_child(slot, grown, byte, child);
+      return;
+    }
+    default: {
+      art::node256 *p = static_cast<art::node256 *>(n);
+      p->child[byte] = child;
+      p->count++;
+    }
+  }
+}
+
+template <typename Key, typename Slot>
+void radix_tree<Key, Slot>::remove_child(ref &slot, inner *n, uint8_t byte,
+                                         ref *where) {
+  switch (n->type) {
+    case art::kNode4: {
+      art::node4 *p = static_cast<art::node4 *>(n);
+      unsigned pos = unsigned(where - p->child);
+      std::memmove(p->keys + pos, p->keys + pos + 1, p->count - pos - 1);
+      std::memmove(p->child + pos, p->child + pos + 1,
+                   (p->count - pos - 1) * sizeof(ref));
+      p->count--;
+      if (p->count == 1) {  // fold the node into its only child
+        ref only = p->child[0];
+        if (!is_leaf(only)) {
+          inner *below = as_inner(only);
+          uint32_t len = p->prefix_len;
+          if (len < art::kMaxPrefix) p->prefix[len++] = p->keys[0];
+          if (len < art::kMaxPrefix) {
+            uint32_t more =
+                std::min<uint32_t>(below->prefix_len, art::kMaxPrefix - len);
+            std::memcpy(p->prefix + len, below->prefix, more);
+            len += more;
+          }
+          std::memcpy(below->prefix, p->prefix,
+                      std::min<uint32_t>(len, art::kMaxPrefix));
+          below->prefix_len += p->prefix_len + 1;
+        }
+        slot = only;
+        delete p;
+      }
+      return;
+    }
+    case art::kNode16: {
+      art::node16 *p = static_cast<art::node16 *>(n);
+      unsigned pos = unsigned(where - p->child);
+      std::memmove(p->keys + pos, p->keys + pos + 1, p->count - pos - 1);
+      std::memmove(p->child + pos, p->child + pos + 1,
+                   (p->count - pos - 1) * sizeof(ref));
+      p->count--;
+      if (p->count == 3) {
+        art::node4 *shrunk = new art::node4;
+        static_cast<inner &>(*shrunk) = *p;
+        shrunk->type = art::kNode4;
+        std::memcpy(shrunk->keys, p->keys, 3);
+        std::memcpy(shrunk->child, p->child, 3 * sizeof(ref));
+        delete p;
+        slot = raw(shrunk);
+      }
+      return;
+    }
+    case art::kNode48: {
+      art::node48 *p = static_cast<art::node48 *>(n);
+      p->child[p->index[byte] - 1] = 0;
+      p->index[byte] = 0;
+      p->count--;
+      if (p->count == 12) {
+        art::node16 *shrunk = new art::node16;
+        static_cast<inner &>(*shrunk) = *p;
+        shrunk->type = art::kNode16;
+        unsigned k = 0;
+        for (unsigned b = 0; b < 256; b++) {
+          if (!p->index[b]) continue;
+          shrunk->keys[k] = uint8_t(b);
+          shrunk->child[k++] = p->child[p->index[b] - 1];
+        }
+        delete p;
+        slot = raw(shrunk);
+      }
+      return;
+    }
+    default: {
+      art::node256 *p = static_cast<art::node256 *>(n);
+      p->child[byte] = 0;
+      p->count--;
+      if (p->count == 37) {
+        art::node48 *shrunk = new art::node48;
+        static_cast<inner &>(*shrunk) = *p;
+        shrunk->type = art::kNode48;
+        unsigned k = 0;
+        for (unsigned b = 0; b < 256; b++) {
+          if (!p->child[b]) continue;
+          shrunk->child[k] = p->child[b];
+          shrunk->index[b] = uint8_t(++k);
+        }
+        delete p;
+        slot = raw(shrunk);
+      }
+    }
+  }
+}
+
+template <typename Key, typename Slot>
+typename radix_tree<Key, Slot>::leaf *radix_tree<Key, Slot>::minimum(ref r) {
+  while (r && !is_leaf(r)) r = next_child(as_inner(r), -1);
+  return r ? as_leaf(r) : nullptr;
+}
+
+template <typename Key, typename Slot>
+typename radix_tree<Key, Slot>::leaf *radix_tree<Key, Slot>::maximum(ref r) {
+  while (r && !is_leaf(r)) {
+    inner *n = as_inner(r);
+    switch (n->type) {
+      case art::kNode4:
+        r = static_cast<art::node4 *>(n)->child[n->count - 1];
+        break;
+      case art::kNode16:
+        r = static_cast<art::node16 *>(n)->child[n->count - 1];
+        break;
+      case art::kNode48: {
+        art::node48 *p = static_cast<art::node48 *>(n);
+        int b = 255;
+        while (!p->index[b]) b--;
+        r = p->child[p->index[b] - 1];
+        break;
+      }
+      default: {
+        art::node256 *p = static_cast<art::node256 *>(n);
+        int b = 255;
+        while (!p->child[b]) b--;
+        r = p->child[b];
+      }
+    }
+  }
+  return r ? as_leaf(r) : nullptr;
+}
+
+template <typename Key, typename Slot>
+size_t radix_tree<Key, Slot>::prefix_mismatch(inner *n,
+                                              const std::string &key,
+                                              size_t depth) {
+  // bytes past kMaxPrefix are not in the node, any leaf below has them
+  size_t stored = std::min<size_t>(n->prefix_len, art::kMaxPrefix);
+  size_t limit = std::min(stored, key.size() - depth), i = 0;
+  for (; i < limit; i++)
+    if (n->prefix[i] != uint8_t(key[depth + i])) return i;
+  if (n->prefix_len > art::kMaxPrefix) {
+    const std::string &full = minimum(raw(n))->bytes;
+    limit = std::min<size_t>(n->prefix_len, key.size() - depth);
+    for (; i < limit; i++)
+      if (full[depth + i] != key[depth + i]) return i;
+  }
+  return i;
+}
+
+template <typename Key, typename Slot>
+void radix_tree<Key, Slot>::destroy(ref r) {
+  if (!r) return;
+  if (is_leaf(r)) {
+    delete as_leaf(r);
+    return;
+  }
+  inner *n = as_inner(r);
+  switch (n->type) {
+    case art::kNode4: {
+      art::node4 *p = static_cast<art::node4 *>(n);
+      for (unsigned i = 0; i < p->count; i++) destroy(p->child[i]);
+      delete p;
+      break;
+    }
+    case art::kNode16: {
+      art::node16 *p = static_cast<art::node16 *>(n);
+      for (unsigned i = 0; i < p->count; i++) destroy(p->child[i]);
+      delete p;
+      break;
+    }
+    case art::kNode48: {
+      art::node48 *p = static_cast<art::node48 *>(n);
+      for (ref child : p->child) destroy(child);
+      delete p;
+      break;
+    }
+    default: {
+      art::node256 *p = static_cast<art::node256 *>(n);
+      for (ref child : p->child) destroy(child);
+      delete p;
+    }
+  }
+}
+
+template <typename Key, typename Slot>
+void radix_tree<Key, Slot>::link(leaf *l, leaf *successor) {
+  l->next = successor;
+  l->prev = successor ? successor->prev : tail;
+  (l->prev ? l->prev->next : head) = l;
+  (successor ? successor->prev : tail) = l;
+}
+
+template <typename Key, typename Slot>
+template <typename Make>
+typename radix_tree<Key, Slot>::leaf *radix_tree<Key, Slot>::insert_rec(
+    ref &slot, const std::string &key, size_t depth, Make &make,
+    bool &inserted) {
+  if (slot == 0) {  // empty tree
+    leaf *l = make();
+    slot = tag(l);
+    link(l, nullptr);
+    inserted = true;
+    return l;
+  }
+  if (is_leaf(slot)) {  // two keys share the path up to here, split
+    leaf *old = as_leaf(slot);
+    if (old->bytes == key) return old;
+    size_t common = depth;
+    while (old->bytes[common] == key[common]) common++;
+    art::node4 *n = new art::node4;
+    n->prefix_len = uint32_t(common - depth);
+    std::memcpy(n->prefix, key.data() + depth,
+                std::min<size_t>(n->prefix_len, art::kMaxPrefix));
+    leaf *l = make();
+    ref split = raw(n);
+    add_child(split, n, uint8_t(old->bytes[common]), slot);
+    add_child(split, n, uint8_t(key[common]), tag(l));
+    slot = split;
+    link(l, uint8_t(old->bytes[common]) > uint8_t(key[common]) ? old
+                                                               : old->next);
+    inserted = true;
+    return l;
+  }
+
+  inner *n = as_inner(slot);
+  if (n->prefix_len) {
+    size_t same = prefix_mismatch(n, key, depth);
+    if (same < n->prefix_len) {  // key leaves the compressed path early
+      art::node4 *split = new art::node4;
+      split->prefix_len = uint32_t(same);
+      std::memcpy(split->prefix, n->prefix,
+                  std::min<size_t>(same, art::kMaxPrefix));
+      leaf *low = minimum(slot), *high = maximum(slot);
+      uint8_t old_byte = n->prefix_len <= art::kMaxPrefix
+                             ? n->prefix[same]
+                             : uint8_t(low->bytes[depth + same]);
+      n->prefix_len -= uint32_t(same + 1);
+      if (n->prefix_len + same + 1 <= art::kMaxPrefix) {
+        std::memmove(n->prefix, n->prefix + same + 1, n->prefix_len);
+      } else {
+        std::memcpy(n->prefix, low->bytes.data() + depth + same + 1,
+                    std::min<size_t>(n->prefix_len, art::kMaxPrefix));
+      }
+      ref top = raw(split);
+      add_child(top, split, old_byte, slot);
+      leaf *l = make();
+      add_child(top, split, uint8_t(key[depth + same]), tag(l));
+      slot = top;
+      link(l, old_byte > uint8_t(key[depth + same]) ? low : high->next);
+      inserted = true;
+      return l;
+    }
+    depth += n->prefix_len;
+  }
+  uint8_t byte = uint8_t(key[depth]);
+  if (ref *child = find_child(n, byte))
+    return insert_rec(*child, key, depth + 1, make, inserted);
+  ref after = next_child(n, byte);
+  leaf *successor = after ? minimum(after) : maximum(slot)->next;
+  leaf *l = make();
+  add_child(slot, n, byte, tag(l));
+  link(l, successor);
+  inserted = true;
+  return l;
+}
+
+template <typename Key, typename Slot>
+template <typename... Args>
+std::pair<typename radix_tree<Key, Slot>::iterator, bool>
+radix_tree<Key, Slot>::emplace_key(const Key &key, Args &&...args) {
+  std::string bytes;
+  codec::encode(key, bytes);
+  bool inserted = false;
+  auto make = [&]() {
+    std::string copy = bytes;
+    return new leaf(std::move(copy), std::forward<Args>(args)...);
+  };
+  leaf *l = insert_rec(root, bytes, 0, make, inserted);
+  if (inserted) ++count;
+  return {iterator(this, l), inserted};
+}
+
+template <typename Key, typename Slot>
+typename radix_tree<Key, Slot>::iterator radix_tree<Key, Slot>::find(
+    const Key &key) const {
+  std::string bytes;
+  codec::encode(key, bytes);
+  ref r = root;
+  size_t depth = 0;
+  while (r && !is_leaf(r)) {
+    inner *n = as_inner(r);
+    if (n->prefix_len) {  // only the kept bytes, the leaf has the rest
+      if (depth + n->prefix_len >= bytes.size()) return end();
+      size_t stored = std::min<size_t>(n->prefix_len, art::kMaxPrefix);
+      if (std::memcmp(n->prefix, bytes.data() + depth, stored) != 0)
+        return end();
+      depth += n->prefix_len;
+    }
+    ref *child = find_child(n, uint8_t(bytes[depth++]));
+    if (!child) return end();
+    r = *child;
+  }
+  if (r && as_leaf(r)->bytes == bytes) return iterator(this, as_leaf(r));
+  return end();
+}
+
+template <typename Key, typename Slot>
+typename radix_tree<Key, Slot>::leaf *radix_tree<Key, Slot>::lower_rec(
+    ref r, const std::string &key, size_t depth) const {
+  if (is_leaf(r)) {
+    leaf *l = as_leaf(r);
+    return l->bytes >= key ? l : l->next;
+  }
+  inner *n = as_inner(r);
+  if (n->prefix_len) {
+    const uint8_t *path = n->prefix;
+    if (n->prefix_len > art::kMaxPrefix)
+      path = reinterpret_cast<const uint8_t *>(minimum(r)->bytes.data()) +
+             depth;
+    for (size_t i = 0; i < n->prefix_len; i++) {
+      if (depth + i >= key.size()) return minimum(r);
+      uint8_t byte = uint8_t(key[depth + i]);
+      if (path[i] > byte) return minimum(r);  // whole subtree is above key
+      if (path[i] < byte) return maximum(r)->next;  // or below it
+    }
+    depth += n->prefix_len;
+  }
+  if (depth >= key.size()) return minimum(r);
+  uint8_t byte = uint8_t(key[depth]);
+  if (ref *child = find_child(n, byte))
+    return lower_rec(*child, key, depth + 1);
+  ref after = next_child(n, byte);
+  return after ? minimum(after) : maximum(r)->next;
+}
+
+template <typename Key, typename Slot>
+typename radix_tree<Key, Slot>::iterator radix_tree<Key, Slot>::lower_bound(
+    const Key &key) const {
+  if (!root) return end();
+  std::string bytes;
+  codec::encode(key, bytes);
+  return iterator(this, lower_rec(root, bytes, 0));
+}
+
+template <typename Key, typename Slot>
+typename radix_tree<Key, Slot>::leaf *radix_tree<Key, Slot>::erase_rec(
+    ref &slot, const std::string &key, size_t depth) {
+  if (!slot) return nullptr;
+  if (is_leaf(slot)) {  // only a leaf root gets here
+    leaf *l = as_leaf(slot);
+    if (l->bytes != key) return nullptr;
+    slot = 0;
+    return l;
+  }
+  inner *n = as_inner(slot);
+  if (n->prefix_len) {
+    if (prefix_mismatch(n, key, depth) < n->prefix_len) return nullptr;
+    depth += n->prefix_len;
+  }
+  if (depth >= key.size()) return nullptr;
+  uint8_t byte = uint8_t(key[depth]);
+  ref *child = find_child(n, byte);
+  if (!child) return nullptr;
+  if (is_leaf(*child)) {
+    leaf *l = as_leaf(*child);
+    if (l->bytes != key) return nullptr;
+    remove_child(slot, n, byte, child);
+    return l;
+  }
+  return erase_rec(*child, key, depth + 1);
+}
+
+template <typename Key, typename Slot>
+bool radix_tree<Key, Slot>::erase(const Key &key) {
+  std::string bytes;
+  codec::encode(key, bytes);
+  leaf *l = erase_rec(root, bytes, 0);
+  if (!l) return false;
+  (l->prev ? l->prev->next : head) = l->next;
+  (l->next ? l->next->prev : tail) = l->prev;
+  delete l;
+  --count;
+  return true;
+}
+
+//------------------SET------------------//
+template <typename Key>
+class art_set {
+ private:
+  using tree_type = radix_tree<Key, Key>;
+  using tree_iterator = typename tree_type::iterator;
+  tree_type tree;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+
+  class iterator : public tree_iterator {  // keys are read only
+   public:
+    iterator(const tree_iterator &it) : tree_iterator(it) {}
+    const Key &operator*() const { return tree_iterator::operator*(); }
+    const Key *operator->() const { return tree_iterator::operator->(); }
+    iterator &operator++() {
+      tree_iterator::operator++();
+      return *this;
+    }
+    iterator &operator--() {
+      tree_iterator::operator--();
+      return *this;
+    }
+  };
+
+  art_set() {}
+  art_set(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item);
+  }
+
+  iterator begin() const { return tree.begin(); }
+  iterator end() const { return tree.end(); }
+
+  bool empty() const { return tree.empty(); }
+  size_type size() const { return tree.size(); }
+  size_type max_size() const { return tree.max_size(); }
+
+  void clear() { tree.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    auto res = tree.emplace_key(value, value);
+    return {iterator(res.first), res.second};
+  }
+  bool erase(const value_type &value) { return tree.erase(value); }
+  iterator erase(iterator it) {
+    iterator next = it;
+    ++next;
+    tree.erase(it);
+    return next;
+  }
+  void merge(art_set &other) {
+    for (const auto &key : other) insert(key);
+  }
+
+  iterator find(const Key &key) const { return tree.find(key); }
+  bool contains(const Key &key) const { return tree.contains(key); }
+  iterator lower_bound(const Key &key) const { return tree.lower_bound(key); }
+  iterator upper_bound(const Key &key) const { return tree.upper_bound(key); }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<std::pair<iterator, bool>> out;
+    ((out.push_back(this->insert(args))), ...);
+    return out;
+  }
+};
+
+//------------------MAP------------------//
+template <typename Key, typename T>
+class art_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = size_t;
+
+ private:
+  using tree_type = radix_tree<Key, value_type>;
+  tree_type tree;
+
+ public:
+  using iterator = typename tree_type::iterator;
+
+  art_map() {}
+  art_map(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item);
+  }
+
+  T &at(const Key &key) {
+    iterator it = tree.find(key);
+    if (it == end()) throw std::out_of_range("Key not found");
+    return it->second;
+  }
+  const T &at(const Key &key) const {
+    iterator it = tree.find(key);
+    if (it == end()) throw std::out_of_range("Key not found");
+    return it->second;
+  }
+  T &operator[](const Key &key) {
+    return tree
+        .emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                     std::forward_as_tuple())
+        .first->second;
+  }
+
+  iterator begin() const { return tree.begin(); }
+  iterator end() const { return tree.end(); }
+
+  bool empty() const { return tree.empty(); }
+  size_type size() const { return tree.size(); }
+  size_type max_size() const { return tree.max_size(); }
+
+  void clear() { tree.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return tree.emplace_key(value.first, value);
+  }
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return tree.emplace_key(key, key, obj);
+  }
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    auto res = tree.emplace_key(key, key, obj);
+    if (!res.second) res.first->second = obj;
+    return res;
+  }
+  void erase(iterator it) { tree.erase(it); }
+  bool erase(const Key &key) { return tree.erase(key); }
+  void merge(art_map &other) {  // values of other win on equal keys
+    for (const auto &item : other) insert_or_assign(item.first, item.second);
+  }
+
+  iterator find(const Key &key) const { return tree.find(key); }
+  bool contains(const Key &key) const { return tree.contains(key); }
+  iterator lower_bound(const Key &key) const { return tree.lower_bound(key); }
+  iterator upper_bound(const Key &key) const { return tree.upper_bound(key); }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<std::pair<iterator, bool>> out;
+    ((out.push_back(this->insert(args))), ...);
+    return out;
+  }
+};
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_ART_MY_ART_H_
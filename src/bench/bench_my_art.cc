@@ -0,0 +1,84 @@
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Ordered maps on byte comparable keys: the red-black my::map and std::map
+// against the adaptive radix tree art_map, for dense integers, sparse
+// 64 bit ids and URL strings.
+
+static const int kCount = 100000;
+static const int kLookups = 1000000;
+
+template <typename Map, typename Key, bool kBounds = true>
+void run(const char *name, const std::vector<Key> &keys) {
+  Map map;
+  double insert_rate = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) map[keys[i]] = i;
+  });
+  long found = 0;
+  double lookup_rate = rate(kLookups, [&] {  // second half of keys misses
+    for (int i = 0; i < kLookups; i++) {
+      const Key &key = keys[(i * 7) % (2 * kCount)];
+      if constexpr (kBounds)
+        found += map.find(key) != map.end();
+      else
+        found += map.contains(key);
+    }
+  });
+  std::cout << "  " << name << insert_rate << " insert  " << lookup_rate
+            << " lookup";
+  if constexpr (kBounds) {  // my::map has no find or lower_bound
+    double bound_rate = rate(kLookups, [&] {
+      for (int i = 0; i < kLookups; i++) {
+        auto it = map.lower_bound(keys[(i * 7) % (2 * kCount)]);
+        if (it != map.end()) found += it->second & 1;
+      }
+    });
+    std::cout << "  " << bound_rate << " lower_bound";
+  }
+  std::cout << "  Mops/s  (" << found << ")\n";
+}
+
+template <typename Key>
+void compare(const char *title, const std::vector<Key> &keys) {
+  std::cout << title << "\n";
+  run<my::map<Key, int>, Key, false>("my::map       ", keys);
+  run<std::map<Key, int>>("std::map      ", keys);
+  run<my::art_map<Key, int>>("my::art_map   ", keys);
+}
+
+int main() {
+  uint64_t state = 88172645463325252ull;
+  auto next = [&state] {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+
+  std::vector<uint32_t> dense(2 * kCount);  // a shuffled 0..n range
+  for (int i = 0; i < 2 * kCount; i++) dense[i] = i;
+  for (int i = kCount - 1; i > 0; i--)
+    std::swap(dense[i], dense[next() % (i + 1)]);
+  std::vector<uint64_t> sparse(2 * kCount);
+  for (auto &key : sparse) key = next();
+  std::vector<std::string> urls(2 * kCount);
+  const char *hosts[] = {"https://example.com/", "https://shop.example.com/",
+                         "https://cdn.example.net/static/"};
+  for (auto &url : urls) {
+    uint64_t r = next();
+    url = std::string(hosts[r % 3]) + (r & 8 ? "users/" : "items/") +
+          std::to_string(r >> 40) + "/page/" + std::to_string(r % 97);
+  }
+
+  std::cout << kCount << " keys, " << kLookups << " queries, half misses\n";
+  compare("dense uint32", dense);
+  compare("sparse uint64 ids", sparse);
+  compare("url strings", urls);
+  return 0;
+}
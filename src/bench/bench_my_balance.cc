@@ -0,0 +1,73 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers.h"
+#include "bench_util.h"
+
+// my::map under the red-black, AVL and splay balancing policies, on a read
+// mostly workload, a skewed (Zipf) lookup workload, insert/erase churn and
+// sorted inserts.
+
+static const int kCount = 100000;
+static const int kLookups = 2000000;
+
+struct workload {
+  std::vector<int> keys;     // random, distinct
+  std::vector<int> uniform;  // indexes into keys
+  std::vector<int> zipf;     // indexes into keys, s = 1.1
+};
+
+template <typename Balance>
+void run(const char *name, const workload &w) {
+  using map = my::map<int, int, std::less<int>, Balance>;
+  map m;
+  double insert_rate = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) m[w.keys[i]] = i;
+  });
+  long found = 0;
+  double read_rate = rate(kLookups, [&] {  // const lookups, no splaying
+    for (int i : w.uniform) found += m.contains(w.keys[i]);
+  });
+  double skew_rate = rate(kLookups, [&] {  // at() may restructure
+    for (int i : w.zipf) found += m.at(w.keys[i]) & 1;
+  });
+  double churn_rate = rate(kCount, [&] {
+    for (int i = 0; i < kCount / 2; i++) {
+      m.erase(w.keys[i]);
+      m[w.keys[i]] = i;
+    }
+  });
+  map sorted;
+  double sorted_rate = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) sorted[i] = i;
+  });
+  std::cout << name << insert_rate << " insert  " << read_rate
+            << " uniform  " << skew_rate << " zipf  " << churn_rate
+            << " churn  " << sorted_rate << " sorted insert  Mops/s  ("
+            << found << ")\n";
+}
+
+int main() {
+  workload w;
+  uint64_t state = 88172645463325252ull;
+  auto next = [&state] {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+  std::vector<bool> used(1 << 24);
+  while (int(w.keys.size()) < kCount) {
+    int key = int(next() >> 40);
+    if (!used[key]) w.keys.push_back(key);
+    used[key] = true;
+  }
+  for (int i = 0; i < kLookups; i++) w.uniform.push_back(int(next() % kCount));
+  w.zipf = zipf_ranks(kCount, kLookups, 1.1);
+
+  std::cout << kCount << " keys, " << kLookups << " lookups\n";
+  run<my::rb_balance>("red-black  ", w);
+  run<my::avl_balance>("avl        ", w);
+  run<my::splay_balance>("splay      ", w);
+  return 0;
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "../my_containers.h"
+#include "bench_util.h"
+
+// Dedup style lookups where 95% of the keys are missing: set::contains
+// with and without the blocked Bloom filter.
+
+int main() {
+  const int kCount = 200000, kLookups = 2000000;
+  std::vector<long> keys(kCount);
+  for (int i = 0; i < kCount; i++) keys[i] = long(i) * 20;  // sorted
+  std::stringstream stream;  // bulk load through the binary format
+  my::serial::write_header<long, long>(stream, my::serial::kSet, kCount);
+  my::serial::write_block(stream, keys.data(), keys.size());
+  my::set<long> set;
+  set.deserialize(stream);
+
+  std::vector<long> queries(kLookups);
+  uint64_t state = 88172645463325252ull;
+  for (auto &query : queries) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    long slot = long(state % (20 * kCount));
+    query = state % 20 == 0 ? slot / 20 * 20 : slot | 1;  // 5% hits
+  }
+
+  for (int filtered = 0; filtered < 2; filtered++) {
+    if (filtered) set.enable_bloom(0.01);
+    size_t hits = set.contains(-1);  // builds the filter outside the timing
+    double mops = rate(kLookups, [&] {
+      for (long query : queries) hits += set.contains(query);
+    });
+    std::cout << (filtered ? "with bloom:    " : "without bloom: ") << mops
+              << " Mops/s  (" << hits
+              << " hits)\n";
+  }
+  my::bloom_stats stats = set.get_bloom_stats();
+  std::cout << "filter " << stats.bytes / 1024 << " KiB, "
+            << double(stats.bytes * 8) / set.size() << " bits/key, "
+            << stats.probes << " probes, expected fp " << stats.expected_fp
+            << ", observed fp "
+            << double(stats.false_positives) /
+                   (stats.false_positives + stats.filtered)
+            << "\n";
+  return 0;
+}
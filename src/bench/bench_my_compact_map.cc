@@ -0,0 +1,78 @@
+#include <malloc.h>
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Heap bytes per entry, random inserts, lookups and in-order scans of
+// small int -> int entries: pointer trees against the index tree.
+
+static const int kCount = 200000;
+static const int kLookups = 2000000;
+
+size_t heap_in_use() { return mallinfo2().uordblks; }
+
+template <typename Map, typename Lookup, typename Scan>
+void run(const char *name, const std::vector<int> &keys, Lookup lookup,
+         Scan scan) {
+  size_t before = heap_in_use();
+  Map *map = new Map;
+  double insert_rate = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) (*map)[keys[i]] = i;
+  });
+  double bytes = double(heap_in_use() - before) / kCount;
+  long found = 0;
+  double lookup_rate = rate(kLookups, [&] {
+    for (int i = 0; i < kLookups; i++)
+      found += lookup(*map, keys[(i * 7) % kCount]);
+  });
+  double scan_rate = rate(10 * kCount, [&] {
+    for (int pass = 0; pass < 10; pass++) found += scan(*map);
+  });
+  std::cout << name << bytes << " bytes/entry  " << insert_rate
+            << " insert  " << lookup_rate << " lookup  " << scan_rate
+            << " scan  Mops/s  (" << found << ")\n";
+  delete map;
+}
+
+int main() {
+  std::vector<int> keys(kCount);
+  uint64_t state = 88172645463325252ull;
+  for (auto &key : keys) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    key = int(state >> 33);
+  }
+  std::cout << kCount << " int -> int entries\n";
+  run<my::map<int, int>>(
+      "my::map          ", keys,
+      [](my::map<int, int> &m, int key) { return m.contains(key); },
+      [](my::map<int, int> &m) {
+        long sum = 0;
+        auto it = m.begin();
+        for (size_t i = 0; i < m.size(); i++, ++it) sum += it.cget() & 1;
+        return sum;
+      });
+  run<std::map<int, int>>(
+      "std::map         ", keys,
+      [](std::map<int, int> &m, int key) { return m.count(key); },
+      [](std::map<int, int> &m) {
+        long sum = 0;
+        for (const auto &item : m) sum += item.second & 1;
+        return sum;
+      });
+  run<my::compact_map<int, int>>(
+      "my::compact_map  ", keys,
+      [](my::compact_map<int, int> &m, int key) { return m.contains(key); },
+      [](my::compact_map<int, int> &m) {
+        long sum = 0;
+        for (auto item : m) sum += item.second & 1;
+        return sum;
+      });
+  return 0;
+}
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers.h"
+#include "bench_util.h"
+
+// In-order scans and random lookups on a my::map whose nodes were scattered
+// over the heap by insert/erase churn, before and after compact() in
+// in-order and van Emde Boas layout.
+
+static const int kCount = 300000;
+static const int kLookups = 2000000;
+
+void measure(const char *name, my::map<int, int> &m,
+             const std::vector<int> &probes) {
+  long sum = 0;
+  double scan = rate(5 * m.size(), [&] {
+    for (int pass = 0; pass < 5; pass++) {
+      auto it = m.begin();
+      for (size_t i = 0; i < m.size(); i++, ++it) sum += it.cget() & 1;
+    }
+  });
+  double lookup = rate(kLookups, [&] {
+    for (int i = 0; i < kLookups; i++)
+      sum += m.contains(probes[i % probes.size()]);
+  });
+  std::cout << name << "fragmentation " << m.fragmentation() << "  scan "
+            << scan << "  lookup " << lookup << " Mops/s  (" << sum << ")\n";
+}
+
+int main() {
+  uint64_t state = 88172645463325252ull;
+  auto next = [&state] {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return int(state >> 34);
+  };
+  my::map<int, int> m;
+  std::vector<int> probes;
+  for (int i = 0; i < kCount; i++) m[next()] = i;
+  for (int round = 0; round < 4; round++) {  // churn: half out, half in
+    auto it = m.begin();
+    std::vector<int> victims;
+    for (size_t i = 0; i < m.size(); i++, ++it)
+      if (next() & 1) victims.push_back(it.cget());
+    for (int key : victims) m.erase(key);
+    for (size_t i = 0; i < victims.size(); i++) m[next()] = round;
+  }
+  auto it = m.begin();
+  for (size_t i = 0; i < m.size(); i++, ++it) probes.push_back(it.cget());
+  for (size_t i = probes.size() - 1; i > 0; i--)
+    std::swap(probes[i], probes[next() % (i + 1)]);
+
+  std::cout << m.size() << " entries after churn\n";
+  measure("scattered      ", m, probes);
+  double took = rate(m.size(), [&] { m.compact(); });
+  measure("in-order       ", m, probes);
+  m.compact(my::compact_order::van_emde_boas);
+  measure("van Emde Boas  ", m, probes);
+  std::cout << "compact() " << took << " Mnodes/s\n";
+  return 0;
+}
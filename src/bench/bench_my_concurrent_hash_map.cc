@@ -0,0 +1,88 @@
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Session table workload, 80% lookups and 20% inserts or erases over a
+// shared key range: concurrent_hash_map against my::map and
+// my::unordered_map behind one mutex.
+
+static const int kPerThread = 100000;
+static const int kKeys = 50000;
+
+template <typename Body>
+double run(int threads, Body body) {
+  return rate(threads * kPerThread, [&] {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(body, t);
+    for (auto &th : pool) th.join();
+  });
+}
+
+template <typename Op>
+void workload(int t, Op op) {  // op(kind, key), kind 0 read, 1 add, 2 drop
+  uint64_t state = 0x9E3779B97F4A7C15ull * (t + 1);
+  for (int i = 0; i < kPerThread; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    int key = int(state % kKeys), dice = int((state >> 32) % 10);
+    op(dice < 8 ? 0 : dice == 8 ? 1 : 2, key);
+  }
+}
+
+int main() {
+  std::cout << "threads  concurrent Mops/s  mutex+map  mutex+unordered_map\n";
+  for (int threads : {1, 2, 4, 8}) {
+    my::concurrent_hash_map<int, int> chm;
+    for (int i = 0; i < kKeys; i += 2) chm.insert(i, i);
+    double chm_rate = run(threads, [&chm](int t) {
+      workload(t, [&chm](int kind, int key) {
+        if (kind == 0)
+          chm.contains(key);
+        else if (kind == 1)
+          chm.insert(key, key);
+        else
+          chm.erase(key);
+      });
+    });
+
+    std::mutex map_lock;
+    my::map<int, int> map;
+    for (int i = 0; i < kKeys; i += 2) map[i] = i;
+    double map_rate = run(threads, [&](int t) {
+      workload(t, [&](int kind, int key) {
+        std::lock_guard<std::mutex> lock(map_lock);
+        if (kind == 0)
+          map.contains(key);
+        else if (kind == 1 && !map.contains(key))
+          map[key] = key;
+        else if (kind == 2)
+          map.erase(key);
+      });
+    });
+
+    std::mutex hash_lock;
+    my::unordered_map<int, int> hash;
+    for (int i = 0; i < kKeys; i += 2) hash[i] = i;
+    double hash_rate = run(threads, [&](int t) {
+      workload(t, [&](int kind, int key) {
+        std::lock_guard<std::mutex> lock(hash_lock);
+        if (kind == 0)
+          hash.contains(key);
+        else if (kind == 1)
+          hash.insert(key, key);
+        else
+          hash.erase(key);
+      });
+    });
+
+    std::cout << threads << "        " << chm_rate << "            "
+              << map_rate << "     " << hash_rate << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Scaling of concurrent inserts followed by lookups: lock-free skip list
+// against a my::map guarded by one mutex.
+
+static const int kPerThread = 20000;
+
+template <typename Body>
+double run(int threads, Body body) {
+  return rate(threads * kPerThread * 2, [&] {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) pool.emplace_back(body, t, threads);
+    for (auto &th : pool) th.join();
+  });
+}
+
+int main() {
+  std::cout << "threads  skiplist Mops/s  mutex+map Mops/s\n";
+  for (int threads : {1, 2, 4, 8}) {
+    my::concurrent_skiplist_map<int, int> sl;
+    double sl_rate = run(threads, [&sl](int t, int n) {
+      for (int i = 0; i < kPerThread; i++) sl.insert(i * n + t, i);
+      for (int i = 0; i < kPerThread; i++) sl.contains(i * n + t);
+    });
+
+    my::map<int, int> m;
+    std::mutex mutex;
+    double map_rate = run(threads, [&m, &mutex](int t, int n) {
+      for (int i = 0; i < kPerThread; i++) {
+        std::lock_guard<std::mutex> lock(mutex);
+        m[i * n + t] = i;
+      }
+      for (int i = 0; i < kPerThread; i++) {
+        std::lock_guard<std::mutex> lock(mutex);
+        m.contains(i * n + t);
+      }
+    });
+    std::cout << threads << "        " << sl_rate << "            "
+              << map_rate << "\n";
+  }
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+            << "\n";
+  return 0;
+}
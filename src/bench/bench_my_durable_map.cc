@@ -0,0 +1,44 @@
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Throughput of durable_map writers on the local disk: fsync per operation
+// against group commit, where concurrent writers share one fsync.
+
+using durable = my::durable_map<int, int>;
+
+static void run(const char *name, durable::sync_policy policy, int threads) {
+  const int kPerThread = 400;
+  auto dir = std::filesystem::temp_directory_path() / "bench_my_durable_map";
+  std::filesystem::remove_all(dir);
+  durable::options opts;
+  opts.sync = policy;
+  opts.checkpoint_every = 0;
+  durable m(dir.string(), opts);
+  double took = seconds([&] {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++)
+      pool.emplace_back([&m, t] {
+        for (int i = 0; i < kPerThread; i++)
+          m.insert_or_assign(t * kPerThread + i, i);
+      });
+    for (auto &th : pool) th.join();
+  });
+  durable::stats st = m.get_stats();
+  std::cout << name << "  threads " << threads << ": " << st.logged / took
+            << " ops/s, " << st.syncs
+            << " fsyncs for " << st.logged << " ops\n";
+  std::filesystem::remove_all(dir);
+}
+
+int main() {
+  for (int threads : {1, 4, 16}) {
+    run("sync per op ", durable::sync_policy::every_op, threads);
+    run("group commit", durable::sync_policy::group, threads);
+  }
+  return 0;
+}
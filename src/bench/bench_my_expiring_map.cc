@@ -0,0 +1,57 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Session table: writes to random session ids out of 1M, each session
+// expires 60 s after its last write, the clock moves 1 ms every 10 writes.
+// The baseline keeps deadlines in a my::map and sweeps all of it once per
+// simulated second.
+
+static const int kSessions = 1000000;
+static const int kWrites = 4000000;
+static const my::ticks kTtl = 60000;
+
+int main() {
+  std::vector<int> ids(kWrites);
+  uint64_t state = 88172645463325252ull;
+  for (int &id : ids) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    id = int(state % kSessions);
+  }
+
+  my::manual_clock clock;
+  my::expiring_map<int, int> wheel(kTtl, clock.source());
+  double wheel_rate = rate(kWrites, [&] {
+    for (int i = 0; i < kWrites; i++) {
+      if (i % 10 == 0) clock.advance(1);
+      wheel.put(ids[i], i);
+    }
+  });
+  std::cout << "timer wheel  " << wheel_rate << " M writes/s, " << wheel.size()
+            << " live, " << wheel.reaped() << " expired\n";
+
+  my::map<int, my::ticks> deadlines;  // value is the deadline
+  my::ticks now = 0;
+  size_t expired = 0;
+  std::vector<int> due;
+  double sweep_rate = rate(kWrites, [&] {
+    for (int i = 0; i < kWrites; i++) {
+      if (i % 10 == 0 && ++now % 1000 == 0) {  // sweep every second
+        due.clear();
+        auto it = deadlines.begin();
+        for (size_t k = 0; k < deadlines.size(); k++, ++it)
+          if (it.current_node->value2 <= now) due.push_back(it.cget());
+        for (int id : due) deadlines.erase(id);
+        expired += due.size();
+      }
+      deadlines.insert_or_assign(ids[i], now + kTtl);
+    }
+  });
+  std::cout << "map + sweep  " << sweep_rate << " M writes/s, "
+            << deadlines.size() << " live, " << expired << " expired\n";
+  return 0;
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Lookups in int -> int maps of 100, 1k and 10k entries: the flat map
+// against the pointer tree and the index tree, then building the flat
+// map with one insert per key against insert_many batches of eight.
+// Millions of operations per second.
+
+static const int kLookups = 4000000;
+
+std::vector<int> random_keys(int count) {
+  std::vector<int> keys(count);
+  uint64_t state = 88172645463325252ull;
+  for (auto &key : keys) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    key = int(state >> 33);
+  }
+  return keys;
+}
+
+template <typename Map>
+double lookups(const Map &map, const std::vector<int> &keys, long &found) {
+  int n = int(keys.size());
+  return kLookups / seconds([&] {
+           for (int i = 0; i < kLookups; i++)
+             found += map.contains(keys[(i * 7) % n] + (i & 1));
+         }) / 1e6;
+}
+
+int main() {
+  long found = 0;
+  for (int count : {100, 1000, 10000}) {
+    std::vector<int> keys = random_keys(count);
+    my::flat_map<int, int> flat;
+    my::map<int, int> tree;
+    my::compact_map<int, int> compact;
+    for (int i = 0; i < count; i++) {
+      flat.insert(keys[i], i);
+      tree.insert(keys[i], i);
+      compact.insert(keys[i], i);
+    }
+    std::cout << count << " entries  lookup  flat "
+              << lookups(flat, keys, found) << "  map "
+              << lookups(tree, keys, found) << "  compact "
+              << lookups(compact, keys, found) << " Mops/s\n";
+
+    const int kRounds = 1000000 / count;
+    double one = seconds([&] {
+      for (int r = 0; r < kRounds; r++) {
+        my::flat_map<int, int> built;
+        for (int i = 0; i < count; i++) built.insert(keys[i], i);
+        found += built.size();
+      }
+    });
+    double batched = seconds([&] {
+      for (int r = 0; r < kRounds; r++) {
+        my::flat_map<int, int> built;
+        for (int i = 0; i + 8 <= count; i += 8) {
+          const int *k = &keys[i];
+          built.insert_many(std::make_pair(k[0], i), std::make_pair(k[1], i),
+                            std::make_pair(k[2], i), std::make_pair(k[3], i),
+                            std::make_pair(k[4], i), std::make_pair(k[5], i),
+                            std::make_pair(k[6], i), std::make_pair(k[7], i));
+        }
+        found += built.size();
+      }
+    });
+    double ops = double(kRounds) * count / 1e6;
+    std::cout << count << " entries  build  insert " << ops / one
+              << "  insert_many " << ops / batched << " Mops/s\n";
+  }
+  std::cout << "(" << found << ")\n";
+
+  return 0;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Inserts and lookups of random integer keys: tree map against the Swiss
+// table unordered_map and std::unordered_map.
+
+static const int kCount = 100000;
+static const int kLookups = 2000000;
+
+template <typename Map, typename Contains>
+void run(const char *name, const std::vector<int> &keys, Contains contains) {
+  Map map;
+  double insert_rate = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) map[keys[i]] = i;
+  });
+  long found = 0;
+  double lookup_rate = rate(kLookups, [&] {
+    for (int i = 0; i < kLookups; i++)
+      found += contains(map, keys[(i * 7) % (2 * kCount)]);
+  });
+  std::cout << name << insert_rate << " Mops/s insert  " << lookup_rate
+            << " Mops/s lookup  (" << found << " hits)\n";
+}
+
+int main() {
+  std::vector<int> keys(2 * kCount);  // second half misses
+  uint64_t state = 88172645463325252ull;
+  for (auto &key : keys) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    key = int(state >> 33);
+  }
+  std::cout << kCount << " keys, " << kLookups << " lookups, half hits\n";
+  run<my::map<int, int>>("my::map             ", keys,
+                         [](my::map<int, int> &m, int key) {
+                           return m.contains(key);
+                         });
+  run<my::unordered_map<int, int>>(
+      "my::unordered_map   ", keys,
+      [](my::unordered_map<int, int> &m, int key) { return m.contains(key); });
+  run<std::unordered_map<int, int>>(
+      "std::unordered_map  ", keys,
+      [](std::unordered_map<int, int> &m, int key) { return m.count(key); });
+  return 0;
+}
@@ -0,0 +1,47 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// map::at on 1M keys under Zipf key streams, with the hot key cache off
+// and on at a few sizes. A splay tree, which also favours hot keys, is the
+// other baseline.
+
+static const int kKeys = 1000000;
+static const int kLookups = 5000000;
+
+template <typename Map>
+double lookups(Map &m, const std::vector<int> &stream, long &sum) {
+  return rate(kLookups, [&] {
+    for (int key : stream) sum += m.at(key);
+  });
+}
+
+int main() {
+  std::vector<int> keys(kKeys), values(kKeys);
+  for (int i = 0; i < kKeys; i++) keys[i] = values[i] = i;
+  my::map<int, int> m;
+  my::map<int, int, std::less<int>, my::splay_balance> splay;
+  for (int i = 0; i < kKeys; i++) {  // scattered, as after a random load
+    int key = int((uint32_t(i) * 2654435761u) % uint32_t(kKeys));
+    m.insert(key, key);
+    splay.insert(key, key);
+  }
+
+  for (double s : {0.8, 0.99, 1.2}) {
+    std::vector<int> stream = zipf_stream(kKeys, kLookups, s);
+    long sum = 0;
+    m.disable_hot_cache();
+    std::cout << "zipf " << s << "  off " << lookups(m, stream, sum);
+    for (size_t slots : {1024, 16384}) {
+      m.enable_hot_cache(slots);
+      double on = lookups(m, stream, sum);
+      std::cout << "  " << slots << " slots " << on << " ("
+                << 100 * m.get_hot_cache_stats().hit_rate() << "% hits)";
+    }
+    std::cout << "  splay " << lookups(splay, stream, sum) << " M lookups/s  ("
+              << sum << ")\n";
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Overlap queries on time intervals: interval_map against a scan of a
+// my::map<start, end>, and the cost of keeping max_end on inserts.
+
+static const int kCount = 100000;
+static const int kScanQueries = 200;
+static const int kQueries = 200000;
+
+int main() {
+  uint64_t state = 88172645463325252ull;
+  auto next = [&state](int range) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return int((state >> 33) % range);
+  };
+  std::vector<int> starts(kCount), ends(kCount), points(kQueries);
+  for (int i = 0; i < kCount; i++) {  // mostly short, a few long ones
+    starts[i] = next(100000000);
+    ends[i] = starts[i] + (i % 100 ? next(2000) : next(1000000));
+  }
+  for (auto &point : points) point = next(100000000);
+
+  my::map<int, int> plain;
+  my::interval_map<int> intervals;
+  double plain_insert = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) plain[starts[i]] = ends[i];
+  });
+  double interval_insert = rate(kCount, [&] {
+    for (int i = 0; i < kCount; i++) intervals.insert(starts[i], ends[i]);
+  });
+
+  long hits = 0;
+  double scan = rate(kScanQueries, [&] {
+    for (int q = 0; q < kScanQueries; q++) {
+      auto it = plain.begin();
+      for (size_t i = 0; i < plain.size(); i++, ++it)
+        hits += it.cget() <= points[q] && plain.at(it.cget()) >= points[q];
+    }
+  });
+  double point = rate(kQueries, [&] {
+    for (int q = 0; q < kQueries; q++)
+      hits += intervals.overlapping(points[q]).size();
+  });
+  double range = rate(kQueries, [&] {
+    for (int q = 0; q < kQueries; q++)
+      hits += intervals.overlapping(points[q], points[q] + 5000).size();
+  });
+  double any = rate(kQueries, [&] {
+    for (int q = 0; q < kQueries; q++)
+      hits += intervals.overlaps(points[q], points[q] + 5000);
+  });
+
+  std::cout << kCount << " intervals, Mops/s  (" << hits << ")\n"
+            << "insert    my::map " << plain_insert << "  interval_map "
+            << interval_insert << "\n"
+            << "point     map scan " << scan << "  overlapping(p) " << point
+            << "\n"
+            << "range     overlapping(lo, hi) " << range
+            << "  overlaps(lo, hi) " << any << "\n";
+  return 0;
+}
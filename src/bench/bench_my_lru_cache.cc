@@ -0,0 +1,73 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Read-through cache under a Zipf(0.99) key stream over 1M keys: get, and
+// put on a miss. lru_cache and lfu_cache against the usual hand-rolled
+// LRU, a my::map from key to a my::list position with erase + push_front
+// on every hit.
+
+static const int kKeys = 1000000;
+static const int kOps = 2000000;
+
+class naive_lru {
+ public:
+  explicit naive_lru(size_t capacity) : limit(capacity) {}
+  const int *get(int key) {
+    if (!index.contains(key)) return nullptr;
+    position &pos = index.at(key);
+    int value = (*pos).second;
+    order.erase(pos);
+    order.push_front({key, value});
+    pos = order.begin();
+    return &(*order.begin()).second;
+  }
+  void put(int key, int value) {
+    if (order.size() == limit) {
+      auto last = --order.end();
+      index.erase((*last).first);
+      order.erase(last);
+    }
+    order.push_front({key, value});
+    index.insert(key, order.begin());
+  }
+
+ private:
+  using position = my::list<std::pair<int, int>>::iterator;
+  size_t limit;
+  my::list<std::pair<int, int>> order;
+  my::map<int, position> index;
+};
+
+template <typename Cache>
+double run(Cache &cache, const std::vector<int> &stream, size_t &hits) {
+  return rate(kOps, [&] {
+    for (int key : stream) {
+      if (cache.get(key))
+        ++hits;
+      else
+        cache.put(key, key);
+    }
+  });
+}
+
+int main() {
+  std::vector<int> stream = zipf_stream(kKeys, kOps, 0.99);
+  for (size_t capacity : {1000, 10000, 100000}) {
+    size_t lru_hits = 0, lfu_hits = 0, naive_hits = 0;
+    my::lru_cache<int, int> lru(capacity);
+    my::lfu_cache<int, int> lfu(capacity);
+    naive_lru naive(capacity);
+    double lru_rate = run(lru, stream, lru_hits);
+    double lfu_rate = run(lfu, stream, lfu_hits);
+    double naive_rate = run(naive, stream, naive_hits);
+    std::cout << "capacity " << capacity << "  lru " << lru_rate << " ("
+              << 100.0 * lru_hits / kOps << "% hits)  lfu " << lfu_rate
+              << " (" << 100.0 * lfu_hits / kOps << "% hits)  map + list "
+              << naive_rate << " (" << 100.0 * naive_hits / kOps
+              << "% hits) M ops/s\n";
+  }
+  return 0;
+}
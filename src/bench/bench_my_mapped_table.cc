@@ -0,0 +1,40 @@
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <sstream>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Startup cost of read only reference data: binary deserialize into my::map
+// against opening the same data as a mapped_table, for growing sizes.
+
+int main() {
+  const char *path = "/tmp/bench_my_mapped_table.tbl";
+  std::cout << "entries    deserialize ms   open table ms   1k finds ms\n";
+  for (long count : {10000l, 100000l, 1000000l}) {
+    std::stringstream stream;  // sorted dump, built without n inserts
+    my::vector<long> data(count);
+    for (long i = 0; i < count; i++) data[i] = i * 2;
+    my::serial::write_header<long, long>(stream, my::serial::kMap, count);
+    my::serial::write_block(stream, data.data(), count);
+    my::serial::write_block(stream, data.data(), count);
+
+    my::map<long, long> m;
+    double load_ms = seconds([&] { m.deserialize(stream); }) * 1e3;
+    my::write_table(m, path);
+
+    std::optional<my::mapped_table<long, long>> table;
+    double open_ms = seconds([&] { table.emplace(path); }) * 1e3;
+
+    long sum = 0;
+    double find_ms = seconds([&] {
+      for (long i = 0; i < 1000; i++) sum += table->at((i * 7919 % count) * 2);
+    }) * 1e3;
+    std::cout << count << "      " << load_ms << "          " << open_ms
+              << "          " << find_ms << (sum < 0 ? " " : "") << "\n";
+  }
+  std::remove(path);
+  return 0;
+}
@@ -0,0 +1,39 @@
+#include <iostream>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Merge of two equal sized containers through the sorted rebuild against
+// the key by key path it replaces.
+
+int main() {
+  const int kCount = 20000;
+  my::map<int, int> left, right;
+  my::multiset<int> left_ms, right_ms;
+  for (int i = 0; i < kCount; i++) {
+    left[(i * 7919) % (2 * kCount)] = i;  // odd keys overlap
+    right[(i * 104729) % (2 * kCount) | 1] = -i;
+    left_ms.insert(i % 5000);
+    right_ms.insert(i % 7000);
+  }
+
+  my::map<int, int> by_key(left);
+  double by_key_time = seconds([&] {
+    auto it = right.begin();
+    for (size_t i = 0; i < right.size(); i++, ++it)
+      by_key[it.cget()] = right.at(it.cget());
+  });
+
+  my::map<int, int> merged(left);
+  double merge_time = seconds([&] { merged.merge(right); });
+  double multiset_time = seconds([&] { left_ms.merge(right_ms); });
+
+  std::cout << "merge of two maps with " << kCount << " entries\n"
+            << "key by key operator[]: " << by_key_time * 1e3 << " ms\n"
+            << "map::merge:            " << merge_time * 1e3
+            << " ms (" << merged.size() << " entries)\n"
+            << "multiset::merge:       " << multiset_time * 1e3
+            << " ms (" << left_ms.size() << " entries)\n";
+  return merged.size() == by_key.size() ? 0 : 1;
+}
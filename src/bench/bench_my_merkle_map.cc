@@ -0,0 +1,59 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Finding d differing keys between two replicas of 200k entries: diff()
+// on two merkle_maps, diff() against a digest, and the full walk of both
+// maps that shipping dumps amounts to.
+
+static const int kCount = 200000;
+
+int main() {
+  uint64_t state = 88172645463325252ull;
+  auto next = [&state] {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return int(state >> 34);
+  };
+  my::merkle_map<int, int> base;
+  for (int i = 0; i < kCount; i++) base.insert_or_assign(next(), i);
+  std::cout << base.size() << " entries, times in ms\n";
+
+  for (int d : {1, 10, 100, 1000}) {
+    my::merkle_map<int, int> replica = base;
+    for (int i = 0; i < d; i++) replica.insert_or_assign(next(), -i);
+    long found = 0;
+    double merkle = 1e3 * seconds([&] {
+      base.diff(replica, [&found](int, my::merkle_change) { found++; });
+    });
+    my::merkle_digest<int> digest = replica.digest();
+    double against_digest = 1e3 * seconds([&] {
+      base.diff(digest, [&found](int, my::merkle_change) { found++; });
+    });
+    double walk = 1e3 * seconds([&] {
+      std::vector<std::pair<int, int>> mine, theirs;
+      base.for_each([&mine](int k, int v) { mine.push_back({k, v}); });
+      replica.for_each([&theirs](int k, int v) { theirs.push_back({k, v}); });
+      size_t i = 0, j = 0;
+      while (i < mine.size() && j < theirs.size()) {
+        if (mine[i] == theirs[j]) {
+          i++;
+          j++;
+        } else {
+          found++;
+          mine[i].first <= theirs[j].first ? i++ : j++;
+        }
+      }
+    });
+    std::stringstream stream;
+    digest.write(stream);
+    std::cout << "d = " << d << "  diff " << merkle << "  digest diff "
+              << against_digest << "  full walk " << walk << "  digest "
+              << stream.str().size() / 1024 << " KiB  (" << found << ")\n";
+  }
+  return 0;
+}
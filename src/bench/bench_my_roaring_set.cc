@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Two id sets of 1M values each over a 2M range, one every other id and
+// one a mix of long runs and random ids, as a set tree and roaring_set:
+// memory, build time and the intersection and union of the two. The tree
+// side is the bitree under my::set, driven directly since set::insert
+// also walks to the position of the returned iterator; it intersects by
+// walking one set and asking the other, and unions by inserting one into
+// a copy of the other. Tree memory is nodes times the size of a node.
+
+static const uint32_t kRange = 2000000;
+
+struct tree_node {  // the layout of a bitree node of a set<uint32_t>
+  uint32_t key;
+  uint32_t value;
+  void *parent, *left, *right;
+  int rank;
+  bool packed;
+};
+
+struct tree_set {
+  my::bitree<uint32_t, uint32_t> tree;
+  void insert(uint32_t v) {
+    if (!tree.contains(v)) tree << std::make_pair(v, v);
+  }
+};
+
+template <typename Set>
+void fill(Set &a, Set &b) {
+  for (uint32_t v = 0; v < kRange; v += 2) a.insert(v);
+  uint64_t state = 88172645463325252ull;
+  for (uint32_t start = 0; start < kRange; start += 4000)
+    for (uint32_t v = start; v < start + 1500; v++) b.insert(v);
+  for (int i = 0; i < 250000; i++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    b.insert(uint32_t(state % kRange));
+  }
+}
+
+int main() {
+  tree_set ta, tb;
+  double tree_build = seconds([&] { fill(ta, tb); });
+  size_t tree_and = 0, tree_or = 0;
+  double tree_and_time = seconds([&] {
+    tree_set both;
+    auto it = ta.tree.begin();
+    for (size_t i = 0; i < ta.tree.get_size(); i++, ++it)
+      if (tb.tree.contains(it.cget())) both.insert(it.cget());
+    tree_and = both.tree.get_size();
+  });
+  double tree_or_time = seconds([&] {
+    tree_set either = ta;
+    auto it = tb.tree.begin();
+    for (size_t i = 0; i < tb.tree.get_size(); i++, ++it)
+      either.insert(it.cget());
+    tree_or = either.tree.get_size();
+  });
+  std::cout << "set tree     "
+            << (ta.tree.get_size() + tb.tree.get_size()) * sizeof(tree_node) /
+                   1024
+            << " KiB, build " << tree_build << " s, and " << tree_and << " in "
+            << tree_and_time << " s, or " << tree_or << " in " << tree_or_time
+            << " s\n";
+
+  for (bool optimize : {false, true}) {
+    my::roaring_set ra, rb;
+    double build = seconds([&] { fill(ra, rb); });
+    if (optimize) build += seconds([&] {
+        ra.run_optimize();
+        rb.run_optimize();
+      });
+    const int kRounds = 100;
+    size_t both = 0, either = 0;
+    double and_time = seconds([&] {
+      for (int i = 0; i < kRounds; i++) both = (ra & rb).size();
+    }) / kRounds;
+    double or_time = seconds([&] {
+      for (int i = 0; i < kRounds; i++) either = (ra | rb).size();
+    }) / kRounds;
+    std::cout << (optimize ? "roaring runs " : "roaring      ")
+              << (ra.memory_usage() + rb.memory_usage()) / 1024
+              << " KiB, build " << build << " s, and " << both << " in "
+              << and_time << " s, or " << either << " in " << or_time
+              << " s\n";
+  }
+  return 0;
+}
@@ -0,0 +1,35 @@
+#include <iostream>
+#include <sstream>
+
+#include "../my_containers.h"
+#include "bench_util.h"
+
+// Reload of a map dumped as text and rebuilt through operator[] against the
+// binary serialize/deserialize pair.
+
+int main() {
+  const int kCount = 200000;
+  my::map<int, double> source;
+  for (int i = 0; i < kCount; i++) source[(i * 7919) % kCount] = i * 0.5;
+
+  std::stringstream text;
+  for (auto it = source.begin(); it.position < source.size(); ++it)
+    text << it.cget() << ' ' << source.at(it.cget()) << '\n';
+  my::map<int, double> from_text;
+  double text_time = seconds([&] {
+    int key;
+    double value;
+    while (text >> key >> value) from_text[key] = value;
+  });
+
+  std::stringstream binary;
+  source.serialize(binary);
+  my::map<int, double> from_binary;
+  double binary_time = seconds([&] { from_binary.deserialize(binary); });
+
+  std::cout << "reload of " << kCount << " entries\n"
+            << "text + operator[]:   " << text_time * 1e3 << " ms\n"
+            << "binary deserialize:  " << binary_time * 1e3
+            << " ms\n";
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Accuracy against memory: a skewed stream of 2M ints over 1M keys. The
+// distinct count comes from a my::set and from hyperloglog at several
+// error targets; counts of the 100 heaviest keys from a my::multiset and
+// from count_min_sketch at several widths. Tree memory is nodes times the
+// size of a node.
+
+static const int kItems = 2000000;
+static const int kKeys = 1000000;
+
+int scatter(int rank) { return int((uint32_t(rank) * 2654435761u) % kKeys); }
+
+template <typename T2>
+struct tree_node {  // the layout of a bitree node
+  int key;
+  T2 value;
+  void *parent, *left, *right;
+  int rank;
+  bool packed;
+};
+
+int main() {
+  std::vector<int> stream(kItems);
+  uint64_t state = 88172645463325252ull;
+  for (int &key : stream) {  // rank ~ kKeys * u^4, rank 0 the heaviest
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    double u = double(state >> 11) / double(1ull << 53);
+    key = scatter(int(kKeys * u * u * u * u));
+  }
+
+  my::set<int> distinct;
+  double set_time = seconds([&] {
+    for (int key : stream) distinct.insert(key);
+  });
+  double truth = double(distinct.size());
+  std::cout << "set            " << truth << " distinct, "
+            << distinct.size() * sizeof(tree_node<int>) / 1024 << " KiB, "
+            << set_time << " s\n";
+  for (double error : {0.05, 0.02, 0.01, 0.005}) {
+    my::hyperloglog<int> hll(error);
+    double took = seconds([&] {
+      for (int key : stream) hll.insert(key);
+    });
+    double estimate = hll.estimate();
+    std::cout << "hyperloglog " << error << "  " << estimate << " ("
+              << 100 * std::fabs(estimate - truth) / truth << "% off), "
+              << hll.bytes() / 1024.0 << " KiB, " << took << " s\n";
+  }
+
+  my::multiset<int> counts;
+  double multiset_time = seconds([&] {
+    for (int key : stream) counts.add(key);
+  });
+  std::vector<double> heavy(100);
+  for (int rank = 0; rank < 100; rank++)
+    heavy[rank] = double(counts.count(scatter(rank)));
+  std::cout << "multiset       " << counts.size() << " items, "
+            << counts.size() * sizeof(tree_node<size_t>) / 1024 << " KiB, "
+            << multiset_time << " s\n";
+  for (double epsilon : {0.001, 0.0001, 0.00001}) {
+    my::count_min_sketch<int> cms(epsilon, 0.01);
+    double took = seconds([&] {
+      for (int key : stream) cms.insert(key);
+    });
+    double worst = 0, mean = 0;
+    for (int rank = 0; rank < 100; rank++) {
+      double off = (cms.estimate(scatter(rank)) - heavy[rank]) / heavy[rank];
+      worst = std::max(worst, off);
+      mean += off / 100;
+    }
+    std::cout << "count-min " << epsilon << "  top 100 mean "
+              << 100 * mean << "% max " << 100 * worst << "% over, "
+              << cms.bytes() / 1024 << " KiB, " << took << " s\n";
+  }
+  return 0;
+}
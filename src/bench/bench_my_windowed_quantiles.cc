@@ -0,0 +1,63 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "../my_containers_plus.h"
+#include "bench_util.h"
+
+// Latency monitoring: every sample is pushed into a sliding window and the
+// median and p99 are read after each push. The target is 1M samples/s.
+// The baseline is a plain multiset with an iterator walk to the median.
+
+static const int kSamples = 2000000;
+
+int main() {
+  std::vector<double> samples(kSamples);
+  uint64_t state = 88172645463325252ull;
+  for (auto &sample : samples) {  // log-normal-ish latencies in ms
+    double sum = 0;
+    for (int i = 0; i < 4; i++) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      sum += double(state >> 11) / double(1ull << 53);
+    }
+    sample = std::exp(sum - 2);
+  }
+
+  for (size_t window : {1000, 10000, 100000}) {
+    my::windowed_quantiles<double> w(window);
+    double seen = 0;
+    double push_only = rate(kSamples, [&] {
+      for (double sample : samples) w.push(sample);
+    });
+    w.clear();
+    double with_reads = rate(kSamples, [&] {
+      for (double sample : samples) {
+        w.push(sample);
+        seen += w.median() + w.quantile(0.99);
+      }
+    });
+    std::cout << "window " << window << "  push " << push_only
+              << "  push + p50 + p99 " << with_reads << " M samples/s  ("
+              << seen << ")\n";
+  }
+
+  const int kNaive = 20000;  // window 1000, walk to the median per sample
+  my::multiset<double> naive;
+  std::vector<double> ring(1000);
+  double seen = 0;
+  double walk = rate(kNaive, [&] {
+    for (int i = 0; i < kNaive; i++) {
+      if (i >= 1000) naive.erase(ring[i % 1000]);
+      ring[i % 1000] = samples[i];
+      naive.insert(samples[i]);
+      auto it = naive.begin();
+      for (size_t k = 0; k < naive.size() / 2; k++) ++it;
+      seen += it.cget();
+    }
+  });
+  std::cout << "window 1000, multiset walk  " << walk << " M samples/s  ("
+            << seen << ")\n";
+  return 0;
+}
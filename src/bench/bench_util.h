@@ -0,0 +1,58 @@
+#ifndef CONTAINERS_SRC_BENCH_BENCH_UTIL_H_
+#define CONTAINERS_SRC_BENCH_BENCH_UTIL_H_
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Timing and key stream helpers shared by the benchmarks.
+
+template <typename Body>
+double seconds(Body body) {
+  auto start = std::chrono::steady_clock::now();
+  body();
+  std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+  return took.count();
+}
+
+template <typename Body>
+double rate(int ops, Body body) {  // Mops/s
+  return ops / seconds(body) / 1e6;
+}
+
+// ops key ranks in [0, keys), rank k drawn with weight 1 / (k + 1)^s.
+inline std::vector<int> zipf_ranks(int keys, int ops, double s) {
+  std::vector<double> cdf(keys);
+  double sum = 0;
+  for (int k = 0; k < keys; k++) cdf[k] = sum += 1 / std::pow(k + 1, s);
+  std::vector<int> out(ops);
+  uint64_t state = 88172645463325252ull;
+  for (int &rank : out) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    double u = double(state >> 11) / double(1ull << 53) * sum;
+    int lo = 0, hi = keys - 1;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (cdf[mid] < u)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    rank = lo;
+  }
+  return out;
+}
+
+// zipf_ranks with the ranks scattered over [0, keys), so hot keys are not
+// neighbours.
+inline std::vector<int> zipf_stream(int keys, int ops, double s) {
+  std::vector<int> out = zipf_ranks(keys, ops, s);
+  for (int &key : out)
+    key = int((uint32_t(key) * 2654435761u) % uint32_t(keys));
+  return out;
+}
+
+#endif  // CONTAINERS_SRC_BENCH_BENCH_UTIL_H_
@@ -0,0 +1,287 @@
+#ifndef CONTAINERS_SRC_BITREE_MY_BALANCE_H
+#define CONTAINERS_SRC_BITREE_MY_BALANCE_H
+
+#include <algorithm>
+
+#define RED 1
+#define BLACK 0
+
+namespace my {
+
+// Balancing policies of bitree. The tree does the plain binary search tree
+// work and calls the policy around it:
+//   init(nd)                        a new node, before it is linked
+//   after_insert(tree, nd)          nd was linked in as a leaf
+//   after_erase(tree, x, parent, r) a node with rank r was unlinked, x
+//                                   (maybe nullptr) took its place below
+//                                   parent
+//   accessed(tree, nd)              a lookup that may change the tree found nd
+//   built(nd, depth, red_depth)     build_sorted made nd, children are done
+// Each node has an int rank that belongs to the policy. Policies restructure
+// through tree.lr / tree.rr and read tree.root.
+
+struct rb_balance {  // red-black, the default; rank is the color
+  template <typename Node>
+  static void init(Node *nd) {
+    nd->rank = RED;
+  }
+  template <typename Tree, typename Node>
+  static void after_insert(Tree &tree, Node *nd);
+  template <typename Tree, typename Node>
+  static void after_erase(Tree &tree, Node *x, Node *parent, int removed) {
+    if (removed == BLACK) del_balance(tree, x, parent);
+  }
+  template <typename Tree, typename Node>
+  static void accessed(Tree &, Node *) {}
+  template <typename Node>
+  static void built(Node *nd, int depth, int red_depth) {
+    // nodes below the complete levels are red, so every path keeps the
+    // same number of black nodes
+    nd->rank = depth == red_depth ? RED : BLACK;
+  }
+
+ private:
+  template <typename Node>
+  static int color_of(const Node *nd) {  // nullptr leaves are black
+    return nd ? nd->rank : BLACK;
+  }
+  template <typename Node>
+  static void rc(Node *nd) {  // It is used to restore the "red node has
+                              // black children" property.
+    nd->left->rank = BLACK;
+    nd->right->rank = BLACK;
+    nd->rank = RED;
+  }
+  template <typename Tree, typename Node>
+  static void del_balance(Tree &tree, Node *nd, Node *parent);
+};
+
+// AVL: subtree heights differ by at most one, so the tree is at most about
+// 1.44 log2(n) deep against 2 log2(n) for red-black. Lookups touch fewer
+// nodes; updates rotate a little more often. rank is the subtree height.
+struct avl_balance {
+  template <typename Node>
+  static void init(Node *nd) {
+    nd->rank = 1;
+  }
+  template <typename Tree, typename Node>
+  static void after_insert(Tree &tree, Node *nd) {
+    rebalance(tree, nd->parent);
+  }
+  template <typename Tree, typename Node>
+  static void after_erase(Tree &tree, Node *, Node *parent, int) {
+    rebalance(tree, parent);
+  }
+  template <typename Tree, typename Node>
+  static void accessed(Tree &, Node *) {}
+  template <typename Node>
+  static void built(Node *nd, int, int) {
+    update(nd);
+  }
+
+ private:
+  template <typename Node>
+  static int height(const Node *nd) {
+    return nd ? nd->rank : 0;
+  }
+  template <typename Node>
+  static void update(Node *nd) {
+    nd->rank = 1 + std::max(height(nd->left), height(nd->right));
+  }
+  template <typename Tree, typename Node>
+  static void rebalance(Tree &tree, Node *nd);  // from nd up to the root
+};
+
+// Splay: every insert and every lookup through a non-const path (map::at,
+// operator[], find_value) rotates the node to the root, so hot keys stay
+// near the top under skewed access. Depth is only amortized O(log n).
+// Const lookups (contains) leave the tree as it is, they may run on shared
+// or concurrently read trees.
+struct splay_balance {
+  template <typename Node>
+  static void init(Node *nd) {
+    nd->rank = 0;
+  }
+  template <typename Tree, typename Node>
+  static void after_insert(Tree &tree, Node *nd) {
+    splay(tree, nd);
+  }
+  template <typename Tree, typename Node>
+  static void after_erase(Tree &tree, Node *, Node *parent, int) {
+    if (parent) splay(tree, parent);
+  }
+  template <typename Tree, typename Node>
+  static void accessed(Tree &tree, Node *nd) {
+    splay(tree, nd);
+  }
+  template <typename Node>
+  static void built(Node *, int, int) {}
+
+ private:
+  template <typename Tree, typename Node>
+  static void rotate_up(Tree &tree, Node *nd) {
+    if (nd == nd->parent->left)
+      tree.rr(nd->parent);
+    else
+      tree.lr(nd->parent);
+  }
+  template <typename Tree, typename Node>
+  static void splay(Tree &tree, Node *nd);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Tree, typename Node>
+void rb_balance::after_insert(Tree &tree, Node *nd) {
+  while (nd != tree.root && nd->parent->rank == RED) {
+    if (nd->parent ==
+        nd->parent->parent
+            ->left) {  // If the parent of the node is the left child
+      Node *uncle = nd->parent->parent->right;
+      if (uncle && uncle->rank == RED) {  // If "uncle" exists and red
+        rc(nd->parent->parent);
+        nd = nd->parent->parent;
+      } else {
+        if (nd == nd->parent->right) {
+          nd = nd->parent;
+          tree.lr(nd);
+        }
+        nd->parent->rank = BLACK;  // If the "uncle" is black
+        nd->parent->parent->rank = RED;
+        tree.rr(nd->parent->parent);
+      }
+    } else {  // If the parent of the node is the right child
+      Node *uncle = nd->parent->parent->left;
+      if (uncle && uncle->rank == RED) {
+        rc(nd->parent->parent);
+        nd = nd->parent->parent;
+      } else {
+        if (nd == nd->parent->left) {
+          nd = nd->parent;
+          tree.rr(nd);
+        }
+        nd->parent->rank = BLACK;
+        nd->parent->parent->rank = RED;
+        tree.lr(nd->parent->parent);
+      }
+    }
+  }
+  tree.root->rank = BLACK;
+}
+
+template <typename Tree, typename Node>
+void rb_balance::del_balance(Tree &tree, Node *nd, Node *parent) {
+  // nd carries an extra black; it may be nullptr, so its parent is passed
+  while (nd != tree.root && color_of(nd) == BLACK) {
+    if (nd == parent->left) {  // If nd is the left child of its parent
+      Node *brother = parent->right;
+      if (brother->rank == RED) {  // Case 1: Brother Red
+        brother->rank = BLACK;
+        parent->rank = RED;
+        tree.lr(parent);
+        brother = parent->right;
+      }
+      if (color_of(brother->left) == BLACK &&
+          color_of(brother->right) ==
+              BLACK) {  // Case 2: The brother has both children black
+        brother->rank = RED;
+        nd = parent;
+        parent = nd->parent;
+      } else {
+        if (color_of(brother->right) ==
+            BLACK) {  // Case 3: The brother's right child is black, and the
+                      // left one is red
+          brother->left->rank = BLACK;
+          brother->rank = RED;
+          tree.rr(brother);
+          brother = parent->right;
+        }
+        brother->rank =
+            parent->rank;  // Case 4: The brother's right child is red
+        parent->rank = BLACK;
+        brother->right->rank = BLACK;
+        tree.lr(parent);
+        nd = tree.root;
+      }
+    } else {  // If nd is the right child, the logic is symmetric as described
+              // above ("left" and "right" are replaced)
+      Node *brother = parent->left;
+      if (brother->rank == RED) {
+        brother->rank = BLACK;
+        parent->rank = RED;
+        tree.rr(parent);
+        brother = parent->left;
+      }
+      if (color_of(brother->right) == BLACK &&
+          color_of(brother->left) == BLACK) {
+        brother->rank = RED;
+        nd = parent;
+        parent = nd->parent;
+      } else {
+        if (color_of(brother->left) == BLACK) {
+          brother->right->rank = BLACK;
+          brother->rank = RED;
+          tree.lr(brother);
+          brother = parent->left;
+        }
+        brother->rank = parent->rank;
+        parent->rank = BLACK;
+        brother->left->rank = BLACK;
+        tree.rr(parent);
+        nd = tree.root;
+      }
+    }
+  }
+  if (nd) nd->rank = BLACK;  // Completing the balancing: the nd node is
+                             // repainted black to restore the properties
+}
+
+template <typename Tree, typename Node>
+void avl_balance::rebalance(Tree &tree, Node *nd) {
+  for (; nd != nullptr; nd = nd->parent) {
+    update(nd);
+    int skew = height(nd->left) - height(nd->right);
+    if (skew > 1) {  // left heavy, a left-right case turns into left-left
+      Node *left = nd->left;
+      if (height(left->left) < height(left->right)) {
+        tree.lr(left);
+        update(left);
+        update(left->parent);
+      }
+      tree.rr(nd);
+      update(nd);
+      nd = nd->parent;
+      update(nd);
+    } else if (skew < -1) {
+      Node *right = nd->right;
+      if (height(right->right) < height(right->left)) {
+        tree.rr(right);
+        update(right);
+        update(right->parent);
+      }
+      tree.lr(nd);
+      update(nd);
+      nd = nd->parent;
+      update(nd);
+    }
+  }
+}
+
+template <typename Tree, typename Node>
+void splay_balance::splay(Tree &tree, Node *nd) {
+  while (nd->parent) {
+    Node *parent = nd->parent, *grand = parent->parent;
+    if (!grand) {  // zig
+      rotate_up(tree, nd);
+    } else if ((nd == parent->left) == (parent == grand->left)) {  // zig-zig
+      rotate_up(tree, parent);
+      rotate_up(tree, nd);
+    } else {  // zig-zag
+      rotate_up(tree, nd);
+      rotate_up(tree, nd);
+    }
+  }
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_BITREE_MY_BALANCE_H
@@ -1,14 +1,47 @@
 #ifndef CONTAINERS_SRC_BITREE_MY_BITREE_H
 #define CONTAINERS_SRC_BITREE_MY_BITREE_H
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-#define RED 1
-#define BLACK 0
+#include "my_balance.h"
+#include "my_hot_cache.h"
 
 namespace my {
 
-template <typename T, typename T2>
+enum class compact_order {  // node layout made by bitree::compact
+  in_order,       // successors next to each other, for scans
+  van_emde_boas,  // recursive top/bottom blocks, for lookups
+};
+
+// Summaries of whole subtrees kept in the nodes, like the largest end point
+// of an interval tree. update(nd) recomputes the summary of nd from nd and
+// its children; the tree calls it bottom up wherever a subtree changes:
+// rotations, the path of an insert or an erase, bulk builds.
+struct no_augment {
+  template <typename Node>
+  static void update(Node *) {}
+};
+
+struct subtree_size {  // value2 counts the nodes of the subtree
+  template <typename Node>
+  static void update(Node *nd) {
+    nd->value2 = 1 + (nd->left ? nd->left->value2 : 0) +
+                 (nd->right ? nd->right->value2 : 0);
+  }
+};
+
+template <typename T, typename T2, typename Compare = std::less<T>,
+          typename Balance = rb_balance, typename Augment = no_augment>
 class bitree {
  private:
   typedef struct node {
@@ -17,35 +50,112 @@ class bitree {
     node *parent;  // pointer to node parent node
     node *left;    // pointer to node's left node
     node *right;   // pointer to node's right node
-    int color;     // node color RED | BLACK
+    int rank;      // data of the balancing policy: RB color, AVL height
+    bool packed = false;  // lives in a compaction chunk, not from new
   } node;
 
-  node *root;  // pointer to Red-Black-Tree's root node
+  // Compaction moves nodes into chunks of kChunkBytes aligned to their own
+  // size, so a node finds its chunk by masking its address. A chunk is
+  // freed when its last node goes; the tree filling it holds one extra
+  // count until it moves on.
+  struct chunk {
+    std::atomic<size_t> live;  // nodes in use, plus the filler's hold
+  };
+  static constexpr size_t kSlotsStart =
+      (sizeof(chunk) + alignof(node) - 1) / alignof(node) * alignof(node);
+  static constexpr size_t chunk_bytes(size_t bytes) {  // a power of two,
+    return bytes >= kSlotsStart + 16 * sizeof(node)    // 16 nodes at least
+               ? bytes
+               : chunk_bytes(bytes * 2);
+  }
+  static constexpr size_t kChunkBytes = chunk_bytes(64 * 1024);
+  static constexpr size_t kChunkSlots =
+      (kChunkBytes - kSlotsStart) / sizeof(node);
+
+  // Mutable iterators hold a count here, and so does the tree until
+  // clear(), so the block goes with whichever lets go last.
+  struct iterator_count {
+    std::atomic<long> refs;
+  };
+
+  node *root;    // pointer to the tree's root node
+  Compare comp;  // strict weak order of the keys
+  mutable std::atomic<std::atomic<long> *>
+      shared;  // owners of root when copies share it, nullptr if unique
+  iterator_count *iterators = nullptr;  // nullptr before the first one
+  chunk *filling = nullptr;  // chunk that compaction places nodes in
+  size_t filled = 0;         // slots of filling already used
+  node *compact_next = nullptr;  // next node of an incremental pass
+  std::unique_ptr<hot_cache<T, node>> hot;  // nullptr unless enabled
+  static constexpr bool kHashable =
+      std::is_default_constructible<std::hash<T>>::value;
 
-  int add_balance(node *);  //  tree balance after add new node
-  int del_balance(node *);  //  tree balance after delete node
-  int lr(node *);           //  left rotate of tree
-  int rr(node *);           //  right rotate of tree
-  int rc(node *);           //  recolor of node's
+  friend Balance;                   // rebalances through lr, rr and root
+  int lr(node *);                   //  left rotate of tree
+  int rr(node *);                   //  right rotate of tree
+  void transplant(node *, node *);  // put second subtree in place of first
+  void update_path(node *);         // Augment::update from nd to the root
 
-  int add(std::pair<const T, T2>);         // add new node
-  int del(const T);                        // del node by key
-  node *copy_nodes(const node *src_node);  // rec node coping
-  void clear_rec(node *);                  // rec del of RBT
+  int add(const std::pair<const T, T2> &);  // add new node
+  int del(const T &);                       // del node by key
+  node *copy_nodes(const node *src_node);  // node coping
+  void clear_rec(node *);                  // del of all nodes
+  void detach();   // own a private copy of the nodes before a change
+  void release();  // drop this tree's hold on root
+  void share(const bitree &other);  // take root of other without coping
+  template <typename K>
+  const node *find_node(const K &) const;  // nullptr if key is missing
+  node *lookup(const T &);  // find_node through the hot cache
+  node *build_rec(const T *, const T2 *, size_t, size_t, int,
+                  int);  // rec build of sorted range
+  void free_node(node *);            // delete or give back to its chunk
+  void stop_filling();               // drop the hold on the filled chunk
+  node *relocate(node *);            // move a node to the next chunk slot
+  static node *successor(node *);    // next node in order, or nullptr
+  void veb_order(node *, int, std::vector<node *> &);  // vEB layout
+  bool iterators_out() const {
+    return iterators && iterators->refs.load() > 1;
+  }
+  void drop_iterators();  // let go of the count, old iterators are dead
 
  public:
   // constructors and destructors
-  bitree() {  // base constructor for class
+  explicit bitree(const Compare &order = Compare())
+      : comp(order), shared(nullptr) {  // base constructor for class
     root = nullptr;
     tree_size = 0;
   }
 
-  bitree(const bitree &other) {  // copy condtructor
-    root = copy_nodes(other.get_root());
-    tree_size = other.get_size();
+  bitree(const bitree &other)
+      : comp(other.comp), shared(nullptr) {  // copy condtructor, the
+                                             // nodes are shared until
+                                             // one side changes them
+    share(other);
+    if (other.hot) hot.reset(new hot_cache<T, node>(other.hot->slots()));
+  }
+
+  bitree(bitree &&other) noexcept
+      : root(other.root),
+        comp(other.comp),
+        shared(other.shared.load()),
+        iterators(other.iterators),
+        filling(other.filling),
+        filled(other.filled),
+        compact_next(other.compact_next),
+        hot(std::move(other.hot)),
+        tree_size(other.tree_size) {  // move constructor, steals root
+    other.root = nullptr;
+    other.shared = nullptr;
+    other.iterators = nullptr;
+    other.filling = nullptr;
+    other.compact_next = nullptr;
+    other.tree_size = 0;
   }
 
-  ~bitree() { clear(); }
+  ~bitree() {
+    clear();
+    stop_filling();
+  }
 
   bitree &operator<<(const std::pair<T, T2> &value) {  // operator <<
     if (!add(value)) {
@@ -79,11 +189,34 @@ class bitree {
     return *this;
   }
 
-  bitree &operator=(bitree &&other) noexcept {  // operator = by coping RBT
+  bitree &operator=(bitree &&other) noexcept {  // operator = by moving RBT
     if (this != &other) {
       clear();
-      root = copy_nodes(other.get_root());
+      root = other.root;
+      comp = other.comp;
+      shared = other.shared.load();
+      iterators = other.iterators;
+      std::swap(filling, other.filling);
+      std::swap(filled, other.filled);
+      compact_next = other.compact_next;
+      hot = std::move(other.hot);
       tree_size = other.tree_size;
+      other.root = nullptr;
+      other.shared = nullptr;
+      other.iterators = nullptr;
+      other.compact_next = nullptr;
+      other.tree_size = 0;
+    }
+    return *this;
+  }
+
+  bitree &operator=(const bitree &other) {  // operator = by sharing RBT
+    if (this != &other) {
+      clear();
+      comp = other.comp;
+      share(other);
+      hot.reset(other.hot ? new hot_cache<T, node>(other.hot->slots())
+                          : nullptr);
     }
     return *this;
   }
@@ -91,10 +224,19 @@ class bitree {
   //------------------ITERATOR------------------// Class to iterate in tree
   class tree_iterator {
    private:
-    typename bitree<T, T2>::node *root_node;
+    typename bitree<T, T2, Compare, Balance, Augment>::node *const
+        *root_node;   // the tree's root field, followed when nodes move
+    Compare comp;     // order of the tree, for set()
     int next_node();  // next node
     int back_node();  // prev node
     size_t *max_position;
+    iterator_count *live = nullptr;  // the tree's count of its iterators
+    friend class bitree;
+
+    void drop() {
+      if (live && live->refs.fetch_sub(1) == 1) delete live;
+      live = nullptr;
+    }
 
    public:
     tree_iterator() {};
@@ -104,7 +246,13 @@ class bitree {
             &other) {  // copy current_node and postion from another iterator
       current_node = other.current_node;
       position = other.position;
+      root_node = other.root_node;
+      max_position = other.max_position;
+      comp = other.comp;
+      live = other.live;
+      if (live) ++live->refs;
     };
+    ~tree_iterator() { drop(); }
     size_t position = 0;  //  current iterator position in tree
     int first_node();     //  set iterator to min tree node
     int last_node();      //  set iterator to max tree node
@@ -113,21 +261,25 @@ class bitree {
     }  // get node key for read
     T &get() { return current_node->value; }  // get node key for right
 
-    tree_iterator set(const T);  //  set iterator to node
+    template <typename K>
+    tree_iterator set(const K &);  //  set iterator to node
 
-    int initialize(
-        typename bitree<T, T2>::node *tree_root,
-        size_t *tree_size) {  // init iterator with tree_root and size
-                              // if iter pos 0 set it to min node
+    int initialize(typename bitree<T, T2, Compare, Balance, Augment>::node
+                       *const *tree_root,
+                   size_t *tree_size,
+                   const Compare &order =
+                       Compare()) {  // init iterator with tree_root and size
+                                     // if iter pos 0 set it to min node
       root_node = tree_root;
       max_position = tree_size;
+      comp = order;
       if (position == 0) {
         first_node();
       }
       return 0;
     }
 
-    typename bitree<T, T2>::node
+    typename bitree<T, T2, Compare, Balance, Augment>::node
         *current_node;  //  pointer to iterator current node pos
 
     tree_iterator &operator++() {  //  move iterator to next node
@@ -143,11 +295,15 @@ class bitree {
     }
 
     tree_iterator &operator=(
-        tree_iterator &other) {  // copy one node in another by iterator
+        const tree_iterator &other) {  // copy one node in another by iterator
+      if (other.live) ++other.live->refs;
+      drop();
+      this->live = other.live;
       this->position = other.position;
       this->current_node = other.current_node;
       this->root_node = other.root_node;
       this->max_position = other.max_position;
+      this->comp = other.comp;
       return *this;
     }
 
@@ -173,25 +329,91 @@ class bitree {
   void move(const bitree &other);  //  move one tree to another
   size_t get_size() const;         // get tree size
 
-  T2 &find_value(T);  // return node by key
+  T2 &find_value(const T &);  // return node by key
+  const T2 &find_value(const T &) const;  // same without unsharing nodes
+  bool contains(const T &value) const { return find_node(value) != nullptr; }
+  // lookups by any type the comparator orders against T, when it is
+  // transparent (has is_transparent, like std::less<>); no T is built
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  T2 &find_value(const K &);
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const T2 &find_value(const K &) const;
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K &value) const {
+    return find_node(value) != nullptr;
+  }
+  Compare key_comp() const { return comp; }
 
+  // Optional cache of recently found nodes asked before the descent of
+  // find_value, for skewed lookups; see hot_cache. Only the non-const
+  // find_value goes through it, const lookups may run on shared trees.
+  // Keys are hashed with std::hash, which only agrees with operator<.
+  void enable_hot_cache(size_t slots = 1024) {
+    static_assert(kHashable, "The hot cache hashes keys with std::hash");
+    static_assert(std::is_same<Compare, std::less<T>>::value ||
+                      std::is_same<Compare, std::less<>>::value,
+                  "The hot cache needs keys ordered by operator<");
+    hot.reset(new hot_cache<T, node>(slots));
+  }
+  void disable_hot_cache() { hot.reset(); }
+  hot_cache_stats get_hot_cache_stats() const {
+    return hot ? hot->stats() : hot_cache_stats();
+  }
+
+  void build_sorted(const T *keys, const T2 *values,
+                    size_t count);  // O(n) rebuild from sorted keys,
+                                    // values may be null for T2()
+  template <typename F>
+  void in_order(F f) const;  // call f(key, value) in sorted order
+
+  // Relocate every node into fresh contiguous chunks in the given order.
+  // Keys and values are moved, not copied; iterators and references to
+  // elements are invalidated.
+  void compact(compact_order order = compact_order::in_order);
+  // Relocate up to budget nodes of an in-order pass that goes on from the
+  // last call; true once the pass is through. Changes in between are fine.
+  // Only iterators on the moved nodes are invalidated.
+  bool compact_step(size_t budget);
+  // Share of in-order neighbours that are not next to each other in
+  // memory: near 0 right after an in-order compaction (only the chunk
+  // boundaries count), near 1 when the nodes are scattered.
+  double fragmentation() const;
+
+  // Copies share nodes until one side writes. A mutable iterator could
+  // write through shared nodes or outlive them, so making one detaches
+  // first, and while any is alive copies of the tree take their own nodes.
+  // Once the iterators are gone copies share again.
   tree_iterator begin();  //  return iterator to start of tree
   tree_iterator end();    //   return iterator to end of tree
+  // Iterator on the key of the given rank, or on key; end() past the last
+  // rank or for a missing key. O(log n) with subtree_size, else the rank is
+  // counted in order.
+  tree_iterator iterator_at(size_t position);
+  template <typename K>
+  tree_iterator iterator_to(const K &key);
+
+ private:
+  tree_iterator new_iterator();  // detached, counted, not placed yet
 };  // class bitree
 
 //------------------FUNCTIONS------------------//
 //------------------ADD/DEL------------------//
-template <typename T, typename T2>
-int bitree<T, T2>::add(
-    std::pair<const T, T2>
-        value) {  // add new node to tree and make balance if nes
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::add(
+    const std::pair<const T, T2>
+        &value) {  // add new node to tree and make balance if nes
+  detach();
   node *current, *parent, *new_node;
   current = root;
   parent = nullptr;
 
   while (current != nullptr) {
     parent = current;
-    current = value.first < current->value
+    current = comp(value.first, current->value)
                   ? current->left
                   : current->right;  // find place to new node, goes to right or
                                      // left branch
@@ -202,172 +424,90 @@ int bitree<T, T2>::add(
   new_node->parent = parent;
   new_node->left = nullptr;
   new_node->right = nullptr;
-  new_node->color = RED;
+  Balance::init(new_node);
 
   if (parent) {  //  Binding a new node to a tree
-    if (value.first < parent->value)
+    if (comp(value.first, parent->value))
       parent->left = new_node;
     else
       parent->right = new_node;
   } else {
     root = new_node;
   }
-  add_balance(new_node);  // make balance to make from bintree RBT
+  update_path(new_node);
+  Balance::after_insert(*this, new_node);  // restore the tree's shape
   return 0;
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::del(const T value) {
-  node *x = nullptr;
-  node *y, *z = root;
-  while (z != nullptr)
-    if (value == z->value)
-      break;
-    else
-      z = value < z->value ? z->left : z->right;
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::del(
+    const T &value) {  // unlink node, nodes keep identity
+  if (shared.load() != nullptr) {  // the nodes are copied, look up after
+    if (!find_node(value)) return 1;
+    detach();
+  }
+  node *z = const_cast<node *>(find_node(value));
+  if (!z) return 1;
 
-  if (!z || z == nullptr) return 1;
+  node *x, *x_parent;  // node that takes the removed place and its parent
+  int removed_rank = z->rank;
   if (z->left == nullptr || z->right == nullptr) {
-    y = z;
-  } else {
-    y = z->right;
+    x = z->left ? z->left : z->right;
+    x_parent = z->parent;
+    transplant(z, x);
+  } else {  // two children: successor y takes the place of z
+    node *y = z->right;
     while (y->left != nullptr) y = y->left;
-  }
-  if (y->right != nullptr) {
+    removed_rank = y->rank;
     x = y->right;
-    x->parent = y->parent;
-  }
-  if (x && y->parent)
-    if (y == y->parent->left)
-      y->parent->left = x;
-    else
-      y->parent->right = x;
-  else
-    root = x;
-  if (y != z) z->value = y->value;
-  if (y->color == BLACK) del_balance(x);
-  if (y->parent && y->parent->right == y) y->parent->right = nullptr;
-  if (y->parent && y->parent->left == y) y->parent->left = nullptr;
-  delete (y);
-  return 0;
-}
-
-//------------------BALANCE------------------//
-template <typename T, typename T2>
-int bitree<T, T2>::add_balance(node *nd) {
-  while (nd != root && nd->parent->color == RED) {
-    if (nd->parent ==
-        nd->parent->parent
-            ->left) {  // If the parent of the node is the left child
-      node *uncle = nd->parent->parent->right;
-      if (uncle && uncle->color == RED) {  // If "uncle" exists and red
-        rc(nd->parent->parent);
-        nd = nd->parent->parent;
-      } else {
-        if (nd == nd->parent->right) {
-          nd = nd->parent;
-          lr(nd);
-        }
-        nd->parent->color = BLACK;  // If the "uncle" is black
-        nd->parent->parent->color = RED;
-        rr(nd->parent->parent);
-      }
-    } else {  // If the parent of the node is the right child
-      node *uncle = nd->parent->parent->left;
-      if (uncle && uncle->color == RED) {
-        rc(nd->parent->parent);
-        nd = nd->parent->parent;
-      } else {
-        if (nd == nd->parent->left) {
-          nd = nd->parent;
-          rr(nd);
-        }
-        nd->parent->color = BLACK;
-        nd->parent->parent->color = RED;
-        lr(nd->parent->parent);
-      }
+    if (y->parent == z) {
+      x_parent = y;
+    } else {
+      x_parent = y->parent;
+      transplant(y, y->right);
+      y->right = z->right;
+      y->right->parent = y;
     }
+    transplant(z, y);
+    y->left = z->left;
+    y->left->parent = y;
+    y->rank = z->rank;
+  }
+  if (z == compact_next) compact_next = successor(z);
+  if constexpr (kHashable) {
+    if (hot) hot->forget(z->value, z);
   }
-  root->color = BLACK;
+  free_node(z);
+  update_path(x_parent);
+  Balance::after_erase(*this, x, x_parent, removed_rank);
   return 0;
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::del_balance(node *nd) {
-  while (nd != root && nd->color == BLACK) {
-    if (nd == nd->parent->left) {  // If nd is the left child of its parent
-      node *brother = nd->parent->right;
-      if (brother->color == RED) {  // Case 1: Brother Red
-        brother->color = BLACK;
-        nd->parent->color = RED;
-        lr(nd->parent);
-        brother = nd->parent->right;
-      }
-      if (brother->left->color == BLACK &&
-          brother->right->color ==
-              BLACK) {  // Case 2: The brother has both children black
-        brother->color = RED;
-        nd = nd->parent;
-      } else {
-        if (brother->right->color ==
-            BLACK) {  // Case 3: The brother's right child is black, and the
-                      // left one is red
-          brother->left->color = BLACK;
-          brother->color = RED;
-          rr(brother);
-          brother = nd->parent->right;
-        }
-        brother->color =
-            nd->parent->color;  // Case 4: The brother's right child is red
-        nd->parent->color = BLACK;
-        brother->right->color = BLACK;
-        lr(nd->parent);
-        nd = root;
-      }
-    } else {  // If nd is the right child, the logic is symmetric as described
-              // above ("left" and "right" are replaced)
-      node *brother = nd->parent->left;
-      if (brother->color == RED) {
-        brother->color = BLACK;
-        nd->parent->color = RED;
-        rr(nd->parent);
-        brother = nd->parent->left;
-      }
-      if (brother->right->color == BLACK && brother->left->color == BLACK) {
-        brother->color = RED;
-        nd = nd->parent;
-      } else {
-        if (brother->left->color == BLACK) {
-          brother->right->color = BLACK;
-          brother->color = RED;
-          lr(brother);
-          brother = nd->parent->left;
-        }
-        brother->color = nd->parent->color;
-        nd->parent->color = BLACK;
-        brother->left->color = BLACK;
-        rr(nd->parent);
-        nd = root;
-      }
-    }
-  }
-  nd->color = BLACK;  // Completing the balancing: the nd node is repainted
-                      // black to restore the properties of the tree.
-  return 0;
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::transplant(node *old_node,
+                                                          node *new_node) {
+  if (old_node->parent == nullptr)
+    root = new_node;
+  else if (old_node == old_node->parent->left)
+    old_node->parent->left = new_node;
+  else
+    old_node->parent->right = new_node;
+  if (new_node) new_node->parent = old_node->parent;
 }
 
-//------------------TREE_MOVE------------------//
-template <typename T, typename T2>
-int bitree<T, T2>::rc(node *nd) {  // It is used to restore the "red node has
-                                   // black children" property.
-  nd->left->color = BLACK;
-  nd->right->color = BLACK;
-  nd->color = RED;
-  return 0;
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::update_path(node *nd) {
+  if constexpr (!std::is_same<Augment, no_augment>::value)
+    for (; nd != nullptr; nd = nd->parent) Augment::update(nd);
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::lr(node *nd) {  // left rotation
+//------------------TREE_MOVE------------------//
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::lr(node *nd) {  // left rotation
   node *pNode = nd;
   node *cNode = nd->right;
   if (!cNode) return 1;
@@ -384,11 +524,14 @@ int bitree<T, T2>::lr(node *nd) {  // left rotation
   }
   cNode->left = pNode;
   if (pNode != nullptr) pNode->parent = cNode;
+  Augment::update(pNode);  // the lower one first
+  Augment::update(cNode);
   return 0;
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::rr(node *nd) {  // right rotation
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::rr(node *nd) {  // right rotation
   node *pNode = nd;
   node *cNode = nd->left;
   if (!cNode) return 1;
@@ -405,124 +548,576 @@ int bitree<T, T2>::rr(node *nd) {  // right rotation
   }
   cNode->right = pNode;
   if (pNode != nullptr) pNode->parent = cNode;
+  Augment::update(pNode);
+  Augment::update(cNode);
   return 0;
 }
 //------------------HELP_FUNCS------------------//
-template <typename T, typename T2>
-void bitree<T, T2>::clear_rec(node *tmp) {  // Deleting nodes recursively
-  if (tmp != nullptr && tree_size != 0) {
-    node *left = tmp->left;
-    node *right = tmp->right;
-    delete tmp;
-    --tree_size;
-    clear_rec(left);
-    clear_rec(right);
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::clear_rec(
+    node *tmp) {  // Deleting nodes without recursion, a splay tree can be
+                  // as deep as it is big: left children are rotated up
+                  // until a node has none and can go
+  while (tmp != nullptr) {
+    if (tmp->left != nullptr) {
+      node *left = tmp->left;
+      tmp->left = left->right;
+      left->right = tmp;
+      tmp = left;
+    } else {
+      node *right = tmp->right;
+      free_node(tmp);
+      tmp = right;
+    }
   }
 }
 
-template <typename T, typename T2>
-void bitree<T, T2>::clear() {  // del tree
-  clear_rec(root);
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::clear() {  // del tree
+  if (hot && root) hot->flush();
+  release();
   tree_size = 0;
   root = nullptr;
+  drop_iterators();  // no iterator survives
+  compact_next = nullptr;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::drop_iterators() {
+  if (iterators && iterators->refs.fetch_sub(1) == 1) delete iterators;
+  iterators = nullptr;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::release() {  // the last owner
+                                                            // frees the nodes
+  std::atomic<long> *owners = shared.load();
+  if (owners == nullptr) {
+    clear_rec(root);
+  } else if (owners->fetch_sub(1) == 1) {
+    clear_rec(root);
+    delete owners;
+  }
+  shared = nullptr;
 }
 
-template <typename T, typename T2>
-const typename bitree<T, T2>::node *bitree<T, T2>::get_root()
-    const {  // return tree root
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::share(const bitree &other) {
+  tree_size = other.tree_size;
+  if (other.iterators_out()) {  // other's iterators keep pointing at its own
+    root = copy_nodes(other.root);
+    return;
+  }
+  std::atomic<long> *owners = other.shared.load();
+  if (owners == nullptr) {  // first copy, give other's root a counter
+    std::atomic<long> *fresh = new std::atomic<long>(1);
+    if (other.shared.compare_exchange_strong(owners, fresh))
+      owners = fresh;
+    else
+      delete fresh;
+  }
+  owners->fetch_add(1);
+  shared = owners;
+  root = other.root;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::detach() {
+  std::atomic<long> *owners = shared.load();
+  if (owners == nullptr) return;
+  if (owners->load() == 1) {  // the other copies are gone, reuse the nodes
+    delete owners;
+    shared = nullptr;
+    return;
+  }
+  node *copy = copy_nodes(root);
+  compact_next = nullptr;  // the pass was on the shared nodes
+  if (hot) hot->flush();   // and so were the cached nodes
+  if (owners->fetch_sub(1) == 1) {  // they left while we were coping
+    clear_rec(root);
+    delete owners;
+  }
+  root = copy;
+  shared = nullptr;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+const typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::get_root() const {  // the root node
   return root;
 }
 
-template <typename T, typename T2>
-T2 &bitree<T, T2>::find_value(T value) {
-  node *iter = root;
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+T2 &bitree<T, T2, Compare, Balance, Augment>::find_value(const T &value) {
+  detach();
+  node *found = lookup(value);
+  if (!found) throw std::out_of_range("Key not found");
+  Balance::accessed(*this, found);
+  return found->value2;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+const T2 &bitree<T, T2, Compare, Balance, Augment>::find_value(
+    const T &value) const {
+  const node *found = find_node(value);
+  if (!found) throw std::out_of_range("Key not found");
+  return found->value2;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+template <typename K, typename C, typename>
+T2 &bitree<T, T2, Compare, Balance, Augment>::find_value(const K &value) {
+  detach();
+  node *found = const_cast<node *>(find_node(value));
+  if (!found) throw std::out_of_range("Key not found");
+  Balance::accessed(*this, found);
+  return found->value2;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+template <typename K, typename C, typename>
+const T2 &bitree<T, T2, Compare, Balance, Augment>::find_value(
+    const K &value) const {
+  const node *found = find_node(value);
+  if (!found) throw std::out_of_range("Key not found");
+  return found->value2;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+template <typename K>
+const typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::find_node(
+    const K &value) const {  // equal keys are neither less nor greater
+  const node *iter = root;
   while (iter != nullptr) {
-    if (value == iter->value) {
-      return iter->value2;
-    } else {
-      iter = value < iter->value ? iter->left : iter->right;
+    if (comp(value, iter->value))
+      iter = iter->left;
+    else if (comp(iter->value, value))
+      iter = iter->right;
+    else
+      break;
+  }
+  return iter;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::lookup(const T &value) {
+  if constexpr (kHashable) {
+    if (hot) {
+      node *nd = hot->find(value, [this](const T &key, const node *n) {
+        return !comp(key, n->value) && !comp(n->value, key);
+      });
+      if (nd) return nd;
+      nd = const_cast<node *>(find_node(value));
+      if (nd) hot->remember(nd->value, nd);  // forget() hashes it too
+      return nd;
     }
   }
-  throw std::out_of_range("Key not found");
+  return const_cast<node *>(find_node(value));
 }
 
-template <typename T, typename T2>
-void bitree<T, T2>::move(const bitree &other) {
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::move(const bitree &other) {
   root = other.get_root();
   tree_size = other.get_size();
   other.set_root(nullptr);
 }
 
-template <typename T, typename T2>
-size_t bitree<T, T2>::get_size() const {
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+size_t bitree<T, T2, Compare, Balance, Augment>::get_size() const {
   return tree_size;
 }
 
-template <typename T, typename T2>
-typename bitree<T, T2>::node *bitree<T, T2>::copy_nodes(
-    const typename bitree<T, T2>::node *src_node) {
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::copy_nodes(const node *src_node) {
   if (!src_node) {
     return nullptr;
   }
-  typename bitree<T, T2>::node *new_node = new node;
-  new_node->value = src_node->value;
-  new_node->value2 = src_node->value2;
-  new_node->parent = nullptr;
-  new_node->left = nullptr;
-  new_node->right = nullptr;
-  new_node->color = src_node->color;
+  auto clone = [](const node *from, node *parent) {
+    node *new_node = new node;
+    new_node->value = from->value;
+    new_node->value2 = from->value2;
+    new_node->parent = parent;
+    new_node->left = nullptr;
+    new_node->right = nullptr;
+    new_node->rank = from->rank;
+    return new_node;
+  };
+  node *copy = clone(src_node, nullptr);
+  const node *from = src_node;  // walk both trees in step, by parent
+  node *to = copy;              // pointers instead of recursion
+  while (true) {
+    if (from->left && !to->left) {
+      to->left = clone(from->left, to);
+      from = from->left;
+      to = to->left;
+    } else if (from->right && !to->right) {
+      to->right = clone(from->right, to);
+      from = from->right;
+      to = to->right;
+    } else if (from != src_node) {
+      from = from->parent;
+      to = to->parent;
+    } else {
+      return copy;
+    }
+  }
+}
 
-  new_node->left = copy_nodes(src_node->left);
-  new_node->right = copy_nodes(src_node->right);
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::build_sorted(const T *keys,
+                                                            const T2 *values,
+                                                            size_t count) {
+  clear();
+  int full_levels = 0;  // levels that are complete in a midpoint split tree
+  while ((size_t(2) << full_levels) - 1 <= count) ++full_levels;
+  root = build_rec(keys, values, 0, count, 0, full_levels);
+  tree_size = count;
+}
 
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::build_rec(
+    const T *keys, const T2 *values, size_t first, size_t last, int depth,
+    int red_depth) {  // the policy sets the rank once the children exist
+  if (first >= last) return nullptr;
+  size_t middle = first + (last - first) / 2;
+  node *new_node = new node;
+  new_node->value = keys[middle];
+  new_node->value2 = values ? values[middle] : T2();
+  new_node->parent = nullptr;
+  new_node->left =
+      build_rec(keys, values, first, middle, depth + 1, red_depth);
+  new_node->right =
+      build_rec(keys, values, middle + 1, last, depth + 1, red_depth);
+  if (new_node->left) new_node->left->parent = new_node;
+  if (new_node->right) new_node->right->parent = new_node;
+  Augment::update(new_node);
+  Balance::built(new_node, depth, red_depth);
   return new_node;
 }
 
-template <typename T, typename T2>
-typename bitree<T, T2>::tree_iterator bitree<T, T2>::begin() {
-  tree_iterator iter;
-  iter.initialize(root, &tree_size);
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+template <typename F>
+void bitree<T, T2, Compare, Balance, Augment>::in_order(F f) const {
+  const node *nd = root;  // by parent pointers, the depth is not bounded
+  if (!nd) return;        // for every balancing policy
+  while (nd->left) nd = nd->left;
+  while (nd) {
+    f(nd->value, nd->value2);
+    if (nd->right) {
+      nd = nd->right;
+      while (nd->left) nd = nd->left;
+    } else {
+      while (nd->parent && nd == nd->parent->right) nd = nd->parent;
+      nd = nd->parent;
+    }
+  }
+}
+
+//------------------COMPACTION------------------//
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::free_node(node *nd) {
+  if (!nd->packed) {
+    delete nd;
+    return;
+  }
+  chunk *home = reinterpret_cast<chunk *>(reinterpret_cast<uintptr_t>(nd) &
+                                          ~uintptr_t(kChunkBytes - 1));
+  nd->~node();
+  if (home->live.fetch_sub(1) == 1) std::free(home);
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::stop_filling() {
+  if (filling && filling->live.fetch_sub(1) == 1) std::free(filling);
+  filling = nullptr;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::relocate(node *old) {
+  if (!filling || filled == kChunkSlots) {
+    stop_filling();
+    void *memory = std::aligned_alloc(kChunkBytes, kChunkBytes);
+    if (!memory) throw std::bad_alloc();
+    filling = new (memory) chunk{{1}};
+    filled = 0;
+  }
+  void *slot = reinterpret_cast<char *>(filling) + kSlotsStart +
+               filled++ * sizeof(node);
+  ++filling->live;
+  node *nd = new (slot) node{std::move(old->value),
+                             std::move(old->value2),
+                             old->parent,
+                             old->left,
+                             old->right,
+                             old->rank,
+                             true};
+  if (!nd->parent)  // the neighbours point at the new place
+    root = nd;
+  else if (nd->parent->left == old)
+    nd->parent->left = nd;
+  else
+    nd->parent->right = nd;
+  if (nd->left) nd->left->parent = nd;
+  if (nd->right) nd->right->parent = nd;
+  if constexpr (kHashable) {
+    if (hot) hot->moved(nd->value, old, nd);
+  }
+  free_node(old);
+  return nd;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::node *
+bitree<T, T2, Compare, Balance, Augment>::successor(node *nd) {
+  if (nd->right) {
+    nd = nd->right;
+    while (nd->left) nd = nd->left;
+    return nd;
+  }
+  while (nd->parent && nd == nd->parent->right) nd = nd->parent;
+  return nd->parent;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::veb_order(
+    node *nd, int height, std::vector<node *> &out) {
+  // the top half of the levels first, then each subtree hanging below it,
+  // so any root to leaf path crosses O(log n / log B) blocks of B nodes
+  if (!nd || height <= 0) return;
+  if (height == 1) {
+    out.push_back(nd);
+    return;
+  }
+  int top = height / 2;
+  veb_order(nd, top, out);
+  std::vector<std::pair<node *, int>> stack{{nd, 0}};
+  while (!stack.empty()) {  // the roots of the bottom part, left to right
+    auto [cur, depth] = stack.back();
+    stack.pop_back();
+    if (depth == top) {
+      veb_order(cur, height - top, out);
+      continue;
+    }
+    if (cur->right) stack.push_back({cur->right, depth + 1});
+    if (cur->left) stack.push_back({cur->left, depth + 1});
+  }
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+void bitree<T, T2, Compare, Balance, Augment>::compact(compact_order order) {
+  if (!root) return;
+  detach();
+  std::vector<node *> nodes;
+  nodes.reserve(tree_size);
+  if (order == compact_order::in_order) {
+    node *nd = root;
+    while (nd->left) nd = nd->left;
+    for (; nd; nd = successor(nd)) nodes.push_back(nd);
+  } else {
+    int height = 0;  // without recursion, splay trees can be deep
+    std::vector<std::pair<node *, int>> stack{{root, 1}};
+    while (!stack.empty()) {
+      auto [cur, depth] = stack.back();
+      stack.pop_back();
+      height = std::max(height, depth);
+      if (cur->left) stack.push_back({cur->left, depth + 1});
+      if (cur->right) stack.push_back({cur->right, depth + 1});
+    }
+    veb_order(root, height, nodes);
+  }
+  stop_filling();  // a fresh chunk, away from the nodes of older passes
+  for (node *nd : nodes) relocate(nd);
+  stop_filling();
+  compact_next = nullptr;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+bool bitree<T, T2, Compare, Balance, Augment>::compact_step(size_t budget) {
+  detach();
+  if (!root) return true;
+  if (!compact_next) {  // a new pass from the smallest key
+    stop_filling();
+    compact_next = root;
+    while (compact_next->left) compact_next = compact_next->left;
+  }
+  for (; budget > 0 && compact_next; budget--)
+    compact_next = successor(relocate(compact_next));
+  if (compact_next) return false;
+  stop_filling();
+  return true;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+double bitree<T, T2, Compare, Balance, Augment>::fragmentation() const {
+  if (tree_size < 2) return 0;
+  size_t apart = 0, steps = 0;
+  node *prev = nullptr;
+  node *nd = root;
+  while (nd->left) nd = nd->left;
+  for (; nd; prev = nd, nd = successor(nd)) {
+    if (!prev) continue;
+    ++steps;
+    if (reinterpret_cast<char *>(nd) - reinterpret_cast<char *>(prev) !=
+        sizeof(node))
+      ++apart;
+  }
+  return double(apart) / steps;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::tree_iterator
+bitree<T, T2, Compare, Balance, Augment>::begin() {
+  tree_iterator iter = new_iterator();
   iter.first_node();
   return iter;
 }
 
-template <typename T, typename T2>
-typename bitree<T, T2>::tree_iterator bitree<T, T2>::end() {
-  tree_iterator iter;
-  iter.initialize(root, &tree_size);
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::tree_iterator
+bitree<T, T2, Compare, Balance, Augment>::end() {
+  tree_iterator iter = new_iterator();
   iter.last_node();
   return iter;
 }
 
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::tree_iterator
+bitree<T, T2, Compare, Balance, Augment>::new_iterator() {
+  detach();  // the iterator may write through, and must outlive copies
+  if (!iterators) iterators = new iterator_count{{1}};
+  tree_iterator iter;
+  iter.live = iterators;
+  ++iterators->refs;
+  iter.initialize(&root, &tree_size, comp);
+  return iter;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+typename bitree<T, T2, Compare, Balance, Augment>::tree_iterator
+bitree<T, T2, Compare, Balance, Augment>::iterator_at(size_t position) {
+  tree_iterator iter = new_iterator();
+  if (position >= tree_size) {
+    iter.last_node();
+    return iter;
+  }
+  if constexpr (std::is_same<Augment, subtree_size>::value) {
+    node *nd = root;
+    for (size_t k = position;;) {
+      size_t left = nd->left ? nd->left->value2 : 0;
+      if (k == left) break;
+      if (k < left) {
+        nd = nd->left;
+      } else {
+        k -= left + 1;
+        nd = nd->right;
+      }
+    }
+    iter.current_node = nd;
+    iter.position = position;
+  } else {
+    while (iter.position < position) ++iter;
+  }
+  return iter;
+}
+
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+template <typename K>
+typename bitree<T, T2, Compare, Balance, Augment>::tree_iterator
+bitree<T, T2, Compare, Balance, Augment>::iterator_to(const K &key) {
+  tree_iterator iter = new_iterator();
+  node *nd = const_cast<node *>(find_node(key));
+  if (!nd) {
+    iter.last_node();
+    return iter;
+  }
+  size_t position = 0;
+  if constexpr (std::is_same<Augment, subtree_size>::value) {
+    position = nd->left ? nd->left->value2 : 0;
+    for (const node *at = nd; at->parent; at = at->parent)
+      if (at == at->parent->right)
+        position += 1 + (at->parent->left ? at->parent->left->value2 : 0);
+  } else {
+    for (node *at = iter.current_node; at != nd; at = successor(at))
+      ++position;
+  }
+  iter.current_node = nd;
+  iter.position = position;
+  return iter;
+}
+
 //------------------ITER_FUNCS------------------//
-template <typename T, typename T2>
-int bitree<T, T2>::tree_iterator::first_node() {
-  current_node = root_node;
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::tree_iterator::first_node() {
+  current_node = *root_node;
   position = 0;
+  if (current_node == nullptr) return 0;  // empty tree
   while (current_node->left != nullptr) current_node = current_node->left;
   return 0;
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::tree_iterator::last_node() {
-  current_node = root_node;
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::tree_iterator::last_node() {
+  current_node = *root_node;
   position = *max_position;
+  if (current_node == nullptr) return 0;  // empty tree
   while (current_node->right != nullptr) current_node = current_node->right;
   return 0;
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::tree_iterator::next_node() {
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::tree_iterator::next_node() {
   if (current_node->right != nullptr) {
     current_node = current_node->right;
     while (current_node->left != nullptr) current_node = current_node->left;
+  } else if (current_node->parent == nullptr) {  // the root is the last node
+    first_node();
   } else if (current_node == current_node->parent->left)
     current_node = current_node->parent;
   else if (current_node == current_node->parent->right) {
-    while (current_node != root_node &&
+    while (current_node != *root_node &&
            current_node == current_node->parent->right)
       current_node = current_node->parent;
-    if (current_node != root_node)
+    if (current_node != *root_node)
       current_node = current_node->parent;
     else
       first_node();
@@ -531,14 +1126,15 @@ int bitree<T, T2>::tree_iterator::next_node() {
   return 0;
 }
 
-template <typename T, typename T2>
-int bitree<T, T2>::tree_iterator::back_node() {
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+int bitree<T, T2, Compare, Balance, Augment>::tree_iterator::back_node() {
   tree_iterator it;
   if (position == 1) {
     position = *max_position;
     last_node();
   } else {
-    it.initialize(root_node, max_position);
+    it.initialize(root_node, max_position, comp);
     it.first_node();
     for (size_t i = 0; i < position - 1; i++) ++it;
     position = it.position;
@@ -547,14 +1143,15 @@ int bitree<T, T2>::tree_iterator::back_node() {
   return 0;
 }
 
-template <typename T, typename T2>
-typename bitree<T, T2>::tree_iterator bitree<T, T2>::tree_iterator::set(
-    const T value) {
-  tree_iterator it;
-  it.initialize(root_node, max_position);
+template <typename T, typename T2, typename Compare, typename Balance,
+          typename Augment>
+template <typename K>
+typename bitree<T, T2, Compare, Balance, Augment>::tree_iterator
+bitree<T, T2, Compare, Balance, Augment>::tree_iterator::set(const K &value) {
+  tree_iterator it = *this;  // counted like this one
   it.first_node();
   while (it.position < *max_position + 1) {
-    if (it.cget() == value) return it;
+    if (!comp(it.cget(), value) && !comp(value, it.cget())) return it;
     ++it;
   }
   return it;
@@ -0,0 +1,120 @@
+#ifndef CONTAINERS_SRC_BITREE_MY_HOT_CACHE_H_
+#define CONTAINERS_SRC_BITREE_MY_HOT_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace my {
+
+struct hot_cache_stats {
+  bool enabled = false;
+  size_t slots = 0;    // nodes the cache can point at, two per set
+  size_t lookups = 0;  // lookups that asked the cache first
+  size_t hits = 0;
+  size_t flushes = 0;  // whole cache dropped: copy on write, clear
+
+  double hit_rate() const {
+    return lookups ? double(hits) / double(lookups) : 0;
+  }
+};
+
+// Two way set associative cache from recently found keys to the tree
+// nodes that hold them, asked before the tree descent. The high bits of
+// the key hash pick a set, the low ones are kept as a tag, so a way is
+// only read through when its tag matches, and then the tree order tells
+// whether it holds the key. The way hit last moves to the front, a miss
+// replaces the back one. The tree tells the cache about every node it
+// frees or moves, so a way never points at a dead node.
+template <typename Key, typename Node, typename Hash = std::hash<Key>>
+class hot_cache {
+ public:
+  explicit hot_cache(size_t slots) {  // rounded up to a power of two
+    size_t count = 1;
+    while (count * 2 < slots) count *= 2;
+    shift = 64;
+    for (size_t n = count; n > 1; n /= 2) --shift;
+    sets.reset(new set[count]());
+    set_count = count;
+  }
+
+  // Equal(key, node) tells whether node holds key
+  template <typename Equal>
+  Node *find(const Key &key, Equal equal) {
+    ++lookups;
+    uint64_t h = hash_of(key);
+    set &s = sets[set_index(h)];
+    uint32_t tag = uint32_t(h);
+    if (s.way[0] && s.tag[0] == tag && equal(key, s.way[0])) {
+      ++hits;
+      return s.way[0];
+    }
+    if (s.way[1] && s.tag[1] == tag && equal(key, s.way[1])) {
+      ++hits;
+      std::swap(s.way[0], s.way[1]);
+      std::swap(s.tag[0], s.tag[1]);
+      return s.way[0];
+    }
+    return nullptr;
+  }
+  void remember(const Key &key, Node *nd) {  // after a miss
+    uint64_t h = hash_of(key);
+    set &s = sets[set_index(h)];
+    s.way[1] = s.way[0];
+    s.tag[1] = s.tag[0];
+    s.way[0] = nd;
+    s.tag[0] = uint32_t(h);
+  }
+  void forget(const Key &key, const Node *nd) {  // nd is freed
+    set &s = set_of(key);
+    if (s.way[0] == nd) s.way[0] = nullptr;
+    if (s.way[1] == nd) s.way[1] = nullptr;
+  }
+  void moved(const Key &key, const Node *from, Node *to) {
+    set &s = set_of(key);
+    if (s.way[0] == from) s.way[0] = to;
+    if (s.way[1] == from) s.way[1] = to;
+  }
+  void flush() {
+    for (size_t i = 0; i < set_count; i++) sets[i] = set();
+    ++flushes;
+  }
+
+  size_t slots() const { return set_count * 2; }
+  hot_cache_stats stats() const {
+    hot_cache_stats out;
+    out.enabled = true;
+    out.slots = slots();
+    out.lookups = lookups;
+    out.hits = hits;
+    out.flushes = flushes;
+    return out;
+  }
+
+ private:
+  struct set {
+    Node *way[2] = {nullptr, nullptr};
+    uint32_t tag[2] = {0, 0};
+  };
+
+  std::unique_ptr<set[]> sets;
+  size_t set_count = 1;
+  int shift = 64;  // the high bits of the mixed hash pick the set
+  size_t lookups = 0;
+  size_t hits = 0;
+  size_t flushes = 0;
+
+  static uint64_t hash_of(const Key &key) {
+    return uint64_t(Hash()(key)) * 0x9E3779B97F4A7C15ull;
+  }
+  size_t set_index(uint64_t h) const {
+    return shift == 64 ? 0 : size_t(h >> shift);
+  }
+  set &set_of(const Key &key) const {
+    return sets[set_index(hash_of(key))];
+  }
+};
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_BITREE_MY_HOT_CACHE_H_
@@ -0,0 +1,464 @@
+#ifndef CONTAINERS_SRC_BITREE_MY_INDEX_BITREE_H
+#define CONTAINERS_SRC_BITREE_MY_INDEX_BITREE_H
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/my_vector.h"
+
+namespace my {
+
+struct no_value {};  // value type of index trees that only hold keys
+
+// Red-black tree stored in arrays instead of heap nodes. Node i is
+// links[i] + keys[i] + values[i]; links are 32 bit indexes and the colour
+// is the top bit of the parent index. Erased slots go on a free list
+// threaded through their left link and are reused by the next insert.
+// Against bitree a node costs 12 bytes of links instead of three pointers,
+// a colour word and a malloc header, and the nodes sit next to each other.
+// At most 2^31 - 1 entries.
+template <typename Key, typename T = no_value,
+          typename Compare = std::less<Key>>
+class index_bitree {
+ public:
+  using size_type = size_t;
+  using index = uint32_t;
+  static constexpr index kNil = 0x7FFFFFFF;   // no node
+  static constexpr index kRed = 0x80000000u;  // colour bit of link::up
+  static constexpr bool kHasValues = !std::is_same<T, no_value>::value;
+
+  explicit index_bitree(const Compare &order = Compare()) : comp(order) {}
+  index_bitree(const index_bitree &other) = default;
+  index_bitree(index_bitree &&other) noexcept
+      : links(std::move(other.links)),
+        keys(std::move(other.keys)),
+        values(std::move(other.values)),
+        root(other.root),
+        free_head(other.free_head),
+        count(other.count),
+        comp(other.comp) {
+    other.root = other.free_head = kNil;
+    other.count = 0;
+  }
+  index_bitree &operator=(const index_bitree &other) {
+    if (this != &other) {
+      index_bitree tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+  index_bitree &operator=(index_bitree &&other) noexcept {
+    if (this != &other) {
+      index_bitree tmp(std::move(other));
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  void swap(index_bitree &other) noexcept {
+    links.swap(other.links);
+    keys.swap(other.keys);
+    values.swap(other.values);
+    std::swap(root, other.root);
+    std::swap(free_head, other.free_head);
+    std::swap(count, other.count);
+    std::swap(comp, other.comp);
+  }
+
+  size_type size() const { return count; }
+  size_type max_size() const { return kNil - 1; }
+  size_type capacity() const { return links.capacity(); }
+  size_type memory_usage() const {  // bytes of the three arrays
+    return links.capacity() * sizeof(link) + keys.capacity() * sizeof(Key) +
+           values.capacity() * sizeof(T);
+  }
+  void reserve(size_type n) {
+    links.reserve(n);
+    keys.reserve(n);
+    if (kHasValues) values.reserve(n);
+  }
+  void clear() {
+    index_bitree tmp(comp);
+    swap(tmp);
+  }
+  Compare key_comp() const { return comp; }
+
+  const Key &key_at(index i) const { return keys[i]; }
+  T &value_at(index i) const { return values[i]; }  // until an insert grows
+
+  index first() const { return root == kNil ? kNil : minimum(root); }
+  index last() const { return root == kNil ? kNil : maximum(root); }
+  index next(index i) const;  // kNil after the last node
+  index prev(index i) const;  // kNil before the first node
+
+  template <typename K>
+  index find(const K &key) const;
+  template <typename K>
+  index lower_bound(const K &key) const;  // first not less than key
+  template <typename K>
+  index upper_bound(const K &key) const;  // first greater than key
+
+  // index of key, and true if it was added with value
+  std::pair<index, bool> insert(const Key &key, const T &value = T());
+  void erase_at(index z);
+  template <typename K>
+  bool erase(const K &key) {
+    index z = find(key);
+    if (z == kNil) return false;
+    erase_at(z);
+    return true;
+  }
+
+ private:
+  struct link {
+    index up;  // parent | colour
+    index left;
+    index right;
+  };
+
+  vector<link> links;
+  vector<Key> keys;
+  vector<T> values;
+  index root = kNil;
+  index free_head = kNil;  // erased slots, linked by left
+  size_type count = 0;
+  Compare comp;
+
+  index parent(index i) const { return links[i].up & kNil; }
+  void set_parent(index i, index p) { links[i].up = (links[i].up & kRed) | p; }
+  bool red(index i) const { return i != kNil && (links[i].up & kRed); }
+  void paint(index i, bool is_red) {
+    if (i == kNil) return;
+    links[i].up = (links[i].up & kNil) | (is_red ? kRed : 0);
+  }
+  index &left(index i) const { return links[i].left; }
+  index &right(index i) const { return links[i].right; }
+  index minimum(index i) const {
+    while (left(i) != kNil) i = left(i);
+    return i;
+  }
+  index maximum(index i) const {
+    while (right(i) != kNil) i = right(i);
+    return i;
+  }
+
+  index allocate(const Key &key, const T &value);
+  void rotate_left(index x);
+  void rotate_right(index x);
+  void transplant(index u, index v);
+  void insert_fixup(index z);
+  void erase_fixup(index x, index parent_of_x);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename T, typename Compare>
+typename index_bitree<Key, T, Compare>::index
+index_bitree<Key, T, Compare>::next(index i) const {
+  if (right(i) != kNil) return minimum(right(i));
+  index up = parent(i);
+  while (up != kNil && i == right(up)) {
+    i = up;
+    up = parent(up);
+  }
+  return up;
+}
+
+template <typename Key, typename T, typename Compare>
+typename index_bitree<Key, T, Compare>::index
+index_bitree<Key, T, Compare>::prev(index i) const {
+  if (left(i) != kNil) return maximum(left(i));
+  index up = parent(i);
+  while (up != kNil && i == left(up)) {
+    i = up;
+    up = parent(up);
+  }
+  return up;
+}
+
+template <typename Key, typename T, typename Compare>
+template <typename K>
+typename index_bitree<Key, T, Compare>::index
+index_bitree<Key, T, Compare>::find(const K &key) const {
+  index i = root;
+  while (i != kNil) {
+    if (comp(key, keys[i]))
+      i = left(i);
+    else if (comp(keys[i], key))
+      i = right(i);
+    else
+      break;
+  }
+  return i;
+}
+
+template <typename Key, typename T, typename Compare>
+template <typename K>
+typename index_bitree<Key, T, Compare>::index
+index_bitree<Key, T, Compare>::lower_bound(const K &key) const {
+  index i = root, found = kNil;
+  while (i != kNil) {
+    if (comp(keys[i], key)) {
+      i = right(i);
+    } else {
+      found = i;
+      i = left(i);
+    }
+  }
+  return found;
+}
+
+template <typename Key, typename T, typename Compare>
+template <typename K>
+typename index_bitree<Key, T, Compare>::index
+index_bitree<Key, T, Compare>::upper_bound(const K &key) const {
+  index i = root, found = kNil;
+  while (i != kNil) {
+    if (comp(key, keys[i])) {
+      found = i;
+      i = left(i);
+    } else {
+      i = right(i);
+    }
+  }
+  return found;
+}
+
+template <typename Key, typename T, typename Compare>
+typename index_bitree<Key, T, Compare>::index
+index_bitree<Key, T, Compare>::allocate(const Key &key, const T &value) {
+  if (free_head != kNil) {  // reuse an erased slot
+    index i = free_head;
+    free_head = left(i);
+    keys[i] = key;
+    if (kHasValues) values[i] = value;
+    return i;
+  }
+  if (links.size() >= kNil - 1) throw std::length_error("index_bitree full");
+  links.push_back(link{kNil, kNil, kNil});
+  keys.push_back(key);
+  if (kHasValues) values.push_back(value);
+  return index(links.size() - 1);
+}
+
+template <typename Key, typename T, typename Compare>
+std::pair<typename index_bitree<Key, T, Compare>::index, bool>
+index_bitree<Key, T, Compare>::insert(const Key &key, const T &value) {
+  index up = kNil, i = root;
+  bool go_left = false;
+  while (i != kNil) {
+    up = i;
+    if (comp(key, keys[i])) {
+      go_left = true;
+      i = left(i);
+    } else if (comp(keys[i], key)) {
+      go_left = false;
+      i = right(i);
+    } else {
+      return {i, false};
+    }
+  }
+  index z = allocate(key, value);
+  links[z] = link{up | kRed, kNil, kNil};
+  if (up == kNil)
+    root = z;
+  else if (go_left)
+    left(up) = z;
+  else
+    right(up) = z;
+  insert_fixup(z);
+  ++count;
+  return {z, true};
+}
+
+template <typename Key, typename T, typename Compare>
+void index_bitree<Key, T, Compare>::erase_at(index z) {
+  index y = z, x, x_parent;
+  bool removed_red = red(y);
+  if (left(z) == kNil) {
+    x = right(z);
+    x_parent = parent(z);
+    transplant(z, x);
+  } else if (right(z) == kNil) {
+    x = left(z);
+    x_parent = parent(z);
+    transplant(z, x);
+  } else {  // two children: successor y takes the place of z
+    y = minimum(right(z));
+    removed_red = red(y);
+    x = right(y);
+    if (parent(y) == z) {
+      x_parent = y;
+    } else {
+      x_parent = parent(y);
+      transplant(y, x);
+      right(y) = right(z);
+      set_parent(right(y), y);
+    }
+    transplant(z, y);
+    left(y) = left(z);
+    set_parent(left(y), y);
+    paint(y, red(z));
+  }
+  if (!removed_red) erase_fixup(x, x_parent);
+
+  keys[z] = Key();  // release what the key and value hold
+  if (kHasValues) values[z] = T();
+  links[z] = link{kNil, free_head, kNil};
+  free_head = z;
+  --count;
+}
+
+template <typename Key, typename T, typename Compare>
+void index_bitree<Key, T, Compare>::rotate_left(index x) {
+  index y = right(x);
+  right(x) = left(y);
+  if (left(y) != kNil) set_parent(left(y), x);
+  index up = parent(x);
+  set_parent(y, up);
+  if (up == kNil)
+    root = y;
+  else if (x == left(up))
+    left(up) = y;
+  else
+    right(up) = y;
+  left(y) = x;
+  set_parent(x, y);
+}
+
+template <typename Key, typename T, typename Compare>
+void index_bitree<Key, T, Compare>::rotate_right(index x) {
+  index y = left(x);
+  left(x) = right(y);
+  if (right(y) != kNil) set_parent(right(y), x);
+  index up = parent(x);
+  set_parent(y, up);
+  if (up == kNil)
+    root = y;
+  else if (x == right(up))
+    right(up) = y;
+  else
+    left(up) = y;
+  right(y) = x;
+  set_parent(x, y);
+}
+
+template <typename Key, typename T, typename Compare>
+void index_bitree<Key, T, Compare>::transplant(index u, index v) {
+  index up = parent(u);
+  if (up == kNil)
+    root = v;
+  else if (u == left(up))
+    left(up) = v;
+  else
+    right(up) = v;
+  if (v != kNil) set_parent(v, up);
+}
+
+template <typename Key, typename T, typename Compare>
+void index_bitree<Key, T, Compare>::insert_fixup(index z) {
+  while (red(parent(z))) {  // a red parent is never the root
+    index up = parent(z), grand = parent(up);
+    if (up == left(grand)) {
+      index uncle = right(grand);
+      if (red(uncle)) {
+        paint(up, false);
+        paint(uncle, false);
+        paint(grand, true);
+        z = grand;
+      } else {
+        if (z == right(up)) {
+          z = up;
+          rotate_left(z);
+          up = parent(z);
+        }
+        paint(up, false);
+        paint(grand, true);
+        rotate_right(grand);
+      }
+    } else {
+      index uncle = left(grand);
+      if (red(uncle)) {
+        paint(up, false);
+        paint(uncle, false);
+        paint(grand, true);
+        z = grand;
+      } else {
+        if (z == left(up)) {
+          z = up;
+          rotate_right(z);
+          up = parent(z);
+        }
+        paint(up, false);
+        paint(grand, true);
+        rotate_left(grand);
+      }
+    }
+  }
+  paint(root, false);
+}
+
+template <typename Key, typename T, typename Compare>
+void index_bitree<Key, T, Compare>::erase_fixup(index x, index up) {
+  // x carries an extra black; it may be kNil, so its parent is passed
+  while (x != root && !red(x)) {
+    if (x == left(up)) {
+      index brother = right(up);
+      if (red(brother)) {
+        paint(brother, false);
+        paint(up, true);
+        rotate_left(up);
+        brother = right(up);
+      }
+      if (!red(left(brother)) && !red(right(brother))) {
+        paint(brother, true);
+        x = up;
+        up = parent(x);
+      } else {
+        if (!red(right(brother))) {
+          paint(left(brother), false);
+          paint(brother, true);
+          rotate_right(brother);
+          brother = right(up);
+        }
+        paint(brother, red(up));
+        paint(up, false);
+        paint(right(brother), false);
+        rotate_left(up);
+        x = root;
+      }
+    } else {
+      index brother = left(up);
+      if (red(brother)) {
+        paint(brother, false);
+        paint(up, true);
+        rotate_right(up);
+        brother = left(up);
+      }
+      if (!red(left(brother)) && !red(right(brother))) {
+        paint(brother, true);
+        x = up;
+        up = parent(x);
+      } else {
+        if (!red(left(brother))) {
+          paint(right(brother), false);
+          paint(brother, true);
+          rotate_left(brother);
+          brother = left(up);
+        }
+        paint(brother, red(up));
+        paint(up, false);
+        paint(left(brother), false);
+        rotate_right(up);
+        x = root;
+      }
+    }
+  }
+  paint(x, false);
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_BITREE_MY_INDEX_BITREE_H
@@ -0,0 +1,251 @@
+#ifndef CONTAINERS_SRC_BLOOM_MY_BLOOM_H_
+#define CONTAINERS_SRC_BLOOM_MY_BLOOM_H_
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+namespace my {
+
+struct bloom_stats {
+  bool enabled = false;
+  double fp_rate = 0;       // configured target
+  double expected_fp = 0;   // for the keys in the filter now
+  size_t bytes = 0;         // memory of the bit array
+  size_t probes = 0;        // bits tested per key
+  size_t lookups = 0;       // queries that went through the filter
+  size_t filtered = 0;      // definite misses answered by the filter alone
+  size_t false_positives = 0;
+  size_t rebuilds = 0;
+};
+
+// Blocked Bloom filter: every key maps to one 512 bit block, a single
+// cache line, and sets or tests all of its probe bits inside that block.
+// This costs a little accuracy against a classic filter of the same size,
+// so a few more bits per key are spent for the target rate.
+template <typename Key, typename Hash = std::hash<Key>>
+class blocked_bloom {
+ public:
+  static constexpr size_t kBlockBits = 512;
+
+  blocked_bloom(size_t capacity, double fp_rate);
+  blocked_bloom(const blocked_bloom &other);
+  blocked_bloom &operator=(const blocked_bloom &) = delete;
+
+  void add(const Key &key);
+  bool may_contain(const Key &key) const;
+
+  size_t size() const { return keys; }
+  size_t capacity() const { return limit; }
+  size_t bytes() const { return block_count * sizeof(block); }
+  size_t probe_count() const { return probes; }
+  double expected_fp() const {  // classic estimate for keys in the filter
+    double fill = std::exp(-double(probes) * keys / (block_count * 512.0));
+    return std::pow(1 - fill, double(probes));
+  }
+
+ private:
+  struct alignas(64) block {
+    uint64_t words[8];
+  };
+
+  std::unique_ptr<block[]> blocks;
+  size_t block_count = 1;
+  size_t probes = 1;
+  size_t keys = 0;   // keys added since the filter was built
+  size_t limit = 0;  // keys the filter was sized for
+
+  uint64_t hash_of(const Key &key) const {
+    __uint128_t product =
+        __uint128_t(uint64_t(Hash()(key))) * 0x9E3779B97F4A7C15ull;
+    return uint64_t(product) ^ uint64_t(product >> 64);
+  }
+  static uint32_t probe_step(uint64_t h) {  // odd, and independent of
+    return uint32_t((h * 0xC2B2AE3D27D4EB4Full) >> 32) | 1;  // the block
+  }
+  block &block_of(uint64_t h) const {  // high bits pick the block
+    return blocks[(__uint128_t(h >> 32) * block_count) >> 32];
+  }
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Hash>
+blocked_bloom<Key, Hash>::blocked_bloom(size_t capacity, double fp_rate)
+    : limit(capacity) {
+  if (!(fp_rate > 0 && fp_rate < 1))
+    throw std::invalid_argument("Bloom false positive rate out of (0, 1)");
+  // 1.44 * log2(1 / p) bits per key for a classic filter, plus one bit
+  // to make up for blocking
+  double bits_per_key = 1.44 * std::log2(1 / fp_rate) + 1;
+  probes = size_t(std::lround(bits_per_key * 0.69));
+  if (probes < 1) probes = 1;
+  if (probes > 16) probes = 16;
+  double total = bits_per_key * (capacity ? capacity : 1);
+  block_count = size_t(std::ceil(total / kBlockBits));
+  blocks.reset(new block[block_count]);
+  std::memset(blocks.get(), 0, block_count * sizeof(block));
+}
+
+template <typename Key, typename Hash>
+blocked_bloom<Key, Hash>::blocked_bloom(const blocked_bloom &other)
+    : blocks(new block[other.block_count]),
+      block_count(other.block_count),
+      probes(other.probes),
+      keys(other.keys),
+      limit(other.limit) {
+  std::memcpy(blocks.get(), other.blocks.get(), block_count * sizeof(block));
+}
+
+template <typename Key, typename Hash>
+void blocked_bloom<Key, Hash>::add(const Key &key) {
+  uint64_t h = hash_of(key);
+  block &b = block_of(h);
+  uint32_t pos = uint32_t(h), step = probe_step(h);
+  for (size_t i = 0; i < probes; i++, pos += step)
+    b.words[(pos >> 6) & 7] |= uint64_t(1) << (pos & 63);
+  ++keys;
+}
+
+template <typename Key, typename Hash>
+bool blocked_bloom<Key, Hash>::may_contain(const Key &key) const {
+  uint64_t h = hash_of(key);
+  const block &b = block_of(h);
+  uint32_t pos = uint32_t(h), step = probe_step(h);
+  for (size_t i = 0; i < probes; i++, pos += step)
+    if (!(b.words[(pos >> 6) & 7] & (uint64_t(1) << (pos & 63)))) return false;
+  return true;
+}
+
+// Counter that concurrent readers bump; a copy takes a snapshot
+struct relaxed_count {
+  mutable std::atomic<size_t> value{0};
+
+  relaxed_count() {}
+  relaxed_count(const relaxed_count &other) noexcept : value(other.get()) {}
+  relaxed_count &operator=(const relaxed_count &other) noexcept {
+    value.store(other.get(), std::memory_order_relaxed);
+    return *this;
+  }
+  void add() const { value.fetch_add(1, std::memory_order_relaxed); }
+  size_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Optional filter in front of the lookups of a set or map. Inserts go
+// straight into the filter; erases and bulk changes only mark it. The
+// container calls refresh after every change, which rebuilds the filter
+// right away once it is marked stale, too many erased keys linger or more
+// keys arrived than it was sized for. Lookups only read the filter and
+// bump relaxed counters, so const lookups may run concurrently.
+template <typename Key, typename Hash = std::hash<Key>>
+class bloom_index {
+ public:
+  bloom_index() {}
+  bloom_index(const bloom_index &other)
+      : filter(other.filter ? new blocked_bloom<Key, Hash>(*other.filter)
+                            : nullptr),
+        stats(other.stats),
+        lookups(other.lookups),
+        filtered(other.filtered),
+        false_positives(other.false_positives),
+        erased(other.erased),
+        stale(other.stale) {}
+  bloom_index(bloom_index &&other) noexcept = default;
+  bloom_index &operator=(const bloom_index &other) {
+    if (this != &other) {
+      bloom_index tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+  bloom_index &operator=(bloom_index &&other) noexcept = default;
+
+  bool enabled() const { return filter != nullptr; }
+  void enable(double fp_rate) {  // built by the next refresh
+    filter.reset(new blocked_bloom<Key, Hash>(0, fp_rate));
+    reset_stats();
+    stats.enabled = true;
+    stats.fp_rate = fp_rate;
+    stale = true;
+  }
+  void disable() {
+    filter.reset();
+    reset_stats();
+  }
+
+  void inserted(const Key &key) {
+    if (filter && !stale) filter->add(key);
+  }
+  void removed() {
+    if (filter) ++erased;
+  }
+  void invalidate() { stale = true; }
+
+  // for_each(f) must call f(key) for every one of the live keys of the
+  // container; used to rebuild the filter when needed
+  template <typename ForEach>
+  void refresh(size_t live, ForEach for_each);
+
+  bool may_contain(const Key &key) const;  // false if key is surely missing
+  bool found(bool hit) const {  // result of the real lookup
+    if (filter && !hit) false_positives.add();
+    return hit;
+  }
+  bloom_stats get_stats() const;
+
+ private:
+  std::unique_ptr<blocked_bloom<Key, Hash>> filter;
+  bloom_stats stats;  // settings and rebuilds; the counters are below
+  relaxed_count lookups, filtered, false_positives;
+  size_t erased = 0;  // keys erased since the last build
+  bool stale = false;
+
+  void reset_stats() {
+    stats = bloom_stats();
+    lookups = filtered = false_positives = relaxed_count();
+  }
+};
+
+template <typename Key, typename Hash>
+template <typename ForEach>
+void bloom_index<Key, Hash>::refresh(size_t live, ForEach for_each) {
+  if (!filter) return;
+  if (stale || erased * 4 > live + 64 || filter->size() > filter->capacity()) {
+    filter.reset(new blocked_bloom<Key, Hash>(live * 2 + 64, stats.fp_rate));
+    blocked_bloom<Key, Hash> *target = filter.get();
+    for_each([target](const Key &k) { target->add(k); });
+    erased = 0;
+    stale = false;
+    ++stats.rebuilds;
+  }
+}
+
+template <typename Key, typename Hash>
+bool bloom_index<Key, Hash>::may_contain(const Key &key) const {
+  if (!filter) return true;
+  lookups.add();
+  if (filter->may_contain(key)) return true;
+  filtered.add();
+  return false;
+}
+
+template <typename Key, typename Hash>
+bloom_stats bloom_index<Key, Hash>::get_stats() const {
+  bloom_stats out = stats;
+  out.lookups = lookups.get();
+  out.filtered = filtered.get();
+  out.false_positives = false_positives.get();
+  if (filter) {
+    out.bytes = filter->bytes();
+    out.probes = filter->probe_count();
+    out.expected_fp = filter->expected_fp();
+  }
+  return out;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_BLOOM_MY_BLOOM_H_
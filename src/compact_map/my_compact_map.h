@@ -0,0 +1,243 @@
+#ifndef CONTAINERS_SRC_COMPACT_MAP_MY_COMPACT_MAP_H_
+#define CONTAINERS_SRC_COMPACT_MAP_MY_COMPACT_MAP_H_
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "../bitree/my_index_bitree.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// map and set on index_bitree: the same ordered container, for many small
+// entries. Keys and values live in separate arrays, so an iterator hands
+// out the pair as references, std::pair<const Key &, T &>.
+// Unlike map, an insert that grows the arrays moves every entry: it
+// invalidates references from at(), operator[] and the iterators, while
+// the iterators themselves stay valid. Inserts into reserve()d room or
+// into erased slots move nothing. So m[a] = m[b] needs the room reserved
+// or the value copied first.
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class compact_map {
+ private:
+  using tree_type = index_bitree<Key, T, Compare>;
+  using index = typename tree_type::index;
+  tree_type tree;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = std::pair<const Key &, T &>;
+  using size_type = size_t;
+
+  //------------------ITERATOR------------------//
+  class iterator {
+   public:
+    iterator(const tree_type *tree = nullptr, index pos = tree_type::kNil)
+        : owner(tree), current(pos) {}
+    const Key &cget() const { return owner->key_at(current); }
+    T &value() const { return owner->value_at(current); }
+    reference operator*() const { return reference(cget(), value()); }
+    struct arrow {  // it->first, it->second on a pair made on the fly
+      reference item;
+      const reference *operator->() const { return &item; }
+    };
+    arrow operator->() const { return arrow{**this}; }
+
+    iterator &operator++() {
+      current = owner->next(current);
+      return *this;
+    }
+    iterator &operator--() {  // from end() to the last element
+      current = current == tree_type::kNil ? owner->last()
+                                           : owner->prev(current);
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return current == other.current;
+    }
+    bool operator!=(const iterator &other) const {
+      return current != other.current;
+    }
+
+   private:
+    const tree_type *owner;
+    index current;
+    friend class compact_map;
+  };  // class iterator
+
+  compact_map() {}
+  explicit compact_map(const Compare &order) : tree(order) {}
+  compact_map(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item);
+  }
+
+  T &at(const Key &key) {
+    index i = tree.find(key);
+    if (i == tree_type::kNil) throw std::out_of_range("Key not found");
+    return tree.value_at(i);
+  }
+  const T &at(const Key &key) const {
+    index i = tree.find(key);
+    if (i == tree_type::kNil) throw std::out_of_range("Key not found");
+    return tree.value_at(i);
+  }
+  T &operator[](const Key &key) {  // may move the other values, see above
+    return tree.value_at(tree.insert(key).first);
+  }
+
+  iterator begin() const { return iterator(&tree, tree.first()); }
+  iterator end() const { return iterator(&tree, tree_type::kNil); }
+
+  bool empty() const { return tree.size() == 0; }
+  size_type size() const { return tree.size(); }
+  size_type max_size() const { return tree.max_size(); }
+  size_type memory_usage() const { return tree.memory_usage(); }
+  void reserve(size_type n) { tree.reserve(n); }
+
+  void clear() { tree.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return insert(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    auto res = tree.insert(key, obj);
+    return {iterator(&tree, res.first), res.second};
+  }
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    auto res = tree.insert(key, obj);
+    if (!res.second) tree.value_at(res.first) = obj;
+    return {iterator(&tree, res.first), res.second};
+  }
+  void erase(iterator it) { tree.erase_at(it.current); }
+  bool erase(const Key &key) { return tree.erase(key); }
+  void merge(compact_map &other) {  // values of other win on equal keys
+    for (auto it = other.begin(); it != other.end(); ++it)
+      insert_or_assign(it.cget(), it.value());
+  }
+
+  iterator find(const Key &key) const {
+    return iterator(&tree, tree.find(key));
+  }
+  bool contains(const Key &key) const {
+    return tree.find(key) != tree_type::kNil;
+  }
+  size_type count(const Key &key) const { return contains(key); }
+  iterator lower_bound(const Key &key) const {
+    return iterator(&tree, tree.lower_bound(key));
+  }
+  iterator upper_bound(const Key &key) const {
+    return iterator(&tree, tree.upper_bound(key));
+  }
+  Compare key_comp() const { return tree.key_comp(); }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<std::pair<iterator, bool>> out;
+    ((out.push_back(this->insert(args))), ...);
+    return out;
+  }
+};
+
+template <typename Key, typename Compare = std::less<Key>>
+class compact_set {
+ private:
+  using tree_type = index_bitree<Key, no_value, Compare>;
+  using index = typename tree_type::index;
+  tree_type tree;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+
+  //------------------ITERATOR------------------//
+  class iterator {
+   public:
+    iterator(const tree_type *tree = nullptr, index pos = tree_type::kNil)
+        : owner(tree), current(pos) {}
+    const Key &cget() const { return owner->key_at(current); }
+    const Key &operator*() const { return cget(); }
+    const Key *operator->() const { return &cget(); }
+
+    iterator &operator++() {
+      current = owner->next(current);
+      return *this;
+    }
+    iterator &operator--() {
+      current = current == tree_type::kNil ? owner->last()
+                                           : owner->prev(current);
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return current == other.current;
+    }
+    bool operator!=(const iterator &other) const {
+      return current != other.current;
+    }
+
+   private:
+    const tree_type *owner;
+    index current;
+    friend class compact_set;
+  };  // class iterator
+
+  compact_set() {}
+  explicit compact_set(const Compare &order) : tree(order) {}
+  compact_set(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item);
+  }
+
+  iterator begin() const { return iterator(&tree, tree.first()); }
+  iterator end() const { return iterator(&tree, tree_type::kNil); }
+
+  bool empty() const { return tree.size() == 0; }
+  size_type size() const { return tree.size(); }
+  size_type max_size() const { return tree.max_size(); }
+  size_type memory_usage() const { return tree.memory_usage(); }
+  void reserve(size_type n) { tree.reserve(n); }
+
+  void clear() { tree.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    auto res = tree.insert(value);
+    return {iterator(&tree, res.first), res.second};
+  }
+  bool erase(const value_type &value) { return tree.erase(value); }
+  iterator erase(iterator it) {
+    iterator next = it;
+    ++next;
+    tree.erase_at(it.current);  // slots do not move, next stays valid
+    return next;
+  }
+  void merge(compact_set &other) {
+    for (const auto &key : other) insert(key);
+  }
+
+  iterator find(const Key &key) const {
+    return iterator(&tree, tree.find(key));
+  }
+  bool contains(const Key &key) const {
+    return tree.find(key) != tree_type::kNil;
+  }
+  size_type count(const Key &key) const { return contains(key); }
+  iterator lower_bound(const Key &key) const {
+    return iterator(&tree, tree.lower_bound(key));
+  }
+  iterator upper_bound(const Key &key) const {
+    return iterator(&tree, tree.upper_bound(key));
+  }
+  Compare key_comp() const { return tree.key_comp(); }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<std::pair<iterator, bool>> out;
+    ((out.push_back(this->insert(args))), ...);
+    return out;
+  }
+};
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_COMPACT_MAP_MY_COMPACT_MAP_H_
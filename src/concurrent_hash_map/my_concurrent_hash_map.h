@@ -0,0 +1,301 @@
+#ifndef CONTAINERS_SRC_CONCURRENT_HASH_MAP_MY_CONCURRENT_HASH_MAP_H_
+#define CONTAINERS_SRC_CONCURRENT_HASH_MAP_MY_CONCURRENT_HASH_MAP_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "../epoch/my_epoch.h"
+
+namespace my {
+
+// Hash map for many threads. Every bucket is a chain guarded by its own
+// spin lock for writers, while readers walk the chains without locking
+// under an epoch guard. Nodes are never changed after they are published:
+// an update links a new node in place of the old one and retires it.
+//
+// Growing is incremental. The writer that crosses the load limit only
+// allocates the next table; from then on every writer moves one chunk of
+// old buckets before its own operation. A moved bucket keeps a tagged head
+// that sends readers and writers on to the next table, and the old table
+// is retired once its last chunk is done.
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class concurrent_hash_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = size_t;
+
+  static constexpr size_type kMinBuckets = 16;
+  static constexpr size_type kMigrateChunk = 64;  // buckets moved per helper
+
+  concurrent_hash_map() : current(new table(kMinBuckets)), map_size(0) {}
+  concurrent_hash_map(std::initializer_list<value_type> const &items)
+      : concurrent_hash_map() {
+    for (const auto &item : items) insert(item);
+  }
+  concurrent_hash_map(const concurrent_hash_map &) = delete;
+  concurrent_hash_map &operator=(const concurrent_hash_map &) = delete;
+  ~concurrent_hash_map() {
+    clear();
+    destroy_table(current.load());
+  }
+
+  bool empty() const { return size() == 0; }
+  size_type size() const {
+    long n = map_size.load();
+    return n < 0 ? 0 : size_type(n);
+  }
+  size_type bucket_count() const { return current.load()->buckets; }
+
+  void clear();  // not thread safe
+
+  bool insert(const value_type &value) {
+    return update(value.first, value.second, false);
+  }
+  bool insert(const Key &key, const T &obj) {
+    return update(key, obj, false);
+  }
+  bool insert_or_assign(const Key &key, const T &obj) {  // true if inserted
+    return update(key, obj, true);
+  }
+  bool erase(const Key &key);
+
+  bool contains(const Key &key) const {
+    epoch_domain::guard pin;
+    return lookup(key) != nullptr;
+  }
+  bool find(const Key &key, T &value) const {  // copies the value out
+    epoch_domain::guard pin;
+    const node *nd = lookup(key);
+    if (nd == nullptr) return false;
+    value = nd->value.second;
+    return true;
+  }
+  T at(const Key &key) const {  // copy of the value, the node may go away
+    T value;
+    if (!find(key, value)) throw std::out_of_range("Key not found");
+    return value;
+  }
+
+ private:
+  typedef struct node {
+    const value_type value;
+    const size_type hash;
+    std::atomic<uintptr_t> next;  // never tagged
+
+    node(const value_type &v, size_type h, node *n)
+        : value(v), hash(h), next(raw(n)) {}
+  } node;
+
+  struct bucket {
+    std::atomic<uintptr_t> head{0};  // chain, low bit set once moved
+    std::atomic<bool> locked{false};
+
+    void lock() {
+      for (int spins = 0; locked.exchange(true, std::memory_order_acquire);) {
+        while (locked.load(std::memory_order_relaxed))
+          if (++spins % 64 == 0) std::this_thread::yield();
+      }
+    }
+    void unlock() { locked.store(false, std::memory_order_release); }
+  };
+
+  struct table {
+    const size_type buckets;  // power of two
+    bucket *slots;
+    std::atomic<table *> next{nullptr};   // bigger table while growing
+    std::atomic<size_type> claimed{0};    // buckets handed out to movers
+    std::atomic<size_type> moved{0};      // buckets already moved
+
+    explicit table(size_type n) : buckets(n), slots(new bucket[n]) {}
+    ~table() { delete[] slots; }
+    bucket &at(size_type hash) { return slots[hash & (buckets - 1)]; }
+  };
+
+  static constexpr uintptr_t kMoved = 1;
+  static node *ptr(uintptr_t p) {
+    return reinterpret_cast<node *>(p & ~kMoved);
+  }
+  static uintptr_t raw(node *p) { return reinterpret_cast<uintptr_t>(p); }
+  static void destroy_node(void *nd) { delete static_cast<node *>(nd); }
+  static void destroy_table(void *t) { delete static_cast<table *>(t); }
+
+  std::atomic<table *> current;
+  std::atomic<long> map_size;  // may dip below zero while racing
+  Hash hasher;
+  KeyEqual equal;
+
+  size_type hash_of(const Key &key) const {  // spreads weak hashes
+    uint64_t h = hasher(key);
+    __uint128_t product = __uint128_t(h) * 0x9E3779B97F4A7C15ull;
+    return uint64_t(product) ^ uint64_t(product >> 64);
+  }
+  const node *lookup(const Key &key) const;  // caller holds a guard
+  bool update(const Key &key, const T &obj, bool assign);
+  bucket &lock_bucket(size_type hash);  // locked bucket that holds hash
+  void help_grow();                     // move one chunk if growing
+  void move_bucket(table *from, table *to, size_type i);
+  void start_grow(table *t);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+const typename concurrent_hash_map<Key, T, Hash, KeyEqual>::node *
+concurrent_hash_map<Key, T, Hash, KeyEqual>::lookup(const Key &key) const {
+  size_type h = hash_of(key);
+  table *t = current.load(std::memory_order_acquire);
+  uintptr_t head = t->at(h).head.load(std::memory_order_acquire);
+  while (head & kMoved) {  // bucket went to the next table
+    t = t->next.load(std::memory_order_acquire);
+    head = t->at(h).head.load(std::memory_order_acquire);
+  }
+  for (node *nd = ptr(head); nd;
+       nd = ptr(nd->next.load(std::memory_order_acquire)))
+    if (nd->hash == h && equal(nd->value.first, key)) return nd;
+  return nullptr;
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_hash_map<Key, T, Hash, KeyEqual>::bucket &
+concurrent_hash_map<Key, T, Hash, KeyEqual>::lock_bucket(size_type hash) {
+  table *t = current.load(std::memory_order_acquire);
+  for (;;) {
+    bucket &b = t->at(hash);
+    b.lock();
+    if (!(b.head.load(std::memory_order_relaxed) & kMoved)) return b;
+    b.unlock();
+    t = t->next.load(std::memory_order_acquire);
+  }
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual>::update(const Key &key,
+                                                         const T &obj,
+                                                         bool assign) {
+  epoch_domain::guard pin;
+  help_grow();
+  size_type h = hash_of(key);
+  bucket &b = lock_bucket(h);
+  std::atomic<uintptr_t> *link = &b.head;
+  for (node *nd = ptr(link->load()); nd; nd = ptr(nd->next.load())) {
+    if (nd->hash == h && equal(nd->value.first, key)) {
+      if (assign) {  // publish a copy, readers may still hold the old node
+        node *fresh = new node(value_type(key, obj), h, ptr(nd->next.load()));
+        link->store(raw(fresh), std::memory_order_release);
+        epoch_domain::global().retire(nd, destroy_node);
+      }
+      b.unlock();
+      return false;
+    }
+    link = &nd->next;
+  }
+  node *head = ptr(b.head.load(std::memory_order_relaxed));
+  b.head.store(raw(new node(value_type(key, obj), h, head)),
+               std::memory_order_release);
+  b.unlock();
+  long n = map_size.fetch_add(1) + 1;
+  table *t = current.load(std::memory_order_acquire);
+  if (size_type(n) > t->buckets - t->buckets / 4) start_grow(t);
+  return true;
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+bool concurrent_hash_map<Key, T, Hash, KeyEqual>::erase(const Key &key) {
+  epoch_domain::guard pin;
+  help_grow();
+  size_type h = hash_of(key);
+  bucket &b = lock_bucket(h);
+  std::atomic<uintptr_t> *link = &b.head;
+  for (node *nd = ptr(link->load()); nd; nd = ptr(nd->next.load())) {
+    if (nd->hash == h && equal(nd->value.first, key)) {
+      link->store(nd->next.load(), std::memory_order_release);
+      b.unlock();
+      map_size.fetch_sub(1);
+      epoch_domain::global().retire(nd, destroy_node);
+      return true;
+    }
+    link = &nd->next;
+  }
+  b.unlock();
+  return false;
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_hash_map<Key, T, Hash, KeyEqual>::start_grow(table *t) {
+  if (t->next.load() != nullptr || current.load() != t) return;
+  table *bigger = new table(t->buckets * 2);
+  table *expected = nullptr;
+  if (!t->next.compare_exchange_strong(expected, bigger)) delete bigger;
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_hash_map<Key, T, Hash, KeyEqual>::help_grow() {
+  table *t = current.load(std::memory_order_acquire);
+  table *to = t->next.load(std::memory_order_acquire);
+  if (to == nullptr) return;
+  size_type first = t->claimed.fetch_add(kMigrateChunk);
+  if (first >= t->buckets) return;  // all chunks taken, owners finish them
+  size_type last = std::min(first + kMigrateChunk, t->buckets);
+  for (size_type i = first; i < last; i++) move_bucket(t, to, i);
+  if (t->moved.fetch_add(last - first) + (last - first) == t->buckets) {
+    current.store(to, std::memory_order_release);  // last chunk switches
+    epoch_domain::global().retire(t, destroy_table);
+  }
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_hash_map<Key, T, Hash, KeyEqual>::move_bucket(table *from,
+                                                              table *to,
+                                                              size_type i) {
+  // Nodes are copied, not relinked, so a reader still walking the old chain
+  // sees it whole. Only this bucket feeds its two target buckets, and
+  // nobody writes them before the moved tag below sends writers over.
+  bucket &b = from->slots[i];
+  b.lock();
+  node *chain = ptr(b.head.load(std::memory_order_relaxed));
+  for (node *nd = chain; nd;
+       nd = ptr(nd->next.load(std::memory_order_relaxed))) {
+    bucket &target = to->at(nd->hash);
+    node *head = ptr(target.head.load(std::memory_order_relaxed));
+    target.head.store(raw(new node(nd->value, nd->hash, head)),
+                      std::memory_order_release);
+  }
+  b.head.store(raw(chain) | kMoved, std::memory_order_release);
+  b.unlock();
+  while (chain) {
+    node *next = ptr(chain->next.load(std::memory_order_relaxed));
+    epoch_domain::global().retire(chain, destroy_node);
+    chain = next;
+  }
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_hash_map<Key, T, Hash, KeyEqual>::clear() {
+  table *t = current.load();
+  while (table *to = t->next.load()) {  // finish a pending grow first
+    epoch_domain::guard pin;
+    while (current.load() == t) help_grow();
+    t = to;
+  }
+  for (size_type i = 0; i < t->buckets; i++) {
+    node *nd = ptr(t->slots[i].head.load());
+    while (nd) {
+      node *next = ptr(nd->next.load());
+      delete nd;
+      nd = next;
+    }
+    t->slots[i].head.store(0);
+  }
+  map_size.store(0);
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_CONCURRENT_HASH_MAP_MY_CONCURRENT_HASH_MAP_H_
@@ -0,0 +1,389 @@
+#ifndef CONTAINERS_SRC_CONCURRENT_SKIPLIST_MY_CONCURRENT_SKIPLIST_H_
+#define CONTAINERS_SRC_CONCURRENT_SKIPLIST_MY_CONCURRENT_SKIPLIST_H_
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "../epoch/my_epoch.h"
+
+namespace my {
+
+// Lock-free ordered skip list (Herlihy/Shavit, Fraser). The low bit of a
+// next pointer marks its owner node as logically deleted; marked nodes are
+// snipped out by any traversal and freed through the epoch domain.
+template <typename T, typename T2>
+class concurrent_skiplist {
+ public:
+  static constexpr int kMaxLevel = 24;  // enough for ~16M elements per level
+
+  using value_type = std::pair<const T, T2>;
+  using size_type = size_t;
+
+ private:
+  typedef struct node {
+    value_type value;                // node key and value
+    int height;                      // number of levels the node is linked on
+    std::atomic<int> owners;         // inserter + deleter, last one retires
+    std::atomic<uintptr_t> *next;    // marked pointers to next nodes
+
+    node(const value_type &v, int h) : value(v), height(h), owners(2) {
+      next = new std::atomic<uintptr_t>[h];
+    }
+    ~node() { delete[] next; }
+  } node;
+
+  static node *ptr(uintptr_t p) {
+    return reinterpret_cast<node *>(p & ~uintptr_t(1));
+  }
+  static bool marked(uintptr_t p) { return p & 1; }
+  static uintptr_t raw(node *p) { return reinterpret_cast<uintptr_t>(p); }
+
+  std::atomic<uintptr_t> head[kMaxLevel];  // links of the head sentinel
+  std::atomic<long> list_size;  // may dip below zero while racing
+
+  bool find(const T &, std::atomic<uintptr_t> **, node **);  // snip and locate
+  node *first_not_less(const T &) const;  // first live node with key >= key
+  static node *skip_deleted(node *);      // first live node from nd on
+  void release(node *);                   // drop one owner of a node
+  static int random_level();
+  static void destroy(void *nd) { delete static_cast<node *>(nd); }
+
+ public:
+  concurrent_skiplist() : list_size(0) {
+    for (int i = 0; i < kMaxLevel; i++) head[i].store(0);
+  }
+  concurrent_skiplist(const concurrent_skiplist &) = delete;
+  concurrent_skiplist &operator=(const concurrent_skiplist &) = delete;
+  ~concurrent_skiplist() { clear(); }
+
+  //------------------ITERATOR------------------// weakly consistent iterator
+  class iterator {
+   private:
+    node *current_node;
+    epoch_domain::guard pin;  // keeps visited nodes alive, bound to a thread
+
+   public:
+    explicit iterator(node *nd = nullptr) : current_node(nd) {}
+    iterator(const iterator &other)
+        : current_node(other.current_node), pin(other.pin) {}
+    iterator &operator=(const iterator &other) {
+      current_node = other.current_node;
+      return *this;
+    }
+
+    const value_type &operator*() const { return current_node->value; }
+    const value_type *operator->() const { return &current_node->value; }
+    const T &cget() const { return current_node->value.first; }
+
+    iterator &operator++() {  //  move iterator to next live node
+      current_node = skip_deleted(ptr(current_node->next[0].load()));
+      return *this;
+    }
+
+    bool operator==(const iterator &other) const {
+      return current_node == other.current_node;
+    }
+    bool operator!=(const iterator &other) const {
+      return current_node != other.current_node;
+    }
+  };  // class iterator
+
+  std::pair<iterator, bool> insert(const value_type &);  // false if present
+  bool erase(const T &);            // false if the key was not present
+  bool contains(const T &);
+  iterator find(const T &);         // end() if the key is not present
+  iterator lower_bound(const T &);  // first key not less than key
+  iterator begin();
+  iterator end() { return iterator(); }
+
+  size_type size() const {
+    long n = list_size.load();
+    return n > 0 ? n : 0;
+  }
+  bool empty() const { return size() == 0; }
+  void clear();  // not thread safe, nodes are freed immediately
+};
+
+//------------------FUNCTIONS------------------//
+template <typename T, typename T2>
+int concurrent_skiplist<T, T2>::random_level() {
+  thread_local uint64_t state =
+      0x9E3779B97F4A7C15ull ^ reinterpret_cast<uintptr_t>(&state);
+  state ^= state << 13;  // xorshift64
+  state ^= state >> 7;
+  state ^= state << 17;
+  int level = 1;
+  uint64_t bits = state;
+  while ((bits & 3) == 0 && level < kMaxLevel) {  // p = 1/4 per level
+    ++level;
+    bits >>= 2;
+  }
+  return level;
+}
+
+template <typename T, typename T2>
+bool concurrent_skiplist<T, T2>::find(const T &key,
+                                      std::atomic<uintptr_t> **preds,
+                                      node **succs) {
+retry:
+  std::atomic<uintptr_t> *pred = head;
+  for (int level = kMaxLevel - 1; level >= 0; --level) {
+    node *curr = ptr(pred[level].load());
+    while (curr != nullptr) {
+      uintptr_t succ = curr->next[level].load();
+      while (marked(succ)) {  // curr is deleted, snip it out of this level
+        uintptr_t expected = raw(curr);
+        if (!pred[level].compare_exchange_strong(expected, raw(ptr(succ))))
+          goto retry;
+        curr = ptr(succ);
+        if (curr == nullptr) break;
+        succ = curr->next[level].load();
+      }
+      if (curr != nullptr && curr->value.first < key) {
+        pred = curr->next;
+        curr = ptr(succ);
+      } else {
+        break;
+      }
+    }
+    preds[level] = pred;
+    succs[level] = curr;
+  }
+  return succs[0] != nullptr && !(key < succs[0]->value.first);
+}
+
+template <typename T, typename T2>
+std::pair<typename concurrent_skiplist<T, T2>::iterator, bool>
+concurrent_skiplist<T, T2>::insert(const value_type &value) {
+  epoch_domain::guard pin;
+  std::atomic<uintptr_t> *preds[kMaxLevel];
+  node *succs[kMaxLevel];
+  int height = random_level();
+  node *new_node = nullptr;
+  while (true) {
+    if (find(value.first, preds, succs)) {
+      delete new_node;
+      return {iterator(succs[0]), false};
+    }
+    if (!new_node) new_node = new node(value, height);
+    for (int i = 0; i < height; i++) new_node->next[i].store(raw(succs[i]));
+    uintptr_t expected = raw(succs[0]);
+    if (preds[0][0].compare_exchange_strong(expected, raw(new_node))) break;
+  }
+  ++list_size;
+  iterator result(new_node);
+  bool linking = true;
+  for (int level = 1; linking && level < height; level++) {  // upper levels
+    while (true) {
+      uintptr_t old_next = new_node->next[level].load();
+      if (marked(old_next) ||
+          (ptr(old_next) != succs[level] &&
+           !new_node->next[level].compare_exchange_strong(
+               old_next, raw(succs[level])))) {
+        linking = false;  // a deleter has started on this node
+        break;
+      }
+      uintptr_t expected = raw(succs[level]);
+      if (preds[level][level].compare_exchange_strong(expected,
+                                                      raw(new_node)))
+        break;
+      find(value.first, preds, succs);
+      if (succs[0] != new_node) {  // already unlinked at level 0
+        linking = false;
+        break;
+      }
+    }
+  }
+  // a deleter may have finished before the upper links were made, so unlink
+  // the node again before giving up ownership of it
+  if (marked(new_node->next[0].load())) find(value.first, preds, succs);
+  release(new_node);
+  return {result, true};
+}
+
+template <typename T, typename T2>
+bool concurrent_skiplist<T, T2>::erase(const T &key) {
+  epoch_domain::guard pin;
+  std::atomic<uintptr_t> *preds[kMaxLevel];
+  node *succs[kMaxLevel];
+  if (!find(key, preds, succs)) return false;
+  node *victim = succs[0];
+  for (int level = victim->height - 1; level > 0; --level) {  // mark top down
+    uintptr_t succ = victim->next[level].load();
+    while (!marked(succ))
+      victim->next[level].compare_exchange_weak(succ, succ | 1);
+  }
+  uintptr_t succ = victim->next[0].load();
+  while (true) {
+    if (marked(succ)) return false;  // someone else deleted it
+    if (victim->next[0].compare_exchange_strong(succ, succ | 1)) break;
+  }
+  --list_size;
+  find(key, preds, succs);  // physically unlink from all levels
+  release(victim);
+  return true;
+}
+
+template <typename T, typename T2>
+void concurrent_skiplist<T, T2>::release(node *nd) {
+  if (nd->owners.fetch_sub(1) == 1)
+    epoch_domain::global().retire(nd, &concurrent_skiplist::destroy);
+}
+
+template <typename T, typename T2>
+typename concurrent_skiplist<T, T2>::node *
+concurrent_skiplist<T, T2>::skip_deleted(node *nd) {
+  while (nd != nullptr && marked(nd->next[0].load()))
+    nd = ptr(nd->next[0].load());
+  return nd;
+}
+
+template <typename T, typename T2>
+typename concurrent_skiplist<T, T2>::node *
+concurrent_skiplist<T, T2>::first_not_less(const T &key) const {
+  const std::atomic<uintptr_t> *pred = head;
+  node *curr = nullptr;
+  for (int level = kMaxLevel - 1; level >= 0; --level) {  // read only descent
+    curr = ptr(pred[level].load());
+    while (curr != nullptr && curr->value.first < key) {
+      pred = curr->next;
+      curr = ptr(curr->next[level].load());
+    }
+  }
+  return skip_deleted(curr);
+}
+
+template <typename T, typename T2>
+bool concurrent_skiplist<T, T2>::contains(const T &key) {
+  epoch_domain::guard pin;
+  node *nd = first_not_less(key);
+  return nd != nullptr && !(key < nd->value.first);
+}
+
+template <typename T, typename T2>
+typename concurrent_skiplist<T, T2>::iterator concurrent_skiplist<T, T2>::find(
+    const T &key) {
+  iterator it = lower_bound(key);
+  if (it != end() && key < it.cget()) return end();
+  return it;
+}
+
+template <typename T, typename T2>
+typename concurrent_skiplist<T, T2>::iterator
+concurrent_skiplist<T, T2>::lower_bound(const T &key) {
+  epoch_domain::guard pin;
+  return iterator(first_not_less(key));
+}
+
+template <typename T, typename T2>
+typename concurrent_skiplist<T, T2>::iterator
+concurrent_skiplist<T, T2>::begin() {
+  epoch_domain::guard pin;
+  return iterator(skip_deleted(ptr(head[0].load())));
+}
+
+template <typename T, typename T2>
+void concurrent_skiplist<T, T2>::clear() {
+  node *nd = ptr(head[0].load());
+  while (nd != nullptr) {
+    node *next = ptr(nd->next[0].load());
+    delete nd;
+    nd = next;
+  }
+  for (int i = 0; i < kMaxLevel; i++) head[i].store(0);
+  list_size.store(0);
+}
+
+//------------------SET------------------//
+template <typename Key>
+class concurrent_skiplist_set {
+ private:
+  using list_iterator = typename concurrent_skiplist<Key, Key>::iterator;
+  concurrent_skiplist<Key, Key> list;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+
+  class iterator : public list_iterator {  // dereferences to the key only
+   public:
+    iterator(const list_iterator &it) : list_iterator(it) {}
+    const Key &operator*() const { return this->cget(); }
+    const Key *operator->() const { return &this->cget(); }
+    iterator &operator++() {
+      list_iterator::operator++();
+      return *this;
+    }
+  };
+
+  concurrent_skiplist_set() {}
+  concurrent_skiplist_set(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item);
+  }
+
+  iterator begin() { return list.begin(); }
+  iterator end() { return list.end(); }
+
+  bool empty() const { return list.empty(); }
+  size_type size() const { return list.size(); }
+
+  void clear() { list.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    auto res = list.insert(std::make_pair(value, value));
+    return {iterator(res.first), res.second};
+  }
+  bool erase(const value_type &value) { return list.erase(value); }
+  bool contains(const Key &key) { return list.contains(key); }
+  iterator find(const Key &key) { return list.find(key); }
+  iterator lower_bound(const Key &key) { return list.lower_bound(key); }
+};
+
+//------------------MAP------------------//
+template <typename Key, typename T>
+class concurrent_skiplist_map {
+ private:
+  concurrent_skiplist<Key, T> list;
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = size_t;
+  using iterator = typename concurrent_skiplist<Key, T>::iterator;
+
+  concurrent_skiplist_map() {}
+  concurrent_skiplist_map(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item);
+  }
+
+  iterator begin() { return list.begin(); }
+  iterator end() { return list.end(); }
+
+  bool empty() const { return list.empty(); }
+  size_type size() const { return list.size(); }
+
+  void clear() { list.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return list.insert(value);
+  }
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return list.insert(value_type(key, obj));
+  }
+  bool erase(const Key &key) { return list.erase(key); }
+  bool contains(const Key &key) { return list.contains(key); }
+  iterator find(const Key &key) { return list.find(key); }
+  iterator lower_bound(const Key &key) { return list.lower_bound(key); }
+
+  T at(const Key &key) {  // copy of the value, the node may go away
+    iterator it = list.find(key);
+    if (it == end()) throw std::out_of_range("Key not found");
+    return it->second;
+  }
+};
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_CONCURRENT_SKIPLIST_MY_CONCURRENT_SKIPLIST_H_
@@ -0,0 +1,449 @@
+#ifndef CONTAINERS_SRC_DURABLE_MAP_MY_DURABLE_MAP_H_
+#define CONTAINERS_SRC_DURABLE_MAP_MY_DURABLE_MAP_H_
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../map/my_map.h"
+#include "../serial/my_serial.h"
+
+namespace my {
+
+namespace wal {
+
+// Write-ahead log record: u32 payload length, u32 crc32 of the payload,
+// payload = u8 op, key and, for inserts, value through serial::codec.
+// Recovery stops at the first short or corrupt record (a torn tail).
+
+enum op : uint8_t { kInsert = 1, kAssign = 2, kErase = 3 };
+
+constexpr uint32_t kMaxRecord = 1u << 30;  // larger lengths mean garbage
+
+inline uint32_t crc32(const char *data, size_t size) {
+  static uint32_t table[256] = {};
+  static bool ready = [] {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    return true;
+  }();
+  (void)ready;
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; i++)
+    crc = table[(crc ^ uint8_t(data[i])) & 0xFF] ^ (crc >> 8);
+  return crc ^ 0xFFFFFFFFu;
+}
+
+inline void write_all(int fd, const char *data, size_t size) {
+  while (size > 0) {
+    ssize_t done = ::write(fd, data, size);
+    if (done < 0) {
+      if (errno == EINTR) continue;
+      throw std::runtime_error(std::string("Log write failed: ") +
+                               std::strerror(errno));
+    }
+    data += done;
+    size -= done;
+  }
+}
+
+inline void sync_fd(int fd) {
+  if (::fsync(fd) != 0)
+    throw std::runtime_error(std::string("fsync failed: ") +
+                             std::strerror(errno));
+}
+
+}  // namespace wal
+
+// my::map whose changes are appended to a write-ahead log before they are
+// acknowledged, with the whole tree checkpointed every checkpoint_every
+// logged operations. Files in dir:
+//   snapshot     u64 generation followed by map::serialize output
+//   wal-<gen>    log of the changes made after that snapshot
+// Recovery loads the snapshot and replays its log. All members are thread
+// safe; with sync_policy::group concurrent writers share one fsync. A
+// change reaches the in-memory map only once its record is on disk, except
+// under sync_policy::manual. After a failed log write every further change
+// throws, since a torn record would hide later ones from recovery;
+// reopening the map recovers what was logged.
+template <typename Key, typename T>
+class durable_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using size_type = size_t;
+
+  enum class sync_policy {
+    every_op,  // write and fsync each record before returning
+    group,     // wait for a shared fsync that covers the record
+    manual     // records are buffered until sync() or a checkpoint
+  };
+
+  struct options {
+    sync_policy sync = sync_policy::group;
+    size_type checkpoint_every = 100000;  // logged ops, 0 disables
+  };
+
+  struct stats {
+    size_type logged;       // records appended since open
+    size_type syncs;        // fsync calls on the log
+    size_type checkpoints;  // snapshots written since open
+    bool failed;            // a log write or fsync failed, changes throw
+  };
+
+  explicit durable_map(const std::string &dir, options opts = options());
+  durable_map(const durable_map &) = delete;
+  durable_map &operator=(const durable_map &) = delete;
+  ~durable_map();
+
+  bool insert(const Key &key, const T &obj);            // false if present
+  bool insert_or_assign(const Key &key, const T &obj);  // true if inserted
+  bool erase(const Key &key);                           // false if missing
+
+  bool contains(const Key &key);
+  T at(const Key &key);  // copy, throws std::out_of_range if missing
+  size_type size();
+  bool empty() { return size() == 0; }
+
+  void sync();        // make every acknowledged change durable
+  void checkpoint();  // write a snapshot and start a new log
+  stats get_stats();
+
+ private:
+  std::string dir;
+  options opts;
+  map<Key, T> data;
+  std::mutex mutex;
+  std::condition_variable flushed;
+
+  int log_fd = -1;
+  uint64_t generation = 0;      // generation of the current snapshot/log
+  struct queued {  // a group commit record, applied once it is durable
+    wal::op type;
+    Key key;
+    T obj;
+  };
+
+  std::string pending;          // encoded records not yet written
+  vector<queued> pending_ops;   // group: the changes encoded in pending
+  vector<queued> flushing_ops;  // group: the batch a leader is writing
+  uint64_t appended_lsn = 0;    // records appended to pending
+  uint64_t durable_lsn = 0;     // records known to be on disk
+  bool flushing = false;        // a group commit leader is writing
+  size_type since_checkpoint = 0;
+  stats counters = {0, 0, 0, false};
+
+  std::string log_path(uint64_t gen) const {
+    return dir + "/wal-" + std::to_string(gen);
+  }
+  std::string snapshot_path() const { return dir + "/snapshot"; }
+
+  void recover();
+  void replay(const std::string &path);
+  void open_log();
+  void append(wal::op type, const Key &key, const T *obj,
+              std::unique_lock<std::mutex> &lock);
+  void wait_durable(uint64_t lsn, std::unique_lock<std::mutex> &lock);
+  void checkpoint_locked(std::unique_lock<std::mutex> &lock);
+  void apply(wal::op type, const Key &key, const T &obj);
+  bool present(const Key &key) const;  // counting queued changes
+  void check_log() const;
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename T>
+durable_map<Key, T>::durable_map(const std::string &path, options o)
+    : dir(path), opts(o) {
+  if (::mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+    throw std::runtime_error("Cannot create " + dir + ": " +
+                             std::strerror(errno));
+  recover();
+}
+
+template <typename Key, typename T>
+durable_map<Key, T>::~durable_map() {
+  try {
+    sync();
+  } catch (const std::runtime_error &) {
+    // the failing write was reported to its caller and in get_stats()
+  }
+  if (log_fd >= 0) ::close(log_fd);
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::recover() {
+  std::ifstream snapshot(snapshot_path(), std::ios::binary);
+  if (snapshot) {
+    snapshot.read(reinterpret_cast<char *>(&generation), sizeof(generation));
+    if (!snapshot) throw std::invalid_argument("Truncated snapshot");
+    data.deserialize(snapshot);
+  }
+  for (uint64_t gen = 0; gen < generation; gen++)  // logs older than it
+    std::remove(log_path(gen).c_str());
+  replay(log_path(generation));
+  open_log();
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::replay(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) return;
+  uint64_t good_end = 0;
+  std::string payload;
+  while (true) {
+    uint32_t header[2];
+    in.read(reinterpret_cast<char *>(header), sizeof(header));
+    if (!in || header[0] > wal::kMaxRecord) break;
+    payload.resize(header[0]);
+    in.read(&payload[0], header[0]);
+    if (!in || wal::crc32(payload.data(), payload.size()) != header[1]) break;
+    std::istringstream record(payload);
+    uint8_t type = 0;
+    Key key{};
+    T obj{};
+    record.read(reinterpret_cast<char *>(&type), 1);
+    serial::codec<Key>::read(record, key);
+    if (type != wal::kErase) serial::codec<T>::read(record, obj);
+    if (!record) break;
+    apply(wal::op(type), key, obj);
+    good_end += sizeof(header) + header[0];
+  }
+  if (::truncate(path.c_str(), good_end) != 0)  // drop a torn tail
+    throw std::runtime_error("Cannot truncate " + path);
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::open_log() {
+  log_fd = ::open(log_path(generation).c_str(),
+                  O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (log_fd < 0)
+    throw std::runtime_error("Cannot open " + log_path(generation) + ": " +
+                             std::strerror(errno));
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::apply(wal::op type, const Key &key, const T &obj) {
+  if (type == wal::kInsert) {
+    if (!data.contains(key)) data[key] = obj;
+  } else if (type == wal::kAssign) {
+    data[key] = obj;
+  } else if (type == wal::kErase) {
+    data.erase(key);
+  }
+}
+
+template <typename Key, typename T>
+bool durable_map<Key, T>::present(const Key &key) const {
+  auto same = [&key](const queued &q) { return !(q.key < key || key < q.key); };
+  for (const vector<queued> *ops : {&pending_ops, &flushing_ops})
+    for (size_type i = ops->size(); i-- > 0;)
+      if (same((*ops)[i])) return (*ops)[i].type != wal::kErase;
+  return data.contains(key);
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::check_log() const {
+  if (counters.failed)
+    throw std::runtime_error("Log write failed earlier, reopen to recover");
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::append(wal::op type, const Key &key, const T *obj,
+                                 std::unique_lock<std::mutex> &lock) {
+  std::ostringstream record;
+  uint8_t type_byte = type;
+  record.write(reinterpret_cast<const char *>(&type_byte), 1);
+  serial::codec<Key>::write(record, key);
+  if (obj) serial::codec<T>::write(record, *obj);
+  std::string payload = record.str();
+  uint32_t header[2] = {uint32_t(payload.size()),
+                        wal::crc32(payload.data(), payload.size())};
+  payload.insert(0, reinterpret_cast<const char *>(header), sizeof(header));
+  T no_obj{};
+  const T &value = obj ? *obj : no_obj;
+
+  uint64_t lsn;
+  if (opts.sync == sync_policy::every_op) {
+    try {
+      wal::write_all(log_fd, payload.data(), payload.size());
+      wal::sync_fd(log_fd);
+    } catch (...) {
+      counters.failed = true;
+      throw;
+    }
+    ++counters.syncs;
+    lsn = durable_lsn = ++appended_lsn;
+  } else {
+    pending.append(payload);
+    lsn = ++appended_lsn;
+  }
+  ++counters.logged;
+  ++since_checkpoint;
+  if (opts.sync == sync_policy::group) {  // the leader applies it on disk
+    pending_ops.push_back(queued{type, key, value});
+    wait_durable(lsn, lock);
+  } else {  // every_op: on disk already; manual: on disk at sync()
+    apply(type, key, value);
+  }
+  if (opts.checkpoint_every && since_checkpoint >= opts.checkpoint_every)
+    checkpoint_locked(lock);
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::wait_durable(uint64_t lsn,
+                                       std::unique_lock<std::mutex> &lock) {
+  while (durable_lsn < lsn) {
+    check_log();
+    if (flushing) {  // a leader is writing, our record goes in a later batch
+      flushed.wait(lock);
+      continue;
+    }
+    flushing = true;  // become the leader for everything pending right now
+    std::string batch;
+    batch.swap(pending);
+    flushing_ops.swap(pending_ops);
+    uint64_t batch_lsn = appended_lsn;
+    int fd = log_fd;
+    lock.unlock();
+    try {
+      wal::write_all(fd, batch.data(), batch.size());
+      wal::sync_fd(fd);
+    } catch (...) {
+      lock.lock();
+      counters.failed = true;
+      flushing_ops.clear();
+      flushing = false;
+      flushed.notify_all();
+      throw;
+    }
+    lock.lock();
+    for (size_type i = 0; i < flushing_ops.size(); i++)
+      apply(flushing_ops[i].type, flushing_ops[i].key, flushing_ops[i].obj);
+    flushing_ops.clear();
+    ++counters.syncs;
+    durable_lsn = batch_lsn;
+    flushing = false;
+    flushed.notify_all();
+  }
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::checkpoint_locked(
+    std::unique_lock<std::mutex> &lock) {
+  while (durable_lsn < appended_lsn || flushing) {  // log fd will change
+    if (flushing)
+      flushed.wait(lock);
+    else
+      wait_durable(appended_lsn, lock);
+  }
+
+  uint64_t next = generation + 1;
+  std::string tmp_path = snapshot_path() + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&next), sizeof(next));
+    data.serialize(out);
+    out.close();
+    if (!out) throw std::runtime_error("Cannot write " + tmp_path);
+  }
+  int fd = ::open(tmp_path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Cannot open " + tmp_path);
+  wal::sync_fd(fd);
+  ::close(fd);
+  if (std::rename(tmp_path.c_str(), snapshot_path().c_str()) != 0)
+    throw std::runtime_error("Cannot rename " + tmp_path);
+  int dir_fd = ::open(dir.c_str(), O_RDONLY);
+  if (dir_fd >= 0) {  // make the rename itself durable
+    ::fsync(dir_fd);
+    ::close(dir_fd);
+  }
+
+  ::close(log_fd);
+  std::remove(log_path(generation).c_str());
+  generation = next;
+  open_log();
+  since_checkpoint = 0;
+  ++counters.checkpoints;
+}
+
+template <typename Key, typename T>
+bool durable_map<Key, T>::insert(const Key &key, const T &obj) {
+  std::unique_lock<std::mutex> lock(mutex);
+  check_log();
+  if (present(key)) return false;
+  append(wal::kInsert, key, &obj, lock);
+  return true;
+}
+
+template <typename Key, typename T>
+bool durable_map<Key, T>::insert_or_assign(const Key &key, const T &obj) {
+  std::unique_lock<std::mutex> lock(mutex);
+  check_log();
+  bool inserted = !present(key);
+  append(wal::kAssign, key, &obj, lock);
+  return inserted;
+}
+
+template <typename Key, typename T>
+bool durable_map<Key, T>::erase(const Key &key) {
+  std::unique_lock<std::mutex> lock(mutex);
+  check_log();
+  if (!present(key)) return false;
+  append(wal::kErase, key, nullptr, lock);
+  return true;
+}
+
+template <typename Key, typename T>
+bool durable_map<Key, T>::contains(const Key &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  return data.contains(key);
+}
+
+template <typename Key, typename T>
+T durable_map<Key, T>::at(const Key &key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!data.contains(key)) throw std::out_of_range("Key not found");
+  return data[key];
+}
+
+template <typename Key, typename T>
+typename durable_map<Key, T>::size_type durable_map<Key, T>::size() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return data.size();
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::sync() {
+  std::unique_lock<std::mutex> lock(mutex);
+  wait_durable(appended_lsn, lock);
+}
+
+template <typename Key, typename T>
+void durable_map<Key, T>::checkpoint() {
+  std::unique_lock<std::mutex> lock(mutex);
+  checkpoint_locked(lock);
+}
+
+template <typename Key, typename T>
+typename durable_map<Key, T>::stats durable_map<Key, T>::get_stats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_DURABLE_MAP_MY_DURABLE_MAP_H_
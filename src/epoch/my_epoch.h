@@ -0,0 +1,164 @@
+#ifndef CONTAINERS_SRC_EPOCH_MY_EPOCH_H_
+#define CONTAINERS_SRC_EPOCH_MY_EPOCH_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace my {
+
+// Epoch based memory reclamation shared by the lock-free containers.
+// A thread pins the current epoch while it touches shared nodes; a node that
+// was unlinked (retired) in epoch e is freed once the global epoch reaches
+// e + 2, because by then no pinned thread can still hold a pointer to it.
+class epoch_domain {
+ public:
+  static constexpr size_t kMaxThreads = 256;  // max concurrently pinned threads
+  static constexpr size_t kCollectEvery = 64;  // retires between collects
+
+  using deleter = void (*)(void *);
+
+  epoch_domain(const epoch_domain &) = delete;
+  epoch_domain &operator=(const epoch_domain &) = delete;
+  ~epoch_domain() { free_all(orphans_); }
+
+  static epoch_domain &global() {  // the one domain shared by all containers
+    static epoch_domain domain;
+    return domain;
+  }
+
+  class guard;  // RAII pin of the current thread
+
+  void retire(void *ptr, deleter del);  // free ptr once no reader can see it
+  void collect();                       // try to advance and free old nodes
+
+ private:
+  static constexpr uint64_t kIdle = ~uint64_t(0);
+
+  struct retired {
+    void *ptr;
+    deleter del;
+    uint64_t epoch;  // global epoch at the time of retire
+  };
+
+  struct alignas(64) slot {
+    std::atomic<uint64_t> epoch{kIdle};  // pinned epoch or kIdle
+    std::atomic<bool> used{false};       // slot owned by a thread
+  };
+
+  epoch_domain() = default;
+
+  struct handle {  // per thread state, lives in a thread_local
+    epoch_domain *domain = nullptr;
+    slot *owned = nullptr;
+    size_t nesting = 0;
+    size_t since_collect = 0;
+    std::vector<retired> garbage;
+
+    ~handle() {
+      if (!domain) return;
+      if (!garbage.empty()) {
+        std::lock_guard<std::mutex> lock(domain->orphans_mutex_);
+        domain->orphans_.insert(domain->orphans_.end(), garbage.begin(),
+                                garbage.end());
+      }
+      owned->epoch.store(kIdle);
+      owned->used.store(false);
+    }
+  };
+
+  handle &local();                                 // handle of this thread
+  bool try_advance();                              // move global epoch on
+  void free_old(std::vector<retired> &, uint64_t);  // free retired <= epoch
+  static void free_all(std::vector<retired> &);
+
+  std::atomic<uint64_t> global_epoch_{2};
+  slot slots_[kMaxThreads];
+  std::mutex orphans_mutex_;
+  std::vector<retired> orphans_;  // garbage left by finished threads
+};
+
+class epoch_domain::guard {
+ public:
+  guard() : handle_(&epoch_domain::global().local()) {
+    if (handle_->nesting++ == 0) {
+      handle_->owned->epoch.store(handle_->domain->global_epoch_.load());
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+  guard(const guard &other) : handle_(other.handle_) { ++handle_->nesting; }
+  guard &operator=(const guard &) = delete;
+  ~guard() {
+    if (--handle_->nesting == 0) handle_->owned->epoch.store(kIdle);
+  }
+
+ private:
+  handle *handle_;
+};
+
+//------------------FUNCTIONS------------------//
+inline epoch_domain::handle &epoch_domain::local() {
+  thread_local handle h;
+  if (h.domain == nullptr) {  // first use on this thread, grab a free slot
+    for (size_t i = 0; i < kMaxThreads; i++) {
+      bool expected = false;
+      if (slots_[i].used.compare_exchange_strong(expected, true)) {
+        h.owned = &slots_[i];
+        h.domain = this;
+        return h;
+      }
+    }
+    throw std::out_of_range("Too many threads in epoch domain");
+  }
+  return h;
+}
+
+inline void epoch_domain::retire(void *ptr, deleter del) {
+  handle &h = local();
+  h.garbage.push_back({ptr, del, global_epoch_.load()});
+  if (++h.since_collect >= kCollectEvery) {
+    h.since_collect = 0;
+    collect();
+  }
+}
+
+inline void epoch_domain::collect() {
+  handle &h = local();
+  try_advance();
+  uint64_t safe = global_epoch_.load() - 2;
+  free_old(h.garbage, safe);
+  std::unique_lock<std::mutex> lock(orphans_mutex_, std::try_to_lock);
+  if (lock.owns_lock()) free_old(orphans_, safe);
+}
+
+inline bool epoch_domain::try_advance() {
+  uint64_t current = global_epoch_.load();
+  for (size_t i = 0; i < kMaxThreads; i++) {
+    uint64_t pinned = slots_[i].epoch.load();
+    if (pinned != kIdle && pinned != current) return false;
+  }
+  return global_epoch_.compare_exchange_strong(current, current + 1);
+}
+
+inline void epoch_domain::free_old(std::vector<retired> &list,
+                                   uint64_t safe) {
+  size_t kept = 0;
+  for (size_t i = 0; i < list.size(); i++) {
+    if (list[i].epoch <= safe)
+      list[i].del(list[i].ptr);
+    else
+      list[kept++] = list[i];
+  }
+  list.resize(kept);
+}
+
+inline void epoch_domain::free_all(std::vector<retired> &list) {
+  for (auto &item : list) item.del(item.ptr);
+  list.clear();
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_EPOCH_MY_EPOCH_H_
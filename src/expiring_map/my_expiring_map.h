@@ -0,0 +1,285 @@
+#ifndef CONTAINERS_SRC_EXPIRING_MAP_MY_EXPIRING_MAP_H_
+#define CONTAINERS_SRC_EXPIRING_MAP_MY_EXPIRING_MAP_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+#include "../hashtable/my_hashtable.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// Time of expiring_map is counted in ticks read from a clock function. The
+// default clock is steady_clock in milliseconds.
+using ticks = uint64_t;
+using tick_clock = std::function<ticks()>;
+
+inline ticks steady_millis() {
+  return ticks(std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+                   .count());
+}
+
+// A clock that moves only when told to, for tests and simulations. The
+// clock from source() reads this object, so it has to outlive the map.
+class manual_clock {
+ public:
+  explicit manual_clock(ticks start = 0) : time(start) {}
+  ticks now() const { return time; }
+  void advance(ticks by) { time += by; }
+  void set(ticks to) { time = to; }  // going back only delays expiry
+  tick_clock source() const {
+    return [this] { return time; };
+  }
+
+ private:
+  ticks time;
+};
+
+// Hash map whose entries expire ttl ticks after their last put. Deadlines
+// sit in a hierarchical timer wheel of 11 levels with 64 slots each. Level
+// L holds the entries due within the current span of 64^(L+1) ticks, in
+// the slot of their L-th base 64 digit. Arming, re-arming and cancelling
+// link or unlink an entry in O(1). When the span of a slot above level 0
+// starts, its entries cascade to lower levels; a level 0 slot expires.
+// Occupancy masks let the wheel jump over empty slots, so idle time is
+// free. Every operation turns the wheel by a bounded number of entry
+// moves, and an entry past its deadline reads as missing until reaped.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class expiring_map {
+ public:
+  using size_type = size_t;
+  static constexpr ticks kNever = std::numeric_limits<ticks>::max();
+  // entry moves per operation; an entry takes at most one per level and
+  // one to expire, so the wheel keeps pace with any stream of puts
+  static constexpr size_type kStepBudget = 16;
+
+  explicit expiring_map(ticks ttl, tick_clock clock = steady_millis);
+
+  void put(const Key &key, const Value &value) { put(key, value, lifetime); }
+  void put(const Key &key, const Value &value, ticks ttl);  // own lifetime
+  // The value or nullptr if missing or expired; a read does not extend the
+  // lifetime. The pointer is good until the next call on the map.
+  const Value *get(const Key &key);
+  bool erase(const Key &key);  // false if missing or already expired
+  bool contains(const Key &key) const { return expires_in(key) != 0; }
+  ticks expires_in(const Key &key) const;  // 0 if missing or expired
+
+  size_type expire();  // reaps every entry that is due, returns the count
+  size_type size() const { return index.size(); }  // with unreaped ones
+  bool empty() const { return index.empty(); }
+  size_type reaped() const { return reaped_total; }
+  ticks ttl() const { return lifetime; }
+  void clear();
+
+ private:
+  static constexpr int kLevels = 11;  // 6 bits each cover 64 bit ticks
+  static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+  struct entry {
+    Key key;
+    Value value;
+    ticks deadline;
+    uint32_t prev, next;  // in the slot list; next chains free entries
+    uint32_t slot;        // level * 64 + digit
+  };
+
+  vector<entry> entries;  // indices stay put, freed ones are reused
+  unordered_map<Key, uint32_t, Hash> index;
+  uint32_t heads[kLevels * 64];
+  uint64_t occupied[kLevels] = {};
+  uint32_t free_head = kNone;
+  ticks current;  // every tick before it is handled
+  ticks lifetime;
+  tick_clock clock;
+  size_type reaped_total = 0;
+
+  void arm(uint32_t i);
+  void unlink(uint32_t i);
+  void release(uint32_t i);
+  bool next_slot(int &level, ticks &at) const;
+  size_type turn(ticks now, size_type budget);  // returns expired entries
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Value, typename Hash>
+expiring_map<Key, Value, Hash>::expiring_map(ticks ttl, tick_clock clock)
+    : lifetime(ttl), clock(std::move(clock)) {
+  if (ttl == 0) throw std::invalid_argument("Expiring map ttl is 0");
+  for (uint32_t &head : heads) head = kNone;
+  current = this->clock();
+}
+
+template <typename Key, typename Value, typename Hash>
+void expiring_map<Key, Value, Hash>::put(const Key &key, const Value &value,
+                                         ticks ttl) {
+  ticks now = clock();
+  turn(now, kStepBudget);
+  ticks deadline = ttl > kNever - now ? kNever : now + ttl;
+  auto found = index.find(key);
+  if (found != index.end()) {  // re-arm
+    uint32_t i = found->second;
+    unlink(i);
+    entries[i].value = value;
+    entries[i].deadline = deadline;
+    arm(i);
+    return;
+  }
+  uint32_t i = free_head;
+  if (i != kNone) {
+    free_head = entries[i].next;
+    entries[i].key = key;
+    entries[i].value = value;
+    entries[i].deadline = deadline;
+  } else {
+    i = uint32_t(entries.size());
+    entries.push_back(entry{key, value, deadline, kNone, kNone, 0});
+  }
+  index.insert(key, i);
+  arm(i);
+}
+
+template <typename Key, typename Value, typename Hash>
+const Value *expiring_map<Key, Value, Hash>::get(const Key &key) {
+  ticks now = clock();
+  turn(now, kStepBudget);
+  auto found = index.find(key);
+  if (found == index.end()) return nullptr;
+  uint32_t i = found->second;
+  if (entries[i].deadline <= now) {  // due, reap it on the spot
+    unlink(i);
+    release(i);
+    ++reaped_total;
+    return nullptr;
+  }
+  return &entries[i].value;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool expiring_map<Key, Value, Hash>::erase(const Key &key) {
+  ticks now = clock();
+  turn(now, kStepBudget);
+  auto found = index.find(key);
+  if (found == index.end()) return false;
+  uint32_t i = found->second;
+  bool live = entries[i].deadline > now;
+  unlink(i);
+  release(i);
+  return live;
+}
+
+template <typename Key, typename Value, typename Hash>
+ticks expiring_map<Key, Value, Hash>::expires_in(const Key &key) const {
+  auto found = index.find(key);
+  if (found == index.end()) return 0;
+  ticks now = clock(), deadline = entries[found->second].deadline;
+  return deadline > now ? deadline - now : 0;
+}
+
+template <typename Key, typename Value, typename Hash>
+typename expiring_map<Key, Value, Hash>::size_type
+expiring_map<Key, Value, Hash>::expire() {
+  return turn(clock(), std::numeric_limits<size_type>::max());
+}
+
+template <typename Key, typename Value, typename Hash>
+void expiring_map<Key, Value, Hash>::clear() {
+  entries.clear();
+  index.clear();
+  for (uint32_t &head : heads) head = kNone;
+  for (uint64_t &mask : occupied) mask = 0;
+  free_head = kNone;
+}
+
+template <typename Key, typename Value, typename Hash>
+void expiring_map<Key, Value, Hash>::arm(uint32_t i) {
+  entry &e = entries[i];
+  ticks at = e.deadline > current ? e.deadline : current;
+  ticks diff = at ^ current;  // the highest differing digit is the level
+  int level = diff < 64 ? 0 : (63 - __builtin_clzll(diff)) / 6;
+  int digit = int((at >> (6 * level)) & 63);
+  e.slot = uint32_t(level * 64 + digit);
+  e.prev = kNone;
+  e.next = heads[e.slot];
+  if (e.next != kNone) entries[e.next].prev = i;
+  heads[e.slot] = i;
+  occupied[level] |= uint64_t(1) << digit;
+}
+
+template <typename Key, typename Value, typename Hash>
+void expiring_map<Key, Value, Hash>::unlink(uint32_t i) {
+  entry &e = entries[i];
+  if (e.prev != kNone)
+    entries[e.prev].next = e.next;
+  else
+    heads[e.slot] = e.next;
+  if (e.next != kNone) entries[e.next].prev = e.prev;
+  if (heads[e.slot] == kNone)
+    occupied[e.slot / 64] &= ~(uint64_t(1) << (e.slot & 63));
+}
+
+template <typename Key, typename Value, typename Hash>
+void expiring_map<Key, Value, Hash>::release(uint32_t i) {
+  entry &e = entries[i];
+  index.erase(e.key);
+  e.key = Key();  // let go of what the key and value hold
+  e.value = Value();
+  e.next = free_head;
+  free_head = i;
+}
+
+// The earliest tick at which an occupied slot needs handling: the tick of
+// a level 0 slot, the start of the span of a higher one. Slots below the
+// digit of current are empty, except one left half cascaded by a turn
+// that ran out of budget, which is due at once.
+template <typename Key, typename Value, typename Hash>
+bool expiring_map<Key, Value, Hash>::next_slot(int &level, ticks &at) const {
+  bool found = false;
+  for (int l = 0; l < kLevels; l++) {
+    int shift = 6 * l;
+    int digit = int((current >> shift) & 63);
+    uint64_t ahead = occupied[l] >> digit;
+    if (!ahead) continue;
+    ticks base = l + 1 < kLevels ? current >> (shift + 6) << (shift + 6) : 0;
+    ticks when = base + (ticks(digit + __builtin_ctzll(ahead)) << shift);
+    if (when < current) when = current;
+    if (!found || when < at) {
+      found = true;
+      level = l;
+      at = when;
+    }
+  }
+  return found;
+}
+
+template <typename Key, typename Value, typename Hash>
+typename expiring_map<Key, Value, Hash>::size_type
+expiring_map<Key, Value, Hash>::turn(ticks now, size_type budget) {
+  size_type expired = 0;
+  int level = 0;
+  ticks at = 0;
+  for (; budget > 0 && current <= now; --budget) {
+    if (!next_slot(level, at) || at > now) {  // nothing due up to now
+      current = now + 1;
+      break;
+    }
+    current = at;
+    uint32_t i = heads[level * 64 + ((current >> (6 * level)) & 63)];
+    unlink(i);
+    if (level == 0) {
+      release(i);
+      ++expired;
+    } else {
+      arm(i);  // lands on a lower level
+    }
+  }
+  reaped_total += expired;
+  return expired;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_EXPIRING_MAP_MY_EXPIRING_MAP_H_
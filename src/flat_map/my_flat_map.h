@@ -0,0 +1,531 @@
+#ifndef CONTAINERS_SRC_FLAT_MAP_MY_FLAT_MAP_H_
+#define CONTAINERS_SRC_FLAT_MAP_MY_FLAT_MAP_H_
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../sorted_ops/my_sorted_ops.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// map, set and multiset on sorted my::vectors, for up to some thousands
+// of entries that are read far more than written. Keys sit in one array
+// and values in another, so a search touches keys only, and it is a
+// branchless binary search: the halving step is a conditional move, not
+// a jump the predictor has to guess. A single insert or erase shifts the
+// tail of the arrays; insert_many sorts the batch, appends it and merges
+// it in place from the back, so only the tail behind its least key moves,
+// once. Any change invalidates iterators.
+
+namespace flat_detail {
+
+// first index whose key is not below key (Upper: is above key)
+template <bool Upper, typename Key, typename Compare>
+size_t search(const Key *keys, size_t n, const Key &key, Compare comp) {
+  if (n == 0) return 0;
+  const Key *base = keys;
+  while (n > 1) {
+    size_t half = n / 2;
+    bool right = Upper ? !comp(key, base[half]) : comp(base[half], key);
+    base = right ? base + half : base;
+    n -= half;
+  }
+  bool past = Upper ? !comp(key, *base) : comp(*base, key);
+  return size_t(base - keys) + past;
+}
+
+// positions of batch in key order, equal keys in batch order
+template <typename Key, typename Compare>
+vector<size_t> sorted_order(const vector<Key> &batch, Compare comp) {
+  vector<size_t> order(batch.size());
+  for (size_t i = 0; i < order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [&batch, &comp](size_t x, size_t y) {
+                     return comp(batch[x], batch[y]);
+                   });
+  return order;
+}
+
+}  // namespace flat_detail
+
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using reference = std::pair<const Key &, T &>;
+  using size_type = size_t;
+
+  //------------------ITERATOR------------------//
+  class iterator {
+   public:
+    iterator(const flat_map *map = nullptr, size_type pos = 0)
+        : owner(map), current(pos) {}
+    const Key &cget() const { return owner->keys[current]; }
+    T &value() const { return owner->values[current]; }
+    reference operator*() const { return reference(cget(), value()); }
+    struct arrow {  // it->first, it->second on a pair made on the fly
+      reference item;
+      const reference *operator->() const { return &item; }
+    };
+    arrow operator->() const { return arrow{**this}; }
+
+    iterator &operator++() {
+      ++current;
+      return *this;
+    }
+    iterator &operator--() {  // from end() to the last element
+      --current;
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return current == other.current;
+    }
+    bool operator!=(const iterator &other) const {
+      return current != other.current;
+    }
+
+   private:
+    const flat_map *owner;
+    size_type current;
+    friend class flat_map;
+  };  // class iterator
+
+  flat_map() {}
+  explicit flat_map(const Compare &order) : comp(order) {}
+  flat_map(std::initializer_list<value_type> const &items) {
+    vector<Key> batch_keys;
+    vector<T> batch_values;
+    for (const auto &item : items) {
+      batch_keys.push_back(item.first);
+      batch_values.push_back(item.second);
+    }
+    add_batch(batch_keys, batch_values);
+  }
+  flat_map(const flat_map &other)
+      : keys(other.keys), values(other.values), comp(other.comp) {}
+  flat_map(flat_map &&other) noexcept = default;
+  flat_map &operator=(const flat_map &other) {
+    if (this != &other) {
+      flat_map tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+  flat_map &operator=(flat_map &&other) = default;
+
+  T &at(const Key &key) { return values[index_of(key)]; }
+  const T &at(const Key &key) const { return values[index_of(key)]; }
+  T &operator[](const Key &key) { return insert(key, T()).first.value(); }
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, size()); }
+
+  bool empty() const { return keys.empty(); }
+  size_type size() const { return keys.size(); }
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / (sizeof(Key) + sizeof(T));
+  }
+  size_type memory_usage() const {
+    return sizeof(*this) + keys.capacity() * sizeof(Key) +
+           values.capacity() * sizeof(T);
+  }
+  void reserve(size_type n) {
+    keys.reserve(n);
+    values.reserve(n);
+  }
+
+  void clear() {
+    keys.clear();
+    values.clear();
+  }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return insert(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    size_type i = lower(key);
+    if (i < size() && !comp(key, keys[i])) return {iterator(this, i), false};
+    keys.insert(keys.begin() + i, key);
+    values.insert(values.begin() + i, obj);
+    return {iterator(this, i), true};
+  }
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    auto res = insert(key, obj);
+    if (!res.second) res.first.value() = obj;
+    return res;
+  }
+  void erase(iterator it) {
+    keys.erase(keys.begin() + it.current);
+    values.erase(values.begin() + it.current);
+  }
+  bool erase(const Key &key) {
+    iterator it = find(key);
+    if (it == end()) return false;
+    erase(it);
+    return true;
+  }
+  void merge(flat_map &other) {  // values of other win on equal keys
+    vector<Key> merged_keys;
+    vector<T> merged_values;
+    merged_keys.reserve(size() + other.size());
+    merged_values.reserve(size() + other.size());
+    size_type i = 0, j = 0;
+    while (i < size() || j < other.size()) {
+      if (j == other.size() || (i < size() && comp(keys[i], other.keys[j]))) {
+        merged_keys.push_back(keys[i]);
+        merged_values.push_back(values[i++]);
+      } else {
+        if (i < size() && !comp(other.keys[j], keys[i])) i++;  // replaced
+        merged_keys.push_back(other.keys[j]);
+        merged_values.push_back(other.values[j++]);
+      }
+    }
+    keys = std::move(merged_keys);
+    values = std::move(merged_values);
+  }
+
+  iterator find(const Key &key) const {
+    size_type i = lower(key);
+    return i < size() && !comp(key, keys[i]) ? iterator(this, i) : end();
+  }
+  bool contains(const Key &key) const { return find(key) != end(); }
+  size_type count(const Key &key) const { return contains(key); }
+  iterator lower_bound(const Key &key) const {
+    return iterator(this, lower(key));
+  }
+  iterator upper_bound(const Key &key) const {
+    return iterator(this, flat_detail::search<true>(keys.data(), size(),
+                                                      key, comp));
+  }
+  Compare key_comp() const { return comp; }
+
+  // one sorted merge for the whole batch; the first of equal keys wins
+  // and existing keys keep their values, as with one insert each
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<Key> batch_keys;
+    vector<T> batch_values;
+    batch_keys.reserve(sizeof...(args));
+    batch_values.reserve(sizeof...(args));
+    ((batch_keys.push_back(args.first), batch_values.push_back(args.second)),
+     ...);
+    vector<bool> fresh = add_batch(batch_keys, batch_values);
+    vector<std::pair<iterator, bool>> out;
+    out.reserve(sizeof...(args));
+    for (size_type k = 0; k < batch_keys.size(); k++)
+      out.push_back({find(batch_keys[k]), fresh[k]});
+    return out;
+  }
+
+ private:
+  vector<Key> keys;  // sorted
+  vector<T> values;  // values[i] belongs to keys[i]
+  Compare comp;
+
+  size_type lower(const Key &key) const {
+    return flat_detail::search<false>(keys.data(), size(), key, comp);
+  }
+  size_type index_of(const Key &key) const {
+    size_type i = lower(key);
+    if (i == size() || comp(key, keys[i]))
+      throw std::out_of_range("Key not found");
+    return i;
+  }
+  vector<bool> add_batch(const vector<Key> &batch_keys,
+                         const vector<T> &batch_values);
+};
+
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+  using iterator = const Key *;
+
+  flat_set() {}
+  explicit flat_set(const Compare &order) : comp(order) {}
+  flat_set(std::initializer_list<value_type> const &items) {
+    vector<Key> batch;
+    for (const auto &item : items) batch.push_back(item);
+    add_batch(batch);
+  }
+  flat_set(const flat_set &other) : keys(other.keys), comp(other.comp) {}
+  flat_set(flat_set &&other) noexcept = default;
+  flat_set &operator=(const flat_set &other) {
+    if (this != &other) {
+      flat_set tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+  flat_set &operator=(flat_set &&other) = default;
+
+  iterator begin() const { return keys.data(); }
+  iterator end() const { return keys.data() + keys.size(); }
+
+  bool empty() const { return keys.empty(); }
+  size_type size() const { return keys.size(); }
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(Key);
+  }
+  size_type memory_usage() const {
+    return sizeof(*this) + keys.capacity() * sizeof(Key);
+  }
+  void reserve(size_type n) { keys.reserve(n); }
+
+  void clear() { keys.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    size_type i = lower(value);
+    if (i < size() && !comp(value, keys[i])) return {begin() + i, false};
+    keys.insert(keys.begin() + i, value);
+    return {begin() + i, true};
+  }
+  bool erase(const value_type &value) {
+    iterator it = find(value);
+    if (it == end()) return false;
+    erase(it);
+    return true;
+  }
+  iterator erase(iterator it) {  // the next element, now at it
+    size_type i = size_type(it - begin());
+    keys.erase(keys.begin() + i);
+    return begin() + i;
+  }
+  void merge(flat_set &other) {
+    keys = sorted_union(keys, other.keys, comp);
+  }
+
+  iterator find(const Key &key) const {
+    size_type i = lower(key);
+    return i < size() && !comp(key, keys[i]) ? begin() + i : end();
+  }
+  bool contains(const Key &key) const { return find(key) != end(); }
+  size_type count(const Key &key) const { return contains(key); }
+  iterator lower_bound(const Key &key) const { return begin() + lower(key); }
+  iterator upper_bound(const Key &key) const {
+    return begin() +
+           flat_detail::search<true>(keys.data(), size(), key, comp);
+  }
+  Compare key_comp() const { return comp; }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<Key> batch;
+    batch.reserve(sizeof...(args));
+    (batch.push_back(args), ...);
+    vector<bool> fresh = add_batch(batch);
+    vector<std::pair<iterator, bool>> out;
+    out.reserve(sizeof...(args));
+    for (size_type k = 0; k < batch.size(); k++)
+      out.push_back({find(batch[k]), fresh[k]});
+    return out;
+  }
+
+ private:
+  vector<Key> keys;  // sorted
+  Compare comp;
+
+  size_type lower(const Key &key) const {
+    return flat_detail::search<false>(keys.data(), size(), key, comp);
+  }
+  vector<bool> add_batch(const vector<Key> &batch);
+};
+
+template <typename Key, typename Compare = std::less<Key>>
+class flat_multiset {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+  using iterator = const Key *;
+
+  flat_multiset() {}
+  explicit flat_multiset(const Compare &order) : comp(order) {}
+  flat_multiset(std::initializer_list<value_type> const &items) {
+    vector<Key> batch;
+    for (const auto &item : items) batch.push_back(item);
+    add_batch(batch);
+  }
+  flat_multiset(const flat_multiset &other)
+      : keys(other.keys), comp(other.comp) {}
+  flat_multiset(flat_multiset &&other) noexcept = default;
+  flat_multiset &operator=(const flat_multiset &other) {
+    if (this != &other) {
+      flat_multiset tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+  flat_multiset &operator=(flat_multiset &&other) = default;
+
+  iterator begin() const { return keys.data(); }
+  iterator end() const { return keys.data() + keys.size(); }
+
+  bool empty() const { return keys.empty(); }
+  size_type size() const { return keys.size(); }
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(Key);
+  }
+  size_type memory_usage() const {
+    return sizeof(*this) + keys.capacity() * sizeof(Key);
+  }
+  void reserve(size_type n) { keys.reserve(n); }
+
+  void clear() { keys.clear(); }
+  iterator insert(const value_type &value) {  // to the first of its equals
+    size_type i = lower(value);
+    keys.insert(keys.begin() + i, value);
+    return begin() + i;
+  }
+  void add(const value_type &value) { insert(value); }
+  bool erase(const value_type &value) {  // one of the equal elements
+    iterator it = find(value);
+    if (it == end()) return false;
+    erase(it);
+    return true;
+  }
+  iterator erase(iterator it) {  // the next element, now at it
+    size_type i = size_type(it - begin());
+    keys.erase(keys.begin() + i);
+    return begin() + i;
+  }
+  void merge(flat_multiset &other) {
+    vector<Key> merged(size() + other.size());
+    std::merge(keys.begin(), keys.end(), other.keys.begin(), other.keys.end(),
+               merged.begin(), comp);
+    keys = std::move(merged);
+  }
+
+  iterator find(const Key &key) const {
+    size_type i = lower(key);
+    return i < size() && !comp(key, keys[i]) ? begin() + i : end();
+  }
+  bool contains(const Key &key) const { return find(key) != end(); }
+  size_type count(const Key &key) const { return upper(key) - lower(key); }
+  std::pair<iterator, iterator> equal_range(const Key &key) const {
+    return {lower_bound(key), upper_bound(key)};
+  }
+  iterator lower_bound(const Key &key) const { return begin() + lower(key); }
+  iterator upper_bound(const Key &key) const { return begin() + upper(key); }
+  Compare key_comp() const { return comp; }
+
+  const Key &select(size_type k) const {  // k-th smallest, from 0
+    if (k >= size()) throw std::out_of_range("Rank out of range");
+    return keys[k];
+  }
+  size_type rank(const Key &key) const { return lower(key); }  // below key
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<Key> batch;
+    batch.reserve(sizeof...(args));
+    (batch.push_back(args), ...);
+    add_batch(batch);
+    vector<std::pair<iterator, bool>> out;
+    out.reserve(sizeof...(args));
+    for (size_type k = 0; k < batch.size(); k++)
+      out.push_back({lower_bound(batch[k]), true});
+    return out;
+  }
+
+ private:
+  vector<Key> keys;  // sorted, equal keys side by side
+  Compare comp;
+
+  size_type lower(const Key &key) const {
+    return flat_detail::search<false>(keys.data(), size(), key, comp);
+  }
+  size_type upper(const Key &key) const {
+    return flat_detail::search<true>(keys.data(), size(), key, comp);
+  }
+  void add_batch(const vector<Key> &batch);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename T, typename Compare>
+vector<bool> flat_map<Key, T, Compare>::add_batch(
+    const vector<Key> &batch_keys, const vector<T> &batch_values) {
+  vector<size_t> order = flat_detail::sorted_order(batch_keys, comp);
+  vector<bool> fresh(batch_keys.size());
+  vector<size_t> picked;  // batch positions of the new keys, in key order
+  for (size_type k = 0; k < order.size(); k++) {
+    const Key &key = batch_keys[order[k]];
+    if (k > 0 && !comp(batch_keys[order[k - 1]], key)) continue;  // repeat
+    size_type i = lower(key);
+    if (i < size() && !comp(key, keys[i])) continue;  // kept as it is
+    fresh[order[k]] = true;
+    picked.push_back(order[k]);
+  }
+  size_type i = size(), w = size() + picked.size(), k = picked.size();
+  for (size_t p : picked) {  // room at the back, filled from there down
+    keys.push_back(batch_keys[p]);
+    values.push_back(batch_values[p]);
+  }
+  while (k > 0) {  // each stretch of old keys moves once, as a block
+    const Key &key = batch_keys[picked[--k]];
+    size_type at = flat_detail::search<true>(keys.data(), i, key, comp);
+    std::move_backward(keys.begin() + at, keys.begin() + i,
+                       keys.begin() + w);
+    std::move_backward(values.begin() + at, values.begin() + i,
+                       values.begin() + w);
+    w -= i - at + 1;
+    i = at;
+    keys[w] = key;
+    values[w] = batch_values[picked[k]];
+  }
+  return fresh;
+}
+
+template <typename Key, typename Compare>
+vector<bool> flat_set<Key, Compare>::add_batch(const vector<Key> &batch) {
+  vector<size_t> order = flat_detail::sorted_order(batch, comp);
+  vector<bool> fresh(batch.size());
+  vector<Key> sorted;  // the new keys, in order
+  for (size_type k = 0; k < order.size(); k++) {
+    const Key &key = batch[order[k]];
+    if (!sorted.empty() && !comp(sorted.back(), key)) continue;  // repeat
+    if (contains(key)) continue;
+    fresh[order[k]] = true;
+    sorted.push_back(key);
+  }
+  size_type i = size(), w = size() + sorted.size(), k = sorted.size();
+  for (const Key &key : sorted) keys.push_back(key);
+  while (k > 0) {  // each stretch of old keys moves once, as a block
+    const Key &key = sorted[--k];
+    size_type at = flat_detail::search<true>(keys.data(), i, key, comp);
+    std::move_backward(keys.begin() + at, keys.begin() + i,
+                       keys.begin() + w);
+    w -= i - at + 1;
+    i = at;
+    keys[w] = key;
+  }
+  return fresh;
+}
+
+template <typename Key, typename Compare>
+void flat_multiset<Key, Compare>::add_batch(const vector<Key> &batch) {
+  vector<Key> sorted(batch);
+  std::stable_sort(sorted.begin(), sorted.end(), comp);
+  size_type i = size(), w = size() + sorted.size(), k = sorted.size();
+  for (const Key &key : sorted) keys.push_back(key);
+  while (k > 0) {  // existing keys stay ahead of equal new ones
+    const Key &key = sorted[--k];
+    size_type at = flat_detail::search<true>(keys.data(), i, key, comp);
+    std::move_backward(keys.begin() + at, keys.begin() + i,
+                       keys.begin() + w);
+    w -= i - at + 1;
+    i = at;
+    keys[w] = key;
+  }
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_FLAT_MAP_MY_FLAT_MAP_H_
@@ -0,0 +1,243 @@
+#ifndef CONTAINERS_SRC_FROZEN_MAP_MY_FROZEN_MAP_H_
+#define CONTAINERS_SRC_FROZEN_MAP_MY_FROZEN_MAP_H_
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace my {
+namespace frozen {
+
+// Perfect hashing of a key set known at compile time, after the CHD
+// (compress, hash and displace) scheme. One seeded hash h of the key picks
+// a bucket; the bucket either names its slot directly or holds a
+// displacement d, and the slot is mix(h + d) then. The string is hashed
+// once, everything after that is integer arithmetic and one key compare.
+
+constexpr uint64_t mix(uint64_t h) {  // splitmix64 finalizer
+  h ^= h >> 30;
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  return h ^ (h >> 31);
+}
+
+template <typename Key, typename = void>
+struct hash;  // constexpr seeded hash, specialize for other key types
+
+template <typename Key>
+struct hash<Key, typename std::enable_if<std::is_integral<Key>::value ||
+                                         std::is_enum<Key>::value>::type> {
+  constexpr uint64_t operator()(Key key, uint64_t seed) const {
+    return mix(uint64_t(key) ^ seed);
+  }
+};
+
+template <>
+struct hash<std::string_view> {  // FNV-1a
+  constexpr uint64_t operator()(std::string_view key, uint64_t seed) const {
+    uint64_t h = 0xCBF29CE484222325ull ^ seed;
+    for (char c : key) {
+      h ^= uint8_t(c);
+      h *= 0x100000001B3ull;
+    }
+    return h;
+  }
+};
+
+constexpr size_t table_size(size_t count) {  // power of two >= count
+  size_t slots = 1;
+  while (slots < count) slots *= 2;
+  return slots;
+}
+
+template <typename Key, size_t N, typename Hash>
+class perfect_hash {
+ public:
+  static constexpr size_t kSlots = table_size(N);
+  static constexpr uint64_t kMaxSeeds = 64;
+  static constexpr uint64_t kMaxDisplace = 1 << 16;
+
+  constexpr explicit perfect_hash(const std::array<Key, N> &keys);
+
+  constexpr size_t index_of(const Key &key) const {  // only candidate item
+    uint64_t h = Hash()(key, seed);
+    int64_t d = displace[h & (kSlots - 1)];
+    return item[d < 0 ? size_t(-d - 1) : slot_of(h, d)];
+  }
+
+ private:
+  uint64_t seed = 0;
+  int64_t displace[kSlots] = {};  // per bucket, -1 - slot if placed directly
+  size_t item[kSlots] = {};       // slot to index of the key
+
+  static constexpr size_t slot_of(uint64_t h, int64_t d) {
+    return mix(h + uint64_t(d) * 0x9E3779B97F4A7C15ull) & (kSlots - 1);
+  }
+  constexpr bool try_seed(const std::array<Key, N> &keys);
+};
+
+template <typename Key, size_t N, typename Hash>
+constexpr perfect_hash<Key, N, Hash>::perfect_hash(
+    const std::array<Key, N> &keys) {
+  for (size_t i = 0; i < N; i++)
+    for (size_t j = i + 1; j < N; j++)
+      if (keys[i] == keys[j]) throw std::invalid_argument("Duplicate key");
+  for (seed = 0; seed < kMaxSeeds; seed++)
+    if (try_seed(keys)) return;
+  throw std::logic_error("No perfect hash found");
+}
+
+template <typename Key, size_t N, typename Hash>
+constexpr bool perfect_hash<Key, N, Hash>::try_seed(
+    const std::array<Key, N> &keys) {
+  uint64_t hashes[N] = {};
+  size_t sizes[kSlots] = {}, order[kSlots] = {}, slots[N] = {};
+  bool used[kSlots] = {};
+  for (size_t i = 0; i < N; i++) {
+    hashes[i] = Hash()(keys[i], seed);
+    sizes[hashes[i] & (kSlots - 1)]++;
+  }
+  for (size_t b = 0; b < kSlots; b++) {  // biggest buckets first
+    size_t j = b;
+    for (; j > 0 && sizes[order[j - 1]] < sizes[b]; j--)
+      order[j] = order[j - 1];
+    order[j] = b;
+  }
+
+  size_t next_free = 0;
+  for (size_t k = 0; k < kSlots && sizes[order[k]] > 0; k++) {
+    size_t b = order[k];
+    if (sizes[b] == 1) {  // a lone key takes any free slot directly
+      while (used[next_free]) next_free++;
+      for (size_t i = 0; i < N; i++) {
+        if ((hashes[i] & (kSlots - 1)) != b) continue;
+        displace[b] = -int64_t(next_free) - 1;
+        item[next_free] = i;
+        used[next_free] = true;
+      }
+      continue;
+    }
+    int64_t d = 0;
+    for (; d < int64_t(kMaxDisplace); d++) {  // all keys of b must fit
+      size_t placed = 0;
+      for (size_t i = 0; i < N; i++) {
+        if ((hashes[i] & (kSlots - 1)) != b) continue;
+        size_t slot = slot_of(hashes[i], d);
+        if (used[slot]) break;
+        used[slot] = true;
+        slots[placed++] = slot;
+        item[slot] = i;
+      }
+      if (placed == sizes[b]) break;
+      for (size_t p = 0; p < placed; p++) used[slots[p]] = false;
+    }
+    if (d == int64_t(kMaxDisplace)) return false;
+    displace[b] = d;
+  }
+  return true;
+}
+
+template <typename Key, typename T, size_t N, size_t... I>
+constexpr std::array<Key, N> keys_of(const std::pair<Key, T> (&list)[N],
+                                     std::index_sequence<I...>) {
+  return {{list[I].first...}};
+}
+
+}  // namespace frozen
+
+// Read only map over a key set fixed at compile time. Everything, the
+// perfect hash included, is built by the compiler, so a constexpr
+// frozen_map costs nothing at startup and never allocates.
+//   constexpr auto commands = my::make_frozen_map<std::string_view, int>(
+//       {{"get", 1}, {"put", 2}, {"del", 3}});
+template <typename Key, typename T, size_t N,
+          typename Hash = frozen::hash<Key>>
+class frozen_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<Key, T>;
+  using size_type = size_t;
+  using iterator = const value_type *;  // in the order of the list
+
+  constexpr explicit frozen_map(const value_type (&list)[N])
+      : frozen_map(list, std::make_index_sequence<N>()) {}
+
+  constexpr iterator begin() const { return items.data(); }
+  constexpr iterator end() const { return items.data() + N; }
+  constexpr bool empty() const { return N == 0; }
+  constexpr size_type size() const { return N; }
+
+  constexpr iterator find(const Key &key) const {
+    const value_type &item = items[index.index_of(key)];
+    return item.first == key ? &item : end();
+  }
+  constexpr bool contains(const Key &key) const { return find(key) != end(); }
+  constexpr size_type count(const Key &key) const { return contains(key); }
+  constexpr const T &at(const Key &key) const {
+    iterator it = find(key);
+    if (it == end()) throw std::out_of_range("Key not found");
+    return it->second;
+  }
+  constexpr const T &operator[](const Key &key) const { return at(key); }
+
+ private:
+  std::array<value_type, N> items;
+  frozen::perfect_hash<Key, N, Hash> index;
+
+  template <size_t... I>
+  constexpr frozen_map(const value_type (&list)[N],
+                       std::index_sequence<I...> seq)
+      : items{{list[I]...}}, index(frozen::keys_of(list, seq)) {}
+};
+
+template <typename Key, size_t N, typename Hash = frozen::hash<Key>>
+class frozen_set {
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+  using iterator = const Key *;  // in the order of the list
+
+  constexpr explicit frozen_set(const Key (&list)[N])
+      : frozen_set(list, std::make_index_sequence<N>()) {}
+
+  constexpr iterator begin() const { return keys.data(); }
+  constexpr iterator end() const { return keys.data() + N; }
+  constexpr bool empty() const { return N == 0; }
+  constexpr size_type size() const { return N; }
+
+  constexpr iterator find(const Key &key) const {
+    const Key &item = keys[index.index_of(key)];
+    return item == key ? &item : end();
+  }
+  constexpr bool contains(const Key &key) const { return find(key) != end(); }
+  constexpr size_type count(const Key &key) const { return contains(key); }
+
+ private:
+  std::array<Key, N> keys;
+  frozen::perfect_hash<Key, N, Hash> index;
+
+  template <size_t... I>
+  constexpr frozen_set(const Key (&list)[N], std::index_sequence<I...>)
+      : keys{{list[I]...}}, index(keys) {}
+};
+
+template <typename Key, typename T, size_t N>
+constexpr frozen_map<Key, T, N> make_frozen_map(
+    const std::pair<Key, T> (&list)[N]) {
+  return frozen_map<Key, T, N>(list);
+}
+
+template <typename Key, size_t N>
+constexpr frozen_set<Key, N> make_frozen_set(const Key (&list)[N]) {
+  return frozen_set<Key, N>(list);
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_FROZEN_MAP_MY_FROZEN_MAP_H_
@@ -0,0 +1,503 @@
+#ifndef CONTAINERS_SRC_HASHTABLE_MY_HASHTABLE_H_
+#define CONTAINERS_SRC_HASHTABLE_MY_HASHTABLE_H_
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/my_vector.h"
+
+namespace my {
+namespace swiss {
+
+// Open addressing layout in the style of Swiss tables: every slot has one
+// control byte, and lookups compare the control bytes of a whole group at
+// once before they touch any key.
+//   empty    0b10000000
+//   deleted  0b11111110
+//   full     0b0hhhhhhh  low 7 bits of the hash (h2)
+// The rest of the hash (h1) picks the first group; groups are then probed
+// in triangular steps, which visits every group of a power of two table.
+
+using ctrl_t = int8_t;
+constexpr ctrl_t kEmpty = -128;
+constexpr ctrl_t kDeleted = -2;
+
+#if defined(__AVX2__)
+struct group {  // 32 control bytes per probe
+  static constexpr size_t kWidth = 32;
+  __m256i ctrl;
+
+  explicit group(const ctrl_t *pos)
+      : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pos))) {}
+  uint32_t match(ctrl_t h2) const {  // bit i set if byte i equals h2
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl));
+  }
+  uint32_t match_empty() const { return match(kEmpty); }
+  uint32_t match_free() const {  // empty or deleted, the sign bit is set
+    return _mm256_movemask_epi8(ctrl);
+  }
+};
+#elif defined(__SSE2__)
+struct group {  // 16 control bytes per probe
+  static constexpr size_t kWidth = 16;
+  __m128i ctrl;
+
+  explicit group(const ctrl_t *pos)
+      : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos))) {}
+  uint32_t match(ctrl_t h2) const {  // bit i set if byte i equals h2
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+  }
+  uint32_t match_empty() const { return match(kEmpty); }
+  uint32_t match_free() const {  // empty or deleted, the sign bit is set
+    return _mm_movemask_epi8(ctrl);
+  }
+};
+#else
+struct group {  // portable fallback, one byte at a time
+  static constexpr size_t kWidth = 16;
+  const ctrl_t *ctrl;
+
+  explicit group(const ctrl_t *pos) : ctrl(pos) {}
+  uint32_t match(ctrl_t h2) const {  // bit i set if byte i equals h2
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kWidth; i++) mask |= uint32_t(ctrl[i] == h2) << i;
+    return mask;
+  }
+  uint32_t match_empty() const { return match(kEmpty); }
+  uint32_t match_free() const {  // empty or deleted, the sign bit is set
+    uint32_t mask = 0;
+    for (size_t i = 0; i < kWidth; i++) mask |= uint32_t(ctrl[i] < 0) << i;
+    return mask;
+  }
+};
+#endif
+
+}  // namespace swiss
+
+// Hash table core shared by unordered_map and unordered_set. Slot is the
+// stored element: the key itself for a set, pair<const Key, T> for a map.
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+class hashtable {
+ public:
+  using size_type = size_t;
+  using ctrl_t = swiss::ctrl_t;
+  static constexpr size_type kWidth = swiss::group::kWidth;
+
+  //------------------ITERATOR------------------// walks full slots
+  class iterator {
+   public:
+    iterator(const hashtable *table = nullptr, size_type pos = 0)
+        : owner(table), index(pos) {
+      skip_free();
+    }
+    Slot &operator*() const { return owner->slots[index]; }
+    Slot *operator->() const { return &owner->slots[index]; }
+    size_type position() const { return index; }
+
+    iterator &operator++() {
+      ++index;
+      skip_free();
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return index == other.index;
+    }
+    bool operator!=(const iterator &other) const {
+      return index != other.index;
+    }
+
+   private:
+    const hashtable *owner;
+    size_type index;
+
+    void skip_free() {
+      if (owner == nullptr) return;
+      while (index < owner->cap && owner->ctrl[index] < 0) ++index;
+    }
+  };  // class iterator
+
+  hashtable() {}
+  hashtable(const hashtable &other);
+  hashtable(hashtable &&other) noexcept { swap(other); }
+  hashtable &operator=(const hashtable &other) {
+    if (this != &other) {
+      hashtable tmp(other);
+      swap(tmp);
+    }
+    return *this;
+  }
+  hashtable &operator=(hashtable &&other) noexcept {
+    if (this != &other) {
+      hashtable tmp(std::move(other));
+      swap(tmp);
+    }
+    return *this;
+  }
+  ~hashtable() {
+    clear();
+    release(ctrl, slots, cap);
+  }
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, cap); }
+
+  bool empty() const { return count == 0; }
+  size_type size() const { return count; }
+  size_type capacity() const { return cap; }
+  double load_factor() const { return cap ? double(count) / cap : 0.0; }
+  size_type max_size() const {
+    return std::numeric_limits<size_type>::max() / sizeof(Slot);
+  }
+
+  void clear();                  // keeps the allocated slots
+  void reserve(size_type items);  // room for items without a rehash
+
+  iterator find(const Key &key) const {
+    size_type i = find_index(key, hash_of(key));
+    return iterator(this, i == npos ? cap : i);
+  }
+  bool contains(const Key &key) const {
+    return find_index(key, hash_of(key)) != npos;
+  }
+
+  template <typename... Args>  // builds Slot(args...) if key is missing
+  std::pair<iterator, bool> emplace_key(const Key &key, Args &&...args);
+  bool erase(const Key &key) {
+    size_type i = find_index(key, hash_of(key));
+    if (i == npos) return false;
+    erase_at(i);
+    return true;
+  }
+  void erase(iterator it) { erase_at(it.position()); }
+
+  void swap(hashtable &other) noexcept;
+
+ private:
+  static constexpr size_type npos = ~size_type(0);
+
+  ctrl_t *ctrl = nullptr;  // cap control bytes
+  Slot *slots = nullptr;   // cap slots, constructed where ctrl is full
+  size_type cap = 0;       // power of two, a multiple of kWidth
+  size_type count = 0;
+  size_type growth_left = 0;  // empty slots to fill before a rehash
+  Hash hasher;
+  KeyEqual equal;
+
+  static const Key &key_of(const Slot &slot) {
+    if constexpr (std::is_same<Slot, Key>::value)
+      return slot;
+    else
+      return slot.first;
+  }
+  static size_type max_load(size_type slots) { return slots - slots / 8; }
+
+  size_type hash_of(const Key &key) const {  // spreads weak hashes such
+    uint64_t h = hasher(key);                  // as identity on integers
+    __uint128_t product = __uint128_t(h) * 0x9E3779B97F4A7C15ull;
+    return uint64_t(product) ^ uint64_t(product >> 64);
+  }
+  size_type find_index(const Key &key, size_type h) const;
+  size_type find_free(size_type h) const;  // first empty or deleted slot
+  void erase_at(size_type i);
+  void rehash(size_type new_cap);
+  static void release(ctrl_t *ctrl, Slot *slots, size_type cap);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+hashtable<Key, Slot, Hash, KeyEqual>::hashtable(const hashtable &other)
+    : hasher(other.hasher), equal(other.equal) {
+  if (other.cap == 0) return;
+  ctrl = new ctrl_t[other.cap];
+  slots = std::allocator<Slot>().allocate(other.cap);
+  cap = other.cap;
+  std::memset(ctrl, swiss::kEmpty, cap);
+  for (size_type i = 0; i < cap; i++) {  // same positions, tombstones too
+    if (other.ctrl[i] >= 0) {
+      new (slots + i) Slot(other.slots[i]);
+      ++count;
+    }
+    ctrl[i] = other.ctrl[i];
+  }
+  growth_left = other.growth_left;
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+void hashtable<Key, Slot, Hash, KeyEqual>::clear() {
+  for (size_type i = 0; i < cap; i++)
+    if (ctrl[i] >= 0) slots[i].~Slot();
+  if (cap) std::memset(ctrl, swiss::kEmpty, cap);
+  count = 0;
+  growth_left = max_load(cap);
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+void hashtable<Key, Slot, Hash, KeyEqual>::reserve(size_type items) {
+  size_type new_cap = cap ? cap : kWidth;
+  while (max_load(new_cap) < items) new_cap *= 2;
+  if (new_cap != cap) rehash(new_cap);
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+typename hashtable<Key, Slot, Hash, KeyEqual>::size_type
+hashtable<Key, Slot, Hash, KeyEqual>::find_index(const Key &key,
+                                                 size_type h) const {
+  if (cap == 0) return npos;
+  size_type mask = cap / kWidth - 1, g = (h >> 7) & mask;
+  ctrl_t h2 = ctrl_t(h & 0x7F);
+  for (size_type step = 1;; step++) {
+    swiss::group grp(ctrl + g * kWidth);
+    for (uint32_t m = grp.match(h2); m; m &= m - 1) {
+      size_type i = g * kWidth + __builtin_ctz(m);
+      if (equal(key_of(slots[i]), key)) return i;
+    }
+    if (grp.match_empty()) return npos;  // the key would have stopped here
+    g = (g + step) & mask;
+  }
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+typename hashtable<Key, Slot, Hash, KeyEqual>::size_type
+hashtable<Key, Slot, Hash, KeyEqual>::find_free(size_type h) const {
+  size_type mask = cap / kWidth - 1, g = (h >> 7) & mask;
+  for (size_type step = 1;; step++) {
+    uint32_t m = swiss::group(ctrl + g * kWidth).match_free();
+    if (m) return g * kWidth + __builtin_ctz(m);
+    g = (g + step) & mask;
+  }
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+template <typename... Args>
+std::pair<typename hashtable<Key, Slot, Hash, KeyEqual>::iterator, bool>
+hashtable<Key, Slot, Hash, KeyEqual>::emplace_key(const Key &key,
+                                                  Args &&...args) {
+  size_type h = hash_of(key);
+  size_type i = find_index(key, h);
+  if (i != npos) return {iterator(this, i), false};
+  if (growth_left == 0) {  // tombstones only are cleaned at the same size
+    rehash(cap == 0 ? kWidth : count <= max_load(cap) / 2 ? cap : cap * 2);
+  }
+  i = find_free(h);
+  new (slots + i) Slot(std::forward<Args>(args)...);
+  if (ctrl[i] == swiss::kEmpty) --growth_left;
+  ctrl[i] = ctrl_t(h & 0x7F);
+  ++count;
+  return {iterator(this, i), true};
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+void hashtable<Key, Slot, Hash, KeyEqual>::erase_at(size_type i) {
+  slots[i].~Slot();
+  --count;
+  // a group that still has an empty slot never made a probe go past it,
+  // so the slot can become empty again instead of a tombstone
+  if (swiss::group(ctrl + i / kWidth * kWidth).match_empty()) {
+    ctrl[i] = swiss::kEmpty;
+    ++growth_left;
+  } else {
+    ctrl[i] = swiss::kDeleted;
+  }
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+void hashtable<Key, Slot, Hash, KeyEqual>::rehash(size_type new_cap) {
+  ctrl_t *old_ctrl = ctrl;
+  Slot *old_slots = slots;
+  size_type old_cap = cap;
+  ctrl = new ctrl_t[new_cap];
+  slots = std::allocator<Slot>().allocate(new_cap);
+  cap = new_cap;
+  std::memset(ctrl, swiss::kEmpty, cap);
+  growth_left = max_load(cap) - count;
+  for (size_type i = 0; i < old_cap; i++) {
+    if (old_ctrl[i] < 0) continue;
+    size_type h = hash_of(key_of(old_slots[i]));
+    size_type j = find_free(h);
+    new (slots + j) Slot(std::move(old_slots[i]));
+    old_slots[i].~Slot();
+    ctrl[j] = ctrl_t(h & 0x7F);
+  }
+  release(old_ctrl, old_slots, old_cap);
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+void hashtable<Key, Slot, Hash, KeyEqual>::release(ctrl_t *ctrl,
+                                                   Slot *slots,
+                                                   size_type cap) {
+  delete[] ctrl;
+  if (slots) std::allocator<Slot>().deallocate(slots, cap);
+}
+
+template <typename Key, typename Slot, typename Hash, typename KeyEqual>
+void hashtable<Key, Slot, Hash, KeyEqual>::swap(hashtable &other) noexcept {
+  std::swap(ctrl, other.ctrl);
+  std::swap(slots, other.slots);
+  std::swap(cap, other.cap);
+  std::swap(count, other.count);
+  std::swap(growth_left, other.growth_left);
+  std::swap(hasher, other.hasher);
+  std::swap(equal, other.equal);
+}
+
+//------------------SET------------------//
+template <typename Key, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class unordered_set {
+ private:
+  using table_type = hashtable<Key, Key, Hash, KeyEqual>;
+  using table_iterator = typename table_type::iterator;
+  table_type table;
+
+ public:
+  using key_type = Key;
+  using value_type = Key;
+  using size_type = size_t;
+
+  class iterator : public table_iterator {  // keys are read only
+   public:
+    iterator(const table_iterator &it) : table_iterator(it) {}
+    const Key &operator*() const { return table_iterator::operator*(); }
+    const Key *operator->() const { return table_iterator::operator->(); }
+    iterator &operator++() {
+      table_iterator::operator++();
+      return *this;
+    }
+  };
+
+  unordered_set() {}
+  unordered_set(std::initializer_list<value_type> const &items) {
+    table.reserve(items.size());
+    for (const auto &item : items) insert(item);
+  }
+
+  iterator begin() const { return table.begin(); }
+  iterator end() const { return table.end(); }
+
+  bool empty() const { return table.empty(); }
+  size_type size() const { return table.size(); }
+  size_type max_size() const { return table.max_size(); }
+  double load_factor() const { return table.load_factor(); }
+  void reserve(size_type items) { table.reserve(items); }
+
+  void clear() { table.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    auto res = table.emplace_key(value, value);
+    return {iterator(res.first), res.second};
+  }
+  bool erase(const value_type &value) { return table.erase(value); }
+  iterator erase(iterator it) {
+    iterator next = it;
+    ++next;  // erase leaves the other slots where they are
+    table.erase(it);
+    return next;
+  }
+  void merge(unordered_set &other) {
+    table.reserve(size() + other.size());
+    for (const auto &key : other) insert(key);
+  }
+
+  iterator find(const Key &key) const { return table.find(key); }
+  bool contains(const Key &key) const { return table.contains(key); }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<std::pair<iterator, bool>> out;
+    ((out.push_back(this->insert(args))), ...);
+    return out;
+  }
+};
+
+//------------------MAP------------------//
+template <typename Key, typename T, typename Hash = std::hash<Key>,
+          typename KeyEqual = std::equal_to<Key>>
+class unordered_map {
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const key_type, mapped_type>;
+  using size_type = size_t;
+
+ private:
+  using table_type = hashtable<Key, value_type, Hash, KeyEqual>;
+  table_type table;
+
+ public:
+  using iterator = typename table_type::iterator;
+
+  unordered_map() {}
+  unordered_map(std::initializer_list<value_type> const &items) {
+    table.reserve(items.size());
+    for (const auto &item : items) insert(item);
+  }
+
+  T &at(const Key &key) {
+    iterator it = table.find(key);
+    if (it == end()) throw std::out_of_range("Key not found");
+    return it->second;
+  }
+  const T &at(const Key &key) const {
+    iterator it = table.find(key);
+    if (it == end()) throw std::out_of_range("Key not found");
+    return it->second;
+  }
+  T &operator[](const Key &key) {
+    return table
+        .emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+                     std::forward_as_tuple())
+        .first->second;
+  }
+
+  iterator begin() const { return table.begin(); }
+  iterator end() const { return table.end(); }
+
+  bool empty() const { return table.empty(); }
+  size_type size() const { return table.size(); }
+  size_type max_size() const { return table.max_size(); }
+  double load_factor() const { return table.load_factor(); }
+  void reserve(size_type items) { table.reserve(items); }
+
+  void clear() { table.clear(); }
+  std::pair<iterator, bool> insert(const value_type &value) {
+    return table.emplace_key(value.first, value);
+  }
+  std::pair<iterator, bool> insert(const Key &key, const T &obj) {
+    return table.emplace_key(key, key, obj);
+  }
+  std::pair<iterator, bool> insert_or_assign(const Key &key, const T &obj) {
+    auto res = table.emplace_key(key, key, obj);
+    if (!res.second) res.first->second = obj;
+    return res;
+  }
+  void erase(iterator it) { table.erase(it); }
+  bool erase(const Key &key) { return table.erase(key); }
+  void merge(unordered_map &other) {  // values of other win on equal keys
+    table.reserve(size() + other.size());
+    for (const auto &item : other) insert_or_assign(item.first, item.second);
+  }
+
+  iterator find(const Key &key) const { return table.find(key); }
+  bool contains(const Key &key) const { return table.contains(key); }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args &&...args) {
+    vector<std::pair<iterator, bool>> out;
+    ((out.push_back(this->insert(args))), ...);
+    return out;
+  }
+};
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_HASHTABLE_MY_HASHTABLE_H_
@@ -0,0 +1,164 @@
+#ifndef CONTAINERS_SRC_INTERVAL_MAP_MY_INTERVAL_MAP_H_
+#define CONTAINERS_SRC_INTERVAL_MAP_MY_INTERVAL_MAP_H_
+
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+#include "../bitree/my_bitree.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+
+template <typename Key>
+struct interval_end {  // node value of an interval_map
+  Key end;      // end point of the interval that starts at the node key
+  Key max_end;  // largest end point in the subtree of the node
+};
+
+template <typename Compare>
+struct max_end_augment {  // keeps interval_end::max_end, see no_augment
+  template <typename Node>
+  static void update(Node *nd) {
+    Compare comp;  // the order has no state, like std::less
+    nd->value2.max_end = nd->value2.end;
+    if (nd->left && comp(nd->value2.max_end, nd->left->value2.max_end))
+      nd->value2.max_end = nd->left->value2.max_end;
+    if (nd->right && comp(nd->value2.max_end, nd->right->value2.max_end))
+      nd->value2.max_end = nd->right->value2.max_end;
+  }
+};
+
+// Closed intervals [start, end] keyed by start, one interval per start as
+// in map<start, end>. Every node also keeps the largest end point of its
+// subtree, so a query skips whole subtrees that end before it begins:
+// overlapping() costs O(log n + k) for k results, not a scan of all.
+template <typename Key, typename Compare = std::less<Key>,
+          typename Balance = rb_balance>
+class interval_map {
+ private:
+  using tree_type = bitree<Key, interval_end<Key>, Compare, Balance,
+                           max_end_augment<Compare>>;
+  tree_type tree;
+
+  template <typename F>
+  void visit(const Key &lo, const Key &hi, F f) const;
+
+ public:
+  using key_type = Key;
+  using value_type = std::pair<Key, Key>;  // start, end
+  using size_type = size_t;
+
+  interval_map() {}
+  interval_map(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert(item.first, item.second);
+  }
+
+  bool insert(const Key &start, const Key &end);  // false if start is taken
+  void insert_or_assign(const Key &start, const Key &end);
+  bool erase(const Key &start);
+  void clear() { tree.clear(); }
+
+  bool contains(const Key &start) const { return tree.contains(start); }
+  const Key &at(const Key &start) const {  // end of the interval at start
+    return tree.find_value(start).end;
+  }
+  bool empty() const { return tree.get_size() == 0; }
+  size_type size() const { return tree.get_size(); }
+
+  // intervals that share at least one point with [lo, hi], by start
+  vector<value_type> overlapping(const Key &lo, const Key &hi) const {
+    vector<value_type> out;
+    visit(lo, hi, [&out](const Key &start, const Key &end) {
+      out.push_back(value_type(start, end));
+    });
+    return out;
+  }
+  vector<value_type> overlapping(const Key &point) const {
+    return overlapping(point, point);
+  }
+  bool overlaps(const Key &lo, const Key &hi) const;  // any, O(log n)
+
+  template <typename F>
+  void for_each(F f) const {  // f(start, end) in start order
+    tree.in_order([&f](const Key &start, const interval_end<Key> &value) {
+      f(start, value.end);
+    });
+  }
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Compare, typename Balance>
+bool interval_map<Key, Compare, Balance>::insert(const Key &start,
+                                                 const Key &end) {
+  if (tree.key_comp()(end, start))
+    throw std::invalid_argument("Interval ends before it starts");
+  if (tree.contains(start)) return false;
+  tree << std::pair<Key, interval_end<Key>>(start, {end, end});
+  return true;
+}
+
+template <typename Key, typename Compare, typename Balance>
+void interval_map<Key, Compare, Balance>::insert_or_assign(const Key &start,
+                                                           const Key &end) {
+  if (tree.key_comp()(end, start))
+    throw std::invalid_argument("Interval ends before it starts");
+  tree >> start;  // the new end has to reach the max_end of the ancestors
+  tree << std::pair<Key, interval_end<Key>>(start, {end, end});
+}
+
+template <typename Key, typename Compare, typename Balance>
+bool interval_map<Key, Compare, Balance>::erase(const Key &start) {
+  if (!tree.contains(start)) return false;
+  tree >> start;
+  return true;
+}
+
+template <typename Key, typename Compare, typename Balance>
+template <typename F>
+void interval_map<Key, Compare, Balance>::visit(const Key &lo, const Key &hi,
+                                                F f) const {
+  // in-order walk with an explicit stack, the depth of a splay tree is not
+  // bounded; subtrees whose max_end is below lo are never entered, and the
+  // walk stops at the first start above hi
+  Compare comp = tree.key_comp();
+  auto nd = tree.get_root();
+  vector<decltype(nd)> stack;
+  while (nd || !stack.empty()) {
+    if (nd) {
+      if (comp(nd->value2.max_end, lo)) {
+        nd = nullptr;
+      } else {
+        stack.push_back(nd);
+        nd = nd->left;
+      }
+      continue;
+    }
+    nd = stack.back();
+    stack.pop_back();
+    if (comp(hi, nd->value)) return;
+    if (!comp(nd->value2.end, lo)) f(nd->value, nd->value2.end);
+    nd = nd->right;
+  }
+}
+
+template <typename Key, typename Compare, typename Balance>
+bool interval_map<Key, Compare, Balance>::overlaps(const Key &lo,
+                                                   const Key &hi) const {
+  // if the left subtree reaches lo but holds no overlap, its interval that
+  // reaches furthest starts after hi, and so does everything to the right
+  Compare comp = tree.key_comp();
+  auto nd = tree.get_root();
+  while (nd) {
+    if (!comp(hi, nd->value) && !comp(nd->value2.end, lo)) return true;
+    if (nd->left && !comp(nd->left->value2.max_end, lo))
+      nd = nd->left;
+    else
+      nd = nd->right;
+  }
+  return false;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_INTERVAL_MAP_MY_INTERVAL_MAP_H_
@@ -1,6 +1,13 @@
 #ifndef CONTAINERS_LIST_MY_LIST_H_
 #define CONTAINERS_LIST_MY_LIST_H_
 
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
 namespace my {
 template <class T>
 class list {
@@ -65,6 +72,8 @@ class list {
     ListConstIterator() : node_(nullptr) {}
     ListConstIterator(Node *node) : node_(node) {}
     ListConstIterator(const ListConstIterator &r) : node_(r.node_) {}
+    ListConstIterator(const ListIterator<value_type> &r)  // from iterator
+        : node_(r.node_) {}
 
     ListConstIterator &operator=(const ListConstIterator &r) {
       node_ = r.node_;
@@ -209,7 +218,7 @@ class list {
         node;  // Обновление связей нового узла
 
     ++size_;
-    node_->value_ = size();  // Обновление размера списка
+    StoreSize();  // Обновление размера списка
 
     return iterator(node);  // Возврат итератора на вставленный узел
   }
@@ -222,7 +231,7 @@ class list {
 
     ChangePointers(node);  // Обновляем указатели соседних элементов
     --size_;
-    node_->value_ = size();
+    StoreSize();
 
     // Уничтожаем объект с использованием allocator_traits
     std::allocator_traits<decltype(alloc_)>::destroy(alloc_, node);
@@ -252,6 +261,7 @@ class list {
   }
 
   void splice(const_iterator pos, list &other) {
+    if (other.empty()) return;
     pos.node_->prev_->next_ = other.begin().node_;
     other.begin().node_->prev_ = pos.node_->prev_;
 
@@ -259,11 +269,27 @@ class list {
     (--other.end()).node_->next_ = pos.node_;
 
     size_ += other.size_;
-    node_->value_ = size_;
+    StoreSize();
     other.size_ = 0;
+    other.StoreSize();
     other.node_->next_ = other.node_->prev_ = other.node_;
   }
 
+  // Moves the element at it from other in front of pos in O(1), other may
+  // be this list. No element is copied, iterators to it stay valid.
+  void splice(const_iterator pos, list &other, const_iterator it) {
+    Node *node = it.node_;
+    if (node == pos.node_ || node->next_ == pos.node_) return;  // in place
+    ChangePointers(node);
+    ChangePointers(node, pos.node_);
+    if (&other != this) {
+      --other.size_;
+      other.StoreSize();
+      ++size_;
+      StoreSize();
+    }
+  }
+
   void reverse() {
     Node *node = node_;
     for (size_type i = 0; i < size_ + 1; ++i) {
@@ -324,10 +350,15 @@ class list {
     node_ = alloc_.allocate(1);  // Выделение памяти для узла
     std::allocator_traits<decltype(alloc_)>::construct(
         alloc_, node_, Node());  // Конструирование узла
-    node_->value_ = size();      // Установка значения узла
+    StoreSize();                 // Установка значения узла
     node_->prev_ = node_->next_ = node_;  // Установка связей
   }
 
+  void StoreSize() {  // the sentinel keeps the size when T can hold it
+    if constexpr (std::is_assignable<T &, size_type>::value)
+      node_->value_ = size_;
+  }
+
   void MergeSort(size_type first, size_type last) {
     if (first + 1 == last) return;
     size_type middle = (last + first) / 2;
@@ -375,7 +406,8 @@ class list {
   }
 
   void RemoveList() {
-    clear();  // Очистить список
+    if (node_ == nullptr) return;  // moved from, nothing to free
+    clear();                       // Очистить список
     std::allocator_traits<decltype(alloc_)>::destroy(
         alloc_, node_);           // Уничтожить объект
     alloc_.deallocate(node_, 1);  // Освободить память
@@ -0,0 +1,301 @@
+#ifndef CONTAINERS_SRC_LRU_CACHE_MY_LRU_CACHE_H_
+#define CONTAINERS_SRC_LRU_CACHE_MY_LRU_CACHE_H_
+
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#include "../hashtable/my_hashtable.h"
+#include "../list/my_list.h"
+
+namespace my {
+
+struct cache_stats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t inserts = 0;    // new keys put
+  size_t updates = 0;    // puts on a key already cached
+  size_t evictions = 0;  // entries dropped to make room
+  size_t rejected = 0;   // puts of an entry bigger than the whole capacity
+
+  double hit_rate() const {
+    return hits + misses ? double(hits) / double(hits + misses) : 0;
+  }
+};
+
+// Capacity is counted in entries, or in whatever cost(key, value) returns
+// when a cost function is given, for example bytes. Keys and values have to
+// be default constructible, the list keeps a default entry as sentinel.
+template <typename Key, typename Value>
+using cache_cost = std::function<size_t(const Key &, const Value &)>;
+
+// Least recently used cache: a list in recency order, the most recent in
+// front, and a hash index from key to list node. A hit splices its node to
+// the front; the back is evicted. get, put and erase are O(1).
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class lru_cache {
+ public:
+  using size_type = size_t;
+
+  explicit lru_cache(size_type capacity,
+                     cache_cost<Key, Value> cost = nullptr)
+      : limit(capacity), cost_of(std::move(cost)) {
+    if (capacity == 0) throw std::invalid_argument("Cache capacity is 0");
+  }
+
+  // The cached value or nullptr; a hit becomes the most recent entry. The
+  // pointer is good until the entry is evicted, erased or put again.
+  const Value *get(const Key &key) {
+    auto found = index.find(key);
+    if (found == index.end()) {
+      ++counters.misses;
+      return nullptr;
+    }
+    ++counters.hits;
+    order.splice(order.cbegin(), order, found->second);
+    return &(*found->second).value;
+  }
+  void put(const Key &key, const Value &value);
+  bool erase(const Key &key);
+  bool contains(const Key &key) const {  // recency and counters stay
+    return index.contains(key);
+  }
+
+  size_type size() const { return order.size(); }
+  size_type capacity() const { return limit; }
+  size_type used() const { return in_use; }  // against the capacity
+  bool empty() const { return order.empty(); }
+  const cache_stats &stats() const { return counters; }
+  void reset_stats() { counters = cache_stats(); }
+  void clear() {
+    order.clear();
+    index.clear();
+    in_use = 0;
+  }
+
+ private:
+  struct entry {
+    Key key;
+    Value value;
+    size_type cost;
+  };
+  using list_type = list<entry>;
+  using position = typename list_type::iterator;
+
+  list_type order;  // most recent first
+  unordered_map<Key, position, Hash> index;
+  size_type limit;
+  size_type in_use = 0;
+  cache_cost<Key, Value> cost_of;
+  cache_stats counters;
+
+  void drop(position it) {
+    in_use -= (*it).cost;
+    index.erase((*it).key);
+    order.erase(it);
+  }
+};
+
+// Least frequently used cache, ties broken by recency. Entries sit in
+// buckets of equal use count, buckets in a list by count; a hit splices the
+// entry into the next bucket, so every operation stays O(1). Frequencies
+// protect entries used often from a scan of keys seen once, where LRU
+// would flush them.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class lfu_cache {
+ public:
+  using size_type = size_t;
+
+  explicit lfu_cache(size_type capacity,
+                     cache_cost<Key, Value> cost = nullptr)
+      : limit(capacity), cost_of(std::move(cost)) {
+    if (capacity == 0) throw std::invalid_argument("Cache capacity is 0");
+  }
+
+  const Value *get(const Key &key) {  // nullptr on a miss, see lru_cache
+    auto found = index.find(key);
+    if (found == index.end()) {
+      ++counters.misses;
+      return nullptr;
+    }
+    ++counters.hits;
+    touch(found->second);
+    return &(*found->second.item).value;
+  }
+  void put(const Key &key, const Value &value);
+  bool erase(const Key &key);
+  bool contains(const Key &key) const { return index.contains(key); }
+  size_type uses(const Key &key) const {  // gets and puts, 0 if missing
+    auto found = index.find(key);
+    return found == index.end() ? 0 : (*found->second.group).uses;
+  }
+
+  size_type size() const { return index.size(); }
+  size_type capacity() const { return limit; }
+  size_type used() const { return in_use; }
+  bool empty() const { return index.empty(); }
+  const cache_stats &stats() const { return counters; }
+  void reset_stats() { counters = cache_stats(); }
+  void clear() {
+    buckets.clear();
+    index.clear();
+    in_use = 0;
+  }
+
+ private:
+  struct entry {
+    Key key;
+    Value value;
+    size_type cost;
+  };
+  struct bucket {
+    size_type uses;
+    list<entry> entries;  // most recent first
+  };
+  using bucket_position = typename list<bucket>::iterator;
+  using entry_position = typename list<entry>::iterator;
+  struct slot {
+    bucket_position group;
+    entry_position item;
+  };
+
+  list<bucket> buckets;  // by use count, the least used first
+  unordered_map<Key, slot, Hash> index;
+  size_type limit;
+  size_type in_use = 0;
+  cache_cost<Key, Value> cost_of;
+  cache_stats counters;
+
+  void touch(slot &at);  // one more use
+  void drop(const slot &at);
+  void evict(const Key *keep);  // the least used entry that is not *keep
+  bucket_position bucket_after(bucket_position prev, size_type uses);
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Value, typename Hash>
+void lru_cache<Key, Value, Hash>::put(const Key &key, const Value &value) {
+  size_type cost = cost_of ? cost_of(key, value) : 1;
+  auto found = index.find(key);
+  if (found != index.end()) {  // the old value goes, the key stays hot
+    drop(found->second);
+    ++counters.updates;
+  } else {
+    ++counters.inserts;
+  }
+  if (cost > limit) {
+    ++counters.rejected;
+    return;
+  }
+  while (in_use + cost > limit) {
+    drop(--order.end());
+    ++counters.evictions;
+  }
+  order.push_front(entry{key, value, cost});
+  index.insert(key, order.begin());
+  in_use += cost;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool lru_cache<Key, Value, Hash>::erase(const Key &key) {
+  auto found = index.find(key);
+  if (found == index.end()) return false;
+  drop(found->second);
+  return true;
+}
+
+template <typename Key, typename Value, typename Hash>
+typename lfu_cache<Key, Value, Hash>::bucket_position
+lfu_cache<Key, Value, Hash>::bucket_after(bucket_position prev,
+                                          size_type uses) {
+  // the bucket for uses right after prev (begin() if prev is end()), made
+  // if it is not there
+  bucket_position next = prev;
+  ++next;
+  if (next != buckets.end() && (*next).uses == uses) return next;
+  return buckets.insert(next, bucket{uses, list<entry>()});
+}
+
+template <typename Key, typename Value, typename Hash>
+void lfu_cache<Key, Value, Hash>::touch(slot &at) {
+  bucket_position from = at.group;
+  bucket_position to = bucket_after(from, (*from).uses + 1);
+  list<entry> &source = (*from).entries;
+  (*to).entries.splice((*to).entries.cbegin(), source, at.item);
+  at.group = to;
+  if (source.empty()) buckets.erase(from);
+}
+
+template <typename Key, typename Value, typename Hash>
+void lfu_cache<Key, Value, Hash>::drop(const slot &at) {
+  bucket_position group = at.group;
+  in_use -= (*at.item).cost;
+  Key key = (*at.item).key;  // at lives in the index
+  (*group).entries.erase(at.item);
+  if ((*group).entries.empty()) buckets.erase(group);
+  index.erase(key);
+}
+
+template <typename Key, typename Value, typename Hash>
+void lfu_cache<Key, Value, Hash>::evict(const Key *keep) {
+  // the oldest entry of the least used bucket; keep is one entry, so one
+  // step to the entry before it or to the next bucket is enough
+  bucket_position group = buckets.begin();
+  entry_position victim = --(*group).entries.end();
+  if (keep && (*victim).key == *keep) {
+    if ((*group).entries.size() > 1) {
+      --victim;
+    } else {
+      ++group;
+      victim = --(*group).entries.end();
+    }
+  }
+  Key out = (*victim).key;
+  drop(index.find(out)->second);
+  ++counters.evictions;
+}
+
+template <typename Key, typename Value, typename Hash>
+void lfu_cache<Key, Value, Hash>::put(const Key &key, const Value &value) {
+  size_type cost = cost_of ? cost_of(key, value) : 1;
+  auto found = index.find(key);
+  if (found != index.end()) {  // a new value on a used key keeps its count
+    slot &at = found->second;
+    ++counters.updates;
+    if (cost > limit) {
+      ++counters.rejected;
+      drop(at);
+      return;
+    }
+    in_use -= (*at.item).cost;
+    (*at.item).value = value;
+    (*at.item).cost = cost;
+    in_use += cost;
+    touch(at);
+    while (in_use > limit) evict(&key);  // it grew, others make room
+    return;
+  }
+  ++counters.inserts;
+  if (cost > limit) {
+    ++counters.rejected;
+    return;
+  }
+  while (in_use + cost > limit) evict(nullptr);
+  bucket_position group = bucket_after(--buckets.begin(), 1);
+  list<entry> &entries = (*group).entries;
+  entries.push_front(entry{key, value, cost});
+  index.insert(key, slot{group, entries.begin()});
+  in_use += cost;
+}
+
+template <typename Key, typename Value, typename Hash>
+bool lfu_cache<Key, Value, Hash>::erase(const Key &key) {
+  auto found = index.find(key);
+  if (found == index.end()) return false;
+  drop(found->second);
+  return true;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_LRU_CACHE_MY_LRU_CACHE_H_
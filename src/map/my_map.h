@@ -3,11 +3,14 @@
 #include <iostream>
 
 #include "../bitree/my_bitree.h"
+#include "../bloom/my_bloom.h"
+#include "../serial/my_serial.h"
 #include "../vector/my_vector.h"
 
 namespace my {
 
-template <typename Key, typename T>
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Balance = rb_balance>
 class map {
  private:
   using key_type = Key;
@@ -15,22 +18,49 @@ class map {
   using value_type = std::pair<const key_type, mapped_type>;
   using reference = value_type&;
   using size_type = size_t;
-  bitree<Key, T> tree;
+  bitree<Key, T, Compare, Balance> tree;
+  bloom_index<Key> bloom;  // optional filter for misses
+
+  void sync_bloom() {  // rebuild now if needed, so lookups only read it
+    bloom.refresh(tree.get_size(), [this](auto add) {
+      tree.in_order([&add](const Key& k, const T&) { add(k); });
+    });
+  }
+
+  static constexpr size_type kMergeRatio = 16;  // size skew to merge by
+                                                // inserts, not a rebuild
+
+  void flatten(vector<Key>& keys, vector<T>& values) const {  // sorted copy
+    keys.reserve(tree.get_size());
+    values.reserve(tree.get_size());
+    tree.in_order([&keys, &values](const Key& key, const T& value) {
+      keys.push_back(key);
+      values.push_back(value);
+    });
+  }
 
  public:
-  using iterator = typename bitree<Key, T>::tree_iterator;
+  using iterator = typename bitree<Key, T, Compare, Balance>::tree_iterator;
   map() {};
+  explicit map(const Compare& order) : tree(order) {}
   map(std::initializer_list<value_type> const& items) {
     for (const auto& item : items) {
       tree << item;
     }
   };
-  map(const map& other) : tree(other.tree) {}
-  map(map&& other) noexcept : tree(std::move(other.tree)) {}
+  map(const map& other) : tree(other.tree), bloom(other.bloom) {}
+  map(map&& other) noexcept
+      : tree(std::move(other.tree)), bloom(std::move(other.bloom)) {}
   ~map() { tree.clear(); }
+  map& operator=(const map& other) {  // shares nodes like the copy
+    tree = other.tree;
+    bloom = other.bloom;
+    return *this;
+  }
   map& operator=(map&& other) noexcept {
     if (this != &other) {
       tree = std::move(other.tree);
+      bloom = std::move(other.bloom);
     }
     return *this;
   }
@@ -40,6 +70,8 @@ class map {
     for (const auto& item : items) {
       tree << item;
     }
+    bloom.invalidate();
+    sync_bloom();
     return *this;
   }
 
@@ -52,12 +84,45 @@ class map {
       return default_value;
     }
   }
+  const T& at(const Key& key) const {  // read only, keeps nodes shared
+    try {
+      return tree.find_value(key);
+    } catch (const std::out_of_range& e) {
+      std::cerr << "Exception: " << e.what() << std::endl;
+      static T default_value{};
+      return default_value;
+    }
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  T& at(const K& key) {  // any type Compare orders against Key
+    try {
+      return tree.find_value(key);
+    } catch (const std::out_of_range& e) {
+      std::cerr << "Exception: " << e.what() << std::endl;
+      static T default_value{};
+      return default_value;
+    }
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  const T& at(const K& key) const {
+    try {
+      return tree.find_value(key);
+    } catch (const std::out_of_range& e) {
+      std::cerr << "Exception: " << e.what() << std::endl;
+      static T default_value{};
+      return default_value;
+    }
+  }
   T& operator[](const Key& key) {
     try {
       return tree.find_value(key);
     } catch (const std::out_of_range& e) {
-      T tmp;
+      T tmp{};
       tree << std::pair<Key, T>{key, tmp};
+      bloom.inserted(key);
+      sync_bloom();
       return tree.find_value(key);
     }
   }
@@ -74,44 +139,149 @@ class map {
   size_type size() { return tree.tree_size; }
   size_type max_size() { return 11111; }
 
-  void clear() { tree.clear(); }
+  void clear() {
+    tree.clear();
+    bloom.invalidate();
+    sync_bloom();
+  }
   std::pair<iterator, bool> insert(const value_type& value) {
-    iterator it = tree.begin();
-    if (contains(value.first)) return {it.set(value.first), false};
+    if (contains(value.first)) return {tree.iterator_to(value.first), false};
     tree << value;
-    return {it.set(value.first), true};
+    bloom.inserted(value.first);
+    sync_bloom();
+    return {tree.iterator_to(value.first), true};
   }
   std::pair<iterator, bool> insert(const Key& key, const T& obj) {
-    iterator it = tree.begin();
-    if (contains(key)) return {it.set(key), false};
+    if (contains(key)) return {tree.iterator_to(key), false};
     tree << std::make_pair(key, obj);
-    return {it.set(key), true};
+    bloom.inserted(key);
+    sync_bloom();
+    return {tree.iterator_to(key), true};
   }
   std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
-    iterator it = tree.begin();
     if (contains(key)) {
       this->operator[](key) = obj;
-      return {it.set(key), false};
+      return {tree.iterator_to(key), false};
     }
     tree << std::make_pair(key, obj);
-    return {it.set(key), true};
-  }
-  void erase(iterator it) { tree >> it.cget(); }
-  void merge(map& other) {
-    iterator it = other.begin();
-    for (size_type i = 0; i < other.size(); i++) {
-      this->operator[](it.cget()) = other.at(it.cget());
-      ++it;
+    bloom.inserted(key);
+    sync_bloom();
+    return {tree.iterator_to(key), true};
+  }
+  void erase(iterator it) {
+    tree >> it.cget();
+    bloom.removed();
+    sync_bloom();
+  }
+  bool erase(const Key& key) {
+    if (!this->contains(key)) return false;
+    tree >> key;
+    bloom.removed();
+    sync_bloom();
+    return true;
+  }
+  void merge(map& other) {  // values of other win on equal keys
+    if (other.size() * kMergeRatio < size()) {  // few new keys, insert each
+      other.tree.in_order([this](const Key& key, const T& value) {
+        this->operator[](key) = value;  // other is only read, stays shared
+      });
+      return;
+    }
+    vector<Key> keys, other_keys, merged_keys;
+    vector<T> values, other_values, merged_values;
+    flatten(keys, values);
+    other.flatten(other_keys, other_values);
+    merged_keys.reserve(keys.size() + other_keys.size());
+    merged_values.reserve(keys.size() + other_keys.size());
+    size_type i = 0, j = 0;
+    while (i < keys.size() || j < other_keys.size()) {
+      if (j == other_keys.size() ||
+          (i < keys.size() && tree.key_comp()(keys[i], other_keys[j]))) {
+        merged_keys.push_back(keys[i]);
+        merged_values.push_back(values[i++]);
+      } else {
+        if (i < keys.size() && !tree.key_comp()(other_keys[j], keys[i]))
+          i++;  // replaced
+        merged_keys.push_back(other_keys[j]);
+        merged_values.push_back(other_values[j++]);
+      }
     }
+    tree.build_sorted(merged_keys.data(), merged_values.data(),
+                      merged_keys.size());
+    bloom.invalidate();
+    sync_bloom();
   }
 
-  bool contains(const Key& key) {
-    try {
-      tree.find_value(key);
-      return true;
-    } catch (const std::out_of_range& e) {
-      return false;
-    }
+  bool contains(const Key& key) const {
+    if (!bloom.may_contain(key))
+      return false;  // definite miss, no tree descent
+    return bloom.found(tree.contains(key));
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {  // the filter hashes Key, so a
+    return tree.contains(key);         // foreign key goes to the tree
+  }
+  size_type count(const Key& key) const { return contains(key); }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return tree.contains(key);
+  }
+  Compare key_comp() const { return tree.key_comp(); }
+
+  void enable_bloom(double fp_rate = 0.01) {  // hashes with std::hash<Key>
+    static_assert(std::is_same<Compare, std::less<Key>>::value ||
+                      std::is_same<Compare, std::less<>>::value,
+                  "a Bloom filter on std::hash needs operator< order");
+    bloom.enable(fp_rate);
+    sync_bloom();
+  }
+  void disable_bloom() { bloom.disable(); }
+  bloom_stats get_bloom_stats() const { return bloom.get_stats(); }
+
+  // cache of hot keys in front of at and operator[], see bitree
+  void enable_hot_cache(size_type slots = 1024) {
+    tree.enable_hot_cache(slots);
+  }
+  void disable_hot_cache() { tree.disable_hot_cache(); }
+  hot_cache_stats get_hot_cache_stats() const {
+    return tree.get_hot_cache_stats();
+  }
+
+  // node relocation for locality, see bitree::compact
+  void compact(compact_order order = compact_order::in_order) {
+    tree.compact(order);
+  }
+  bool compact_step(size_type budget = 256) {
+    return tree.compact_step(budget);
+  }
+  double fragmentation() const { return tree.fragmentation(); }
+
+  void serialize(std::ostream& os) const {  // sorted binary dump
+    vector<Key> keys;
+    vector<T> values;
+    flatten(keys, values);
+    serial::write_header<Key, T>(os, serial::kMap, keys.size());
+    serial::write_block(os, keys.data(), keys.size());
+    serial::write_block(os, values.data(), values.size());
+  }
+
+  void deserialize(std::istream& is) {  // O(n) reload through bulk build
+    size_type count = serial::read_header<Key, T>(is, serial::kMap);
+    vector<Key> keys = serial::read_vector<Key>(is, count);
+    vector<T> values = serial::read_vector<T>(is, count);
+    for (size_type i = 1; i < count; i++)
+      if (!tree.key_comp()(keys[i - 1], keys[i]))
+        throw std::invalid_argument("Container stream keys are not sorted");
+    tree.build_sorted(keys.data(), values.data(), count);
+    bloom.invalidate();
+    sync_bloom();
+  }
+
+  template <typename F>
+  void for_each(F f) const {  // f(key, value) in key order
+    tree.in_order(f);
   }
 
   template <typename... Args>
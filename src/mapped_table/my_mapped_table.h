@@ -0,0 +1,412 @@
+#ifndef CONTAINERS_SRC_MAPPED_TABLE_MY_MAPPED_TABLE_H_
+#define CONTAINERS_SRC_MAPPED_TABLE_MY_MAPPED_TABLE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../map/my_map.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+namespace table {
+
+// Immutable sorted table file:
+//   header  magic "MYTB", version, byte order, sizes and three columns
+//   index   first key of every block of block_size rows
+//   keys    all keys in sorted order
+//   values  all values in key order
+// A column is either fixed width (raw elements back to back) or offset
+// indexed (u64 offsets[count + 1] followed by a heap with the bytes).
+// Every section starts on an 8 byte boundary. Opening checks in O(1)
+// that every column and heap lies inside the file; the offsets inside a
+// heap are checked as they are read.
+
+constexpr char kMagic[4] = {'M', 'Y', 'T', 'B'};
+constexpr uint16_t kVersion = 1;
+constexpr uint16_t kByteOrder = 0x0102;
+
+struct column_header {
+  uint64_t offset;       // fixed data or offsets array
+  uint64_t heap_offset;  // bytes of an offset indexed column
+  uint64_t count;        // number of elements
+  uint32_t width;        // element width, 0 for offset indexed
+  uint32_t reserved;
+};
+
+struct file_header {
+  char magic[4];
+  uint16_t version;
+  uint16_t byte_order;
+  uint64_t file_size;
+  uint64_t count;       // rows in the table
+  uint64_t block_size;  // rows per index block
+  column_header index;
+  column_header keys;
+  column_header values;
+};
+
+struct column {  // read side of a column inside the mapping
+  const char *data = nullptr;
+  const uint64_t *offsets = nullptr;
+  const char *heap = nullptr;
+  uint64_t heap_size = 0;
+};
+
+template <typename T, typename = void>
+struct codec {  // fixed width for trivially copyable types
+  static_assert(std::is_trivially_copyable<T>::value,
+                "type needs a my::table::codec specialization");
+  static constexpr uint32_t width = sizeof(T);
+  using view = T;
+
+  static const char *bytes(const T &value) {
+    return reinterpret_cast<const char *>(&value);
+  }
+  static size_t size(const T &) { return sizeof(T); }
+  static view load(const column &col, size_t i) {
+    T value;
+    std::memcpy(&value, col.data + i * sizeof(T), sizeof(T));
+    return value;
+  }
+};
+
+template <>
+struct codec<std::string> {  // offset indexed, read back as string_view
+  static constexpr uint32_t width = 0;
+  using view = std::string_view;
+
+  static const char *bytes(const std::string &value) { return value.data(); }
+  static size_t size(const std::string &value) { return value.size(); }
+  static view load(const column &col, size_t i) {
+    uint64_t first, last;
+    std::memcpy(&first, col.offsets + i, sizeof(first));
+    std::memcpy(&last, col.offsets + i + 1, sizeof(last));
+    if (first > last || last > col.heap_size)
+      throw std::out_of_range("Corrupt table heap offsets");
+    return view(col.heap + first, last - first);
+  }
+};
+
+inline void pad(std::ofstream &out, uint64_t &pos) {  // align to 8 bytes
+  static const char zeros[8] = {};
+  uint64_t rest = (8 - pos % 8) % 8;
+  out.write(zeros, rest);
+  pos += rest;
+}
+
+// whether a column of rows elements lies inside a file of length bytes
+inline bool column_fits(const column_header &col, uint64_t rows,
+                        uint64_t length) {
+  if (col.count != rows || col.offset > length) return false;
+  uint64_t room = length - col.offset;
+  if (col.width != 0) return rows <= room / col.width;
+  if (rows >= room / sizeof(uint64_t)) return false;  // offsets[rows + 1]
+  return col.heap_offset >= col.offset + (rows + 1) * sizeof(uint64_t) &&
+         col.heap_offset <= length;
+}
+
+template <typename T>
+void write_column(std::ofstream &out, uint64_t &pos, const T *items,
+                  size_t count, size_t stride, column_header &hdr) {
+  hdr.count = count;
+  hdr.width = codec<T>::width;
+  hdr.reserved = 0;
+  hdr.offset = pos;
+  hdr.heap_offset = 0;
+  if (codec<T>::width != 0) {
+    for (size_t i = 0; i < count; i++)
+      out.write(codec<T>::bytes(items[i * stride]), codec<T>::width);
+    pos += count * uint64_t(codec<T>::width);
+  } else {
+    uint64_t offset = 0;
+    for (size_t i = 0; i <= count; i++) {
+      out.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+      if (i < count) offset += codec<T>::size(items[i * stride]);
+    }
+    pos += (count + 1) * sizeof(uint64_t);
+    hdr.heap_offset = pos;
+    for (size_t i = 0; i < count; i++)
+      out.write(codec<T>::bytes(items[i * stride]),
+                codec<T>::size(items[i * stride]));
+    pos += offset;
+  }
+  pad(out, pos);
+}
+
+// Writes sorted keys and values as a table file. The file is built next to
+// path, synced and renamed over it, so processes that still map the old
+// file keep a consistent view and a crash leaves one or the other.
+template <typename Key, typename T>
+void write_file(const std::string &path, const Key *keys, const T *values,
+                size_t count, size_t block_size = 64) {
+  if (block_size == 0) throw std::invalid_argument("Block size is zero");
+  std::string tmp_path = path + ".tmp";
+  std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+  if (!out) throw std::runtime_error("Cannot create " + tmp_path);
+
+  file_header hdr;
+  std::memset(&hdr, 0, sizeof(hdr));
+  std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.version = kVersion;
+  hdr.byte_order = kByteOrder;
+  hdr.count = count;
+  hdr.block_size = block_size;
+  out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  uint64_t pos = sizeof(hdr);
+  pad(out, pos);
+
+  size_t blocks = (count + block_size - 1) / block_size;
+  write_column(out, pos, keys, blocks, block_size, hdr.index);
+  write_column(out, pos, keys, count, 1, hdr.keys);
+  write_column(out, pos, values, count, 1, hdr.values);
+  hdr.file_size = pos;
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(&hdr), sizeof(hdr));
+  out.close();
+  if (!out) throw std::runtime_error("Cannot write " + tmp_path);
+  int fd = ::open(tmp_path.c_str(), O_RDONLY);
+  if (fd < 0) throw std::runtime_error("Cannot open " + tmp_path);
+  int synced = ::fsync(fd);
+  ::close(fd);
+  if (synced != 0) throw std::runtime_error("Cannot sync " + tmp_path);
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0)
+    throw std::runtime_error("Cannot rename " + tmp_path);
+  size_t slash = path.rfind('/');
+  std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+  int dir_fd = ::open(dir.empty() ? "/" : dir.c_str(), O_RDONLY);
+  if (dir_fd >= 0) {  // make the rename itself durable
+    ::fsync(dir_fd);
+    ::close(dir_fd);
+  }
+}
+
+}  // namespace table
+
+// Writes the entries of m as a table file at path, see table::write_file.
+template <typename Key, typename T, typename Compare, typename Balance>
+void write_table(const map<Key, T, Compare, Balance> &m,
+                 const std::string &path, size_t block_size = 64) {
+  static_assert(std::is_same<Compare, std::less<Key>>::value ||
+                    std::is_same<Compare, std::less<>>::value,
+                "mapped tables are searched in operator< order");
+  vector<Key> keys;
+  vector<T> values;
+  m.for_each([&keys, &values](const Key &key, const T &value) {
+    keys.push_back(key);
+    values.push_back(value);
+  });
+  table::write_file(path, keys.data(), values.data(), keys.size(),
+                    block_size);
+}
+
+// Read only view of a table file written by write_table. Opening maps
+// the file and checks the header and column extents only, so startup does
+// not depend on the table size; lookups and iteration read straight from
+// the shared page cache.
+template <typename Key, typename T>
+class mapped_table {
+ public:
+  using key_view = typename table::codec<Key>::view;
+  using mapped_view = typename table::codec<T>::view;
+  using value_type = std::pair<key_view, mapped_view>;
+  using size_type = size_t;
+
+  explicit mapped_table(const std::string &path);
+  mapped_table(const mapped_table &) = delete;
+  mapped_table(mapped_table &&other) noexcept { swap(other); }
+  mapped_table &operator=(const mapped_table &) = delete;
+  mapped_table &operator=(mapped_table &&other) noexcept {
+    if (this != &other) swap(other);
+    return *this;
+  }
+  ~mapped_table() {
+    if (base) munmap(const_cast<char *>(base), length);
+  }
+
+  //------------------ITERATOR------------------// row iterator
+  class iterator {
+   private:
+    const mapped_table *owner;
+    size_type row;
+
+   public:
+    iterator(const mapped_table *table = nullptr, size_type pos = 0)
+        : owner(table), row(pos) {}
+    key_view key() const { return owner->key_at(row); }
+    mapped_view value() const { return owner->value_at(row); }
+    value_type operator*() const { return value_type(key(), value()); }
+    size_type position() const { return row; }
+
+    iterator &operator++() {
+      ++row;
+      return *this;
+    }
+    iterator &operator--() {
+      --row;
+      return *this;
+    }
+    bool operator==(const iterator &other) const { return row == other.row; }
+    bool operator!=(const iterator &other) const { return row != other.row; }
+  };  // class iterator
+
+  iterator begin() const { return iterator(this, 0); }
+  iterator end() const { return iterator(this, count); }
+  size_type size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  iterator lower_bound(const key_view &key) const;
+  iterator find(const key_view &key) const;
+  bool contains(const key_view &key) const { return find(key) != end(); }
+  mapped_view at(const key_view &key) const;
+
+ private:
+  const char *base = nullptr;  // start of the mapping
+  size_t length = 0;
+  size_type count = 0;
+  size_type block_size = 1;
+  size_type blocks = 0;
+  table::column index, keys, values;
+
+  key_view key_at(size_type row) const {
+    return table::codec<Key>::load(keys, row);
+  }
+  mapped_view value_at(size_type row) const {
+    return table::codec<T>::load(values, row);
+  }
+  table::column open_column(const table::column_header &) const;
+  void swap(mapped_table &other) noexcept;
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename T>
+mapped_table<Key, T>::mapped_table(const std::string &path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw std::runtime_error("Cannot open " + path + ": " +
+                             std::strerror(errno));
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(table::file_header)) {
+    ::close(fd);
+    throw std::invalid_argument("Not a table file: " + path);
+  }
+  length = st.st_size;
+  void *addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED)
+    throw std::runtime_error("Cannot map " + path + ": " +
+                             std::strerror(errno));
+  base = static_cast<const char *>(addr);
+
+  table::file_header hdr;
+  std::memcpy(&hdr, base, sizeof(hdr));
+  if (std::memcmp(hdr.magic, table::kMagic, sizeof(table::kMagic)) != 0 ||
+      hdr.version != table::kVersion || hdr.byte_order != table::kByteOrder ||
+      hdr.file_size != length || hdr.block_size == 0 ||
+      hdr.keys.width != table::codec<Key>::width ||
+      hdr.values.width != table::codec<T>::width) {
+    munmap(addr, length);
+    base = nullptr;
+    throw std::invalid_argument("Table file type mismatch: " + path);
+  }
+  uint64_t rows = hdr.count;
+  uint64_t block_count = rows / hdr.block_size + (rows % hdr.block_size != 0);
+  if (hdr.index.width != hdr.keys.width ||
+      !table::column_fits(hdr.index, block_count, length) ||
+      !table::column_fits(hdr.keys, rows, length) ||
+      !table::column_fits(hdr.values, rows, length)) {
+    munmap(addr, length);
+    base = nullptr;
+    throw std::invalid_argument("Corrupt table file: " + path);
+  }
+  count = hdr.count;
+  block_size = hdr.block_size;
+  blocks = hdr.index.count;
+  index = open_column(hdr.index);
+  keys = open_column(hdr.keys);
+  values = open_column(hdr.values);
+}
+
+template <typename Key, typename T>
+table::column mapped_table<Key, T>::open_column(
+    const table::column_header &hdr) const {
+  table::column col;
+  if (hdr.width != 0) {
+    col.data = base + hdr.offset;
+  } else {
+    col.offsets = reinterpret_cast<const uint64_t *>(base + hdr.offset);
+    col.heap = base + hdr.heap_offset;
+    col.heap_size = length - hdr.heap_offset;
+  }
+  return col;
+}
+
+template <typename Key, typename T>
+void mapped_table<Key, T>::swap(mapped_table &other) noexcept {
+  std::swap(base, other.base);
+  std::swap(length, other.length);
+  std::swap(count, other.count);
+  std::swap(block_size, other.block_size);
+  std::swap(blocks, other.blocks);
+  std::swap(index, other.index);
+  std::swap(keys, other.keys);
+  std::swap(values, other.values);
+}
+
+template <typename Key, typename T>
+typename mapped_table<Key, T>::iterator mapped_table<Key, T>::lower_bound(
+    const key_view &key) const {
+  // last block whose first key is not greater than key, searched in the
+  // small index first so the big key column is touched in one block only
+  size_type first = 0, last = blocks;
+  while (first < last) {
+    size_type middle = first + (last - first) / 2;
+    if (key < table::codec<Key>::load(index, middle))
+      last = middle;
+    else
+      first = middle + 1;
+  }
+  if (first == 0) return begin();
+  size_type row = (first - 1) * block_size;
+  size_type row_end = row + block_size < count ? row + block_size : count;
+  while (row < row_end) {
+    size_type middle = row + (row_end - row) / 2;
+    if (key_at(middle) < key)
+      row = middle + 1;
+    else
+      row_end = middle;
+  }
+  return iterator(this, row);
+}
+
+template <typename Key, typename T>
+typename mapped_table<Key, T>::iterator mapped_table<Key, T>::find(
+    const key_view &key) const {
+  iterator it = lower_bound(key);
+  if (it != end() && key < it.key()) return end();
+  return it;
+}
+
+template <typename Key, typename T>
+typename mapped_table<Key, T>::mapped_view mapped_table<Key, T>::at(
+    const key_view &key) const {
+  iterator it = find(key);
+  if (it == end()) throw std::out_of_range("Key not found");
+  return it.value();
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_MAPPED_TABLE_MY_MAPPED_TABLE_H_
@@ -0,0 +1,371 @@
+#ifndef CONTAINERS_SRC_MERKLE_MAP_MY_MERKLE_MAP_H_
+#define CONTAINERS_SRC_MERKLE_MAP_MY_MERKLE_MAP_H_
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#include "../bitree/my_bitree.h"
+#include "../serial/my_serial.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// A key that differs between two replicas, from the side diff() runs on.
+enum class merkle_change {
+  only_here,   // the key is missing on the other side
+  only_there,  // the key is missing here
+  changed,     // both have the key, the values differ
+};
+
+template <typename T>
+struct merkle_value {  // node value of a merkle_map
+  T value;
+  uint64_t hash;   // of this key and value
+  uint64_t sum;    // of hash over the subtree of the node
+  uint64_t count;  // nodes in the subtree
+};
+
+struct merkle_augment {  // keeps merkle_value::sum and count
+  template <typename Node>
+  static void update(Node *nd) {
+    nd->value2.sum = nd->value2.hash;
+    nd->value2.count = 1;
+    for (Node *child : {nd->left, nd->right}) {
+      if (!child) continue;
+      nd->value2.sum += child->value2.sum;
+      nd->value2.count += child->value2.count;
+    }
+  }
+};
+
+// Keys and entry hashes of a merkle_map in key order, what a replica ships
+// instead of its values. Entries are grouped in blocks of kBlock whose hash
+// sums are checked first, so a diff reads key by key only the blocks with
+// a change. Hashes come from std::hash, so digests only compare between
+// builds that agree on it.
+template <typename Key>
+class merkle_digest {
+ public:
+  static constexpr size_t kBlock = 64;
+
+  merkle_digest() {}
+  merkle_digest(vector<Key> &&sorted_keys, vector<uint64_t> &&entry_hashes)
+      : keys(std::move(sorted_keys)), hashes(std::move(entry_hashes)) {
+    sum_blocks();
+  }
+
+  size_t size() const { return keys.size(); }
+  const Key &key(size_t i) const { return keys[i]; }
+  uint64_t hash(size_t i) const { return hashes[i]; }
+  uint64_t block_sum(size_t block) const { return block_sums[block]; }
+
+  void write(std::ostream &os) const {  // serial header, keys, hashes
+    serial::write_header<Key, uint64_t>(os, serial::kMerkleDigest,
+                                        keys.size());
+    serial::write_block(os, keys.data(), keys.size());
+    serial::write_block(os, hashes.data(), hashes.size());
+  }
+  void read(std::istream &is) {
+    size_t count =
+        serial::read_header<Key, uint64_t>(is, serial::kMerkleDigest);
+    vector<Key> new_keys = serial::read_vector<Key>(is, count);
+    vector<uint64_t> new_hashes = serial::read_vector<uint64_t>(is, count);
+    keys.swap(new_keys);
+    hashes.swap(new_hashes);
+    sum_blocks();
+  }
+
+ private:
+  vector<Key> keys;
+  vector<uint64_t> hashes;
+  vector<uint64_t> block_sums;
+
+  void sum_blocks() {
+    vector<uint64_t> sums((keys.size() + kBlock - 1) / kBlock);
+    for (size_t i = 0; i < hashes.size(); i++) sums[i / kBlock] += hashes[i];
+    block_sums.swap(sums);
+  }
+};
+
+// Ordered map whose nodes also keep the hash sum and the size of their
+// subtree. A sum is the same whatever the shape of the tree, so two
+// replicas holding the same entries agree on the hash of any key range
+// however they were built. diff() bisects key ranges whose sums differ
+// and reads entries only in ranges of a few keys: O(d log^2 n) for d
+// differences, instead of walking both maps.
+// The sums are additive, good against accidents, not against someone
+// choosing keys to collide. Values are read only, updates go through
+// insert_or_assign so the sums above them stay right.
+template <typename Key, typename T, typename Compare = std::less<Key>,
+          typename Balance = rb_balance>
+class merkle_map {
+ private:
+  using tree_type =
+      bitree<Key, merkle_value<T>, Compare, Balance, merkle_augment>;
+  tree_type tree;
+
+  static constexpr uint64_t kLeafEntries = 16;  // compared key by key
+
+  struct summary {
+    uint64_t sum = 0;
+    uint64_t count = 0;
+  };
+  struct entry {
+    const Key *key;
+    uint64_t hash;
+  };
+
+  summary below(const Key *bound) const;  // of keys < bound, all if null
+  summary range(const Key *lo, const Key *hi) const {  // [lo, hi)
+    summary high = below(hi), low = lo ? below(lo) : summary();
+    return {high.sum - low.sum, high.count - low.count};
+  }
+  const Key &select(uint64_t rank) const;  // key with rank keys below it
+  void entries(const Key *lo, const Key *hi, vector<entry> &out) const;
+  template <typename F>
+  void diff_range(const merkle_map &other, const Key *lo, const Key *hi,
+                  F &f) const;
+  template <typename F>
+  void report(const vector<entry> &mine, const vector<entry> &theirs,
+              F &f) const;  // merge two sorted runs
+
+ public:
+  using key_type = Key;
+  using mapped_type = T;
+  using value_type = std::pair<const Key, T>;
+  using size_type = size_t;
+
+  merkle_map() {}
+  merkle_map(std::initializer_list<value_type> const &items) {
+    for (const auto &item : items) insert_or_assign(item.first, item.second);
+  }
+
+  static uint64_t entry_hash(const Key &key, const T &value) {
+    uint64_t h = uint64_t(std::hash<Key>()(key)) * 0x9E3779B97F4A7C15ull ^
+                 uint64_t(std::hash<T>()(value));
+    h ^= h >> 30;  // splitmix64 finalizer
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    return h ^ (h >> 31);
+  }
+
+  bool insert(const Key &key, const T &value);  // false if key is taken
+  void insert_or_assign(const Key &key, const T &value);
+  bool erase(const Key &key);
+  void clear() { tree.clear(); }
+
+  const T &at(const Key &key) const { return tree.find_value(key).value; }
+  bool contains(const Key &key) const { return tree.contains(key); }
+  bool empty() const { return tree.get_size() == 0; }
+  size_type size() const { return tree.get_size(); }
+  template <typename F>
+  void for_each(F f) const {  // f(key, value) in key order
+    tree.in_order([&f](const Key &key, const merkle_value<T> &value) {
+      f(key, value.value);
+    });
+  }
+
+  uint64_t root_hash() const {  // equal for equal contents
+    summary all = below(nullptr);
+    return all.sum ^ all.count * 0x9E3779B97F4A7C15ull;
+  }
+  merkle_digest<Key> digest() const;
+
+  // f(key, merkle_change) for every key that differs, in key order
+  template <typename F>
+  void diff(const merkle_map &other, F f) const {
+    diff_range(other, nullptr, nullptr, f);
+  }
+  template <typename F>
+  void diff(const merkle_digest<Key> &other, F f) const;
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename T, typename Compare, typename Balance>
+bool merkle_map<Key, T, Compare, Balance>::insert(const Key &key,
+                                                  const T &value) {
+  if (tree.contains(key)) return false;
+  uint64_t hash = entry_hash(key, value);
+  tree << std::pair<Key, merkle_value<T>>(key, {value, hash, hash, 1});
+  return true;
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+void merkle_map<Key, T, Compare, Balance>::insert_or_assign(const Key &key,
+                                                            const T &value) {
+  tree >> key;  // the new hash has to reach the sums above it
+  uint64_t hash = entry_hash(key, value);
+  tree << std::pair<Key, merkle_value<T>>(key, {value, hash, hash, 1});
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+bool merkle_map<Key, T, Compare, Balance>::erase(const Key &key) {
+  if (!tree.contains(key)) return false;
+  tree >> key;
+  return true;
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+typename merkle_map<Key, T, Compare, Balance>::summary
+merkle_map<Key, T, Compare, Balance>::below(const Key *bound) const {
+  summary out;
+  auto nd = tree.get_root();
+  if (!bound) {
+    if (nd) out = {nd->value2.sum, nd->value2.count};
+    return out;
+  }
+  Compare comp = tree.key_comp();
+  while (nd) {
+    if (comp(nd->value, *bound)) {  // nd and its left subtree are below
+      out.sum += nd->value2.hash;
+      out.count++;
+      if (nd->left) {
+        out.sum += nd->left->value2.sum;
+        out.count += nd->left->value2.count;
+      }
+      nd = nd->right;
+    } else {
+      nd = nd->left;
+    }
+  }
+  return out;
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+const Key &merkle_map<Key, T, Compare, Balance>::select(uint64_t rank) const {
+  auto nd = tree.get_root();
+  while (true) {
+    uint64_t left = nd->left ? nd->left->value2.count : 0;
+    if (rank == left) return nd->value;
+    if (rank < left) {
+      nd = nd->left;
+    } else {
+      rank -= left + 1;
+      nd = nd->right;
+    }
+  }
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+void merkle_map<Key, T, Compare, Balance>::entries(const Key *lo,
+                                                   const Key *hi,
+                                                   vector<entry> &out) const {
+  Compare comp = tree.key_comp();
+  auto nd = tree.get_root();
+  decltype(nd) first = nullptr;  // the smallest key not below lo
+  while (nd) {
+    if (lo && comp(nd->value, *lo)) {
+      nd = nd->right;
+    } else {
+      first = nd;
+      nd = nd->left;
+    }
+  }
+  for (nd = first; nd && (!hi || comp(nd->value, *hi));) {
+    out.push_back({&nd->value, nd->value2.hash});
+    if (nd->right) {  // in-order successor by parent links
+      nd = nd->right;
+      while (nd->left) nd = nd->left;
+    } else {
+      while (nd->parent && nd == nd->parent->right) nd = nd->parent;
+      nd = nd->parent;
+    }
+  }
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+template <typename F>
+void merkle_map<Key, T, Compare, Balance>::report(
+    const vector<entry> &mine, const vector<entry> &theirs, F &f) const {
+  Compare comp = tree.key_comp();
+  size_t i = 0, j = 0;
+  while (i < mine.size() || j < theirs.size()) {
+    if (j == theirs.size() ||
+        (i < mine.size() && comp(*mine[i].key, *theirs[j].key))) {
+      f(*mine[i++].key, merkle_change::only_here);
+    } else if (i == mine.size() || comp(*theirs[j].key, *mine[i].key)) {
+      f(*theirs[j++].key, merkle_change::only_there);
+    } else {
+      if (mine[i].hash != theirs[j].hash)
+        f(*mine[i].key, merkle_change::changed);
+      i++;
+      j++;
+    }
+  }
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+template <typename F>
+void merkle_map<Key, T, Compare, Balance>::diff_range(const merkle_map &other,
+                                                      const Key *lo,
+                                                      const Key *hi,
+                                                      F &f) const {
+  summary mine = range(lo, hi), theirs = other.range(lo, hi);
+  if (mine.sum == theirs.sum && mine.count == theirs.count) return;
+  if (mine.count + theirs.count <= kLeafEntries) {
+    vector<entry> here, there;
+    entries(lo, hi, here);
+    other.entries(lo, hi, there);
+    report(here, there, f);
+    return;
+  }
+  // split at the middle key of the fuller side, each half of it then holds
+  // at least a quarter of its keys less
+  const merkle_map &fuller = mine.count >= theirs.count ? *this : other;
+  uint64_t count = std::max(mine.count, theirs.count);
+  uint64_t first = lo ? fuller.below(lo).count : 0;
+  const Key *middle = &fuller.select(first + count / 2);
+  diff_range(other, lo, middle, f);
+  diff_range(other, middle, hi, f);
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+merkle_digest<Key> merkle_map<Key, T, Compare, Balance>::digest() const {
+  vector<Key> keys;
+  vector<uint64_t> hashes;
+  keys.reserve(size());
+  hashes.reserve(size());
+  tree.in_order([&keys, &hashes](const Key &key, const merkle_value<T> &v) {
+    keys.push_back(key);
+    hashes.push_back(v.hash);
+  });
+  return merkle_digest<Key>(std::move(keys), std::move(hashes));
+}
+
+template <typename Key, typename T, typename Compare, typename Balance>
+template <typename F>
+void merkle_map<Key, T, Compare, Balance>::diff(
+    const merkle_digest<Key> &other, F f) const {
+  // block b covers [key of its first entry, key of the next block's first
+  // entry); the first block also takes every key below it, the last every
+  // key above
+  constexpr size_t kBlock = merkle_digest<Key>::kBlock;
+  size_t count = other.size();
+  vector<entry> here, there;
+  for (size_t first = 0, block = 0; first < count || first == 0;
+       first += kBlock, block++) {
+    size_t last = std::min(first + kBlock, count);
+    const Key *lo = first == 0 ? nullptr : &other.key(first);
+    const Key *hi = last == count ? nullptr : &other.key(last);
+    summary mine = range(lo, hi);
+    if (count > 0 && mine.sum == other.block_sum(block) &&
+        mine.count == last - first)
+      continue;
+    here.clear();
+    there.clear();
+    entries(lo, hi, here);
+    for (size_t i = first; i < last; i++)
+      there.push_back({&other.key(i), other.hash(i)});
+    report(here, there, f);
+    if (count == 0) break;
+  }
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_MERKLE_MAP_MY_MERKLE_MAP_H_
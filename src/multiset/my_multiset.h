@@ -3,11 +3,13 @@
 #include <iostream>
 
 #include "../bitree/my_bitree.h"
+#include "../serial/my_serial.h"
 #include "../vector/my_vector.h"
 
 namespace my {
 
-template <typename Key>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Balance = rb_balance>
 class multiset {
  private:
   using key_type = Key;
@@ -15,19 +17,34 @@ class multiset {
   using reference = value_type&;
   using const_reference = const value_type&;
   using size_type = size_t;
-  bitree<Key, Key> tree;
+  using tree_type = bitree<Key, size_type, Compare, Balance, subtree_size>;
+  tree_type tree;  // value2 is the subtree size, for order statistics
+
+  static constexpr size_type kMergeRatio = 16;  // size skew to merge by
+                                                // inserts, not a rebuild
+
+  void flatten(vector<Key>& keys) const {  // sorted copy
+    keys.reserve(tree.get_size());
+    tree.in_order(
+        [&keys](const Key& key, const size_type&) { keys.push_back(key); });
+  }
 
  public:
-  using iterator = typename bitree<Key, Key>::tree_iterator;
+  using iterator = typename tree_type::tree_iterator;
   multiset() {};
+  explicit multiset(const Compare& order) : tree(order) {}
   multiset(std::initializer_list<value_type> const& items) {
     for (const auto& item : items) {
-      tree << std::make_pair(item, item);
+      tree << std::make_pair(item, size_type(1));
     }
   };
   multiset(const multiset& other) : tree(other.tree) {}
   multiset(multiset&& other) noexcept : tree(std::move(other.tree)) {}
   ~multiset() { tree.clear(); }
+  multiset& operator=(const multiset& other) {  // shares nodes as copies do
+    tree = other.tree;
+    return *this;
+  }
   multiset& operator=(multiset&& other) noexcept {
     if (this != &other) {
       tree = std::move(other.tree);
@@ -38,7 +55,7 @@ class multiset {
   multiset& operator=(std::initializer_list<value_type> const& items) {
     tree.clear();
     for (const auto& item : items) {
-      tree << std::make_pair(item, item);
+      tree << std::make_pair(item, size_type(1));
     }
     return *this;
   }
@@ -56,15 +73,17 @@ class multiset {
   size_type max_size() { return 11111; }
 
   void clear() { tree.clear(); }
-  iterator insert(const value_type& value) {
-    iterator it = tree.begin();
-    tree << std::make_pair(value, value);
-    return it.set(value);
+  iterator insert(const value_type& value) {  // to the first of its equals
+    tree << std::make_pair(value, size_type(1));
+    return at_rank(count_below(value, false));
   }
-  bool erase(const value_type& value) {
-    if (!this->contains(value)) return false;
+  void add(const value_type& value) {  // insert without making an iterator
+    tree << std::make_pair(value, size_type(1));
+  }
+  bool erase(const value_type& value) {  // one of the equal elements
+    size_type before = tree.get_size();
     tree >> value;
-    return true;
+    return tree.get_size() != before;
   }
   iterator erase(iterator it) {
     iterator tmp = it;
@@ -73,52 +92,109 @@ class multiset {
     return tmp;
   }
   void merge(multiset& other) {
-    iterator it = other.begin();
-    for (size_type i = 0; i < other.size(); i++) {
-      this->insert(it.cget());
-      ++it;
+    if (other.size() * kMergeRatio < size()) {  // few new keys, insert each
+      other.tree.in_order([this](const Key& key, const size_type&) {
+        this->add(key);  // other is only read, stays shared
+      });
+      return;
+    }
+    vector<Key> keys, other_keys, merged;
+    flatten(keys);
+    other.flatten(other_keys);
+    merged.reserve(keys.size() + other_keys.size());
+    size_type i = 0, j = 0;
+    while (i < keys.size() || j < other_keys.size()) {
+      if (j == other_keys.size() ||
+          (i < keys.size() && !tree.key_comp()(other_keys[j], keys[i])))
+        merged.push_back(keys[i++]);
+      else
+        merged.push_back(other_keys[j++]);
     }
+    tree.build_sorted(merged.data(), nullptr, merged.size());
   }
 
-  iterator find(const Key& key) {
-    iterator it = this->end();
-    if (!this->contains(key)) return it;
-    return it.set(key);
+  // the lookups below also take any type Compare orders against Key when
+  // Compare is transparent, without building a Key
+  iterator find(const Key& key) { return find_of(key); }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) {
+    return find_of(key);
   }
 
-  bool contains(const Key& key) {
-    try {
-      tree.find_value(key);
-      return true;
-    } catch (const std::out_of_range& e) {
-      return false;
-    }
+  bool contains(const Key& key) const { return tree.contains(key); }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {
+    return tree.contains(key);
   }
 
-  size_type count(const Key& key) {
-    auto pos = this->equal_range(key);
-    return pos.second.position - pos.first.position;
+  size_type count(const Key& key) const {  // by rank, no iterators
+    return count_below(key, true) - count_below(key, false);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return count_below(key, true) - count_below(key, false);
   }
 
   std::pair<iterator, iterator> equal_range(const Key& key) {
-    iterator it2 = this->begin();
-    iterator it1 = this->begin();
-    while (it2.cget() <= key) ++it2;
-    if (this->contains(key)) return std::make_pair(it1.set(key), it2);
-    it1 = it2;
-    return std::make_pair(it1, it2);
+    return equal_range_of(key);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  std::pair<iterator, iterator> equal_range(const K& key) {
+    return equal_range_of(key);
+  }
+
+  iterator lower_bound(const Key& key) { return first_greater(key); }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator lower_bound(const K& key) {
+    return first_greater(key);
+  }
+
+  iterator upper_bound(const Key& key) { return first_not_less(key); }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator upper_bound(const K& key) {
+    return first_not_less(key);
+  }
+
+  Compare key_comp() const { return tree.key_comp(); }
+
+  // order statistics in O(log n) from the subtree sizes
+  const Key& select(size_type k) const {  // k-th smallest, from 0
+    if (k >= tree.get_size()) throw std::out_of_range("Rank out of range");
+    return node_at(k)->value;
+  }
+  size_type rank(const Key& key) const {  // elements less than key
+    return count_below(key, false);
   }
 
-  iterator lower_bound(const Key& key) {
-    iterator it = this->begin();
-    while (it.cget() <= key) ++it;
-    return it;
+  // node relocation for locality, see bitree::compact
+  void compact(compact_order order = compact_order::in_order) {
+    tree.compact(order);
   }
+  bool compact_step(size_type budget = 256) {
+    return tree.compact_step(budget);
+  }
+  double fragmentation() const { return tree.fragmentation(); }
 
-  iterator upper_bound(const Key& key) {
-    iterator it = this->begin();
-    while (it.cget() < key) ++it;
-    return it;
+  void serialize(std::ostream& os) const {  // sorted binary dump
+    vector<Key> keys;
+    flatten(keys);
+    serial::write_header<Key, Key>(os, serial::kMultiset, keys.size());
+    serial::write_block(os, keys.data(), keys.size());
+  }
+
+  void deserialize(std::istream& is) {  // O(n) reload through bulk build
+    size_type count = serial::read_header<Key, Key>(is, serial::kMultiset);
+    vector<Key> keys = serial::read_vector<Key>(is, count);
+    for (size_type i = 1; i < count; i++)
+      if (tree.key_comp()(keys[i], keys[i - 1]))
+        throw std::invalid_argument("Container stream keys are not sorted");
+    tree.build_sorted(keys.data(), nullptr, count);
   }
 
   template <typename... Args>
@@ -127,6 +203,56 @@ class multiset {
     ((out.push_back(std::make_pair(this->insert(args), true))), ...);
     return out;
   }
+
+ private:
+  template <typename K>
+  size_type count_below(const K& key, bool or_equal) const {
+    Compare comp = tree.key_comp();
+    size_type below = 0;
+    auto nd = tree.get_root();
+    while (nd) {
+      if (or_equal ? !comp(key, nd->value) : comp(nd->value, key)) {
+        below += 1 + (nd->left ? nd->left->value2 : 0);
+        nd = nd->right;
+      } else {
+        nd = nd->left;
+      }
+    }
+    return below;
+  }
+  auto node_at(size_type k) const {  // k < size()
+    auto nd = tree.get_root();
+    while (true) {
+      size_type left = nd->left ? nd->left->value2 : 0;
+      if (k == left) return nd;
+      if (k < left) {
+        nd = nd->left;
+      } else {
+        k -= left + 1;
+        nd = nd->right;
+      }
+    }
+  }
+  iterator at_rank(size_type position) {  // end() past the last one
+    return tree.iterator_at(position);
+  }
+  template <typename K>
+  iterator find_of(const K& key) {
+    if (!tree.contains(key)) return this->end();
+    return at_rank(count_below(key, false));
+  }
+  template <typename K>
+  iterator first_greater(const K& key) {  // end() if there is none
+    return at_rank(count_below(key, true));
+  }
+  template <typename K>
+  iterator first_not_less(const K& key) {
+    return at_rank(count_below(key, false));
+  }
+  template <typename K>
+  std::pair<iterator, iterator> equal_range_of(const K& key) {
+    return std::make_pair(first_not_less(key), first_greater(key));
+  }
 };
 
 }  // namespace my
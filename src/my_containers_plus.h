@@ -5,5 +5,22 @@
 
 #include "multiset/my_multiset.h"
 #include "array/my_array.h"
+#include "frozen_map/my_frozen_map.h"
+#include "concurrent_skiplist/my_concurrent_skiplist.h"
+#include "durable_map/my_durable_map.h"
+#include "hashtable/my_hashtable.h"
+#include "concurrent_hash_map/my_concurrent_hash_map.h"
+#include "art/my_art.h"
+#include "compact_map/my_compact_map.h"
+#include "interval_map/my_interval_map.h"
+#include "merkle_map/my_merkle_map.h"
+#include "windowed_quantiles/my_windowed_quantiles.h"
+#include "lru_cache/my_lru_cache.h"
+#include "expiring_map/my_expiring_map.h"
+#include "sketch/my_sketch.h"
+#include "roaring_set/my_roaring_set.h"
+#include "sorted_ops/my_sorted_ops.h"
+#include "flat_map/my_flat_map.h"
+#include "mapped_table/my_mapped_table.h"
 
 #endif
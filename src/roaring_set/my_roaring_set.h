@@ -0,0 +1,816 @@
+#ifndef CONTAINERS_SRC_ROARING_SET_MY_ROARING_SET_H_
+#define CONTAINERS_SRC_ROARING_SET_MY_ROARING_SET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// Set of 32 bit unsigned integers in the roaring layout. Values are split
+// by their high 16 bits into chunks, and each chunk keeps the low 16 bits
+// in one of three containers:
+//   array   sorted values, up to 4096 of them, 2 bytes each
+//   bitmap  65536 bits in 1024 words once there are more, 8 KiB
+//   run     sorted (start, length - 1) pairs, made by run_optimize where
+//           the values come in long runs
+// A dense range of a million ids takes 16 bitmaps, or 16 runs, instead of
+// a million tree nodes. Set algebra goes chunk by chunk: bitmaps combine
+// a word at a time in loops the compiler vectorizes, arrays merge, runs
+// merge as intervals. Any change invalidates iterators.
+class roaring_set {
+ private:
+  struct chunk;
+
+ public:
+  using key_type = uint32_t;
+  using value_type = uint32_t;
+  using size_type = size_t;
+  static constexpr uint32_t kArrayMax = 4096;  // values of an array chunk
+
+  //------------------ITERATOR------------------//
+  class iterator {  // ordered, forward
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = uint32_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const uint32_t *;
+    using reference = uint32_t;
+
+    iterator() {}
+    value_type operator*() const {
+      return uint32_t(owner->chunks[at].key) << 16 | low;
+    }
+    iterator &operator++() {
+      owner->advance(*this);
+      return *this;
+    }
+    bool operator==(const iterator &other) const {
+      return at == other.at && low == other.low;
+    }
+    bool operator!=(const iterator &other) const { return !(*this == other); }
+
+   private:
+    const roaring_set *owner = nullptr;
+    size_t at = 0;      // chunk
+    uint32_t slot = 0;  // index in an array chunk or of a run
+    uint32_t low = 0;   // low 16 bits of the value
+    friend class roaring_set;
+  };
+
+  roaring_set() {}
+  roaring_set(std::initializer_list<value_type> const &items) {
+    for (value_type value : items) insert(value);
+  }
+  roaring_set(const roaring_set &other) = default;
+  roaring_set(roaring_set &&other) noexcept
+      : chunks(std::move(other.chunks)), items(other.items) {
+    other.items = 0;
+  }
+  roaring_set &operator=(const roaring_set &other) {
+    if (this != &other) {
+      roaring_set tmp(other);
+      *this = std::move(tmp);
+    }
+    return *this;
+  }
+  roaring_set &operator=(roaring_set &&other) {
+    chunks = std::move(other.chunks);
+    items = other.items;
+    other.items = 0;
+    return *this;
+  }
+
+  iterator begin() const { return lower_bound(0); }
+  iterator end() const {
+    iterator it;
+    it.owner = this;
+    it.at = chunks.size();
+    return it;
+  }
+
+  bool empty() const { return items == 0; }
+  size_type size() const { return items; }
+  size_type memory_usage() const;  // bytes, with the chunk payloads
+
+  void clear() {
+    chunks.clear();
+    items = 0;
+  }
+  std::pair<iterator, bool> insert(value_type value);
+  bool erase(value_type value);
+  iterator erase(iterator it) {  // the next element
+    value_type value = *it;
+    erase(value);
+    return lower_bound(value);
+  }
+  void merge(const roaring_set &other) { *this |= other; }
+
+  bool contains(value_type value) const;
+  size_type count(value_type value) const { return contains(value); }
+  iterator find(value_type value) const {
+    iterator it = lower_bound(value);
+    return it != end() && *it == value ? it : end();
+  }
+  iterator lower_bound(value_type value) const;
+
+  roaring_set &operator|=(const roaring_set &other);  // union
+  roaring_set &operator&=(const roaring_set &other);  // intersection
+  roaring_set &operator-=(const roaring_set &other);  // difference
+  friend roaring_set operator|(roaring_set a, const roaring_set &b) {
+    return a |= b;
+  }
+  friend roaring_set operator&(roaring_set a, const roaring_set &b) {
+    return a &= b;
+  }
+  friend roaring_set operator-(roaring_set a, const roaring_set &b) {
+    return a -= b;
+  }
+  bool operator==(const roaring_set &other) const;
+  bool operator!=(const roaring_set &other) const { return !(*this == other); }
+
+  // Turns chunks into runs where that is smaller, and runs back where it
+  // is not; true if a chunk changed.
+  bool run_optimize();
+
+ private:
+  enum kind : uint8_t { kArray, kBitmap, kRun };
+  static constexpr size_t kWords = 1024;  // of a bitmap
+  static constexpr size_t kNone = ~size_t(0);
+
+  struct chunk {
+    uint16_t key = 0;  // high 16 bits of the values
+    uint8_t type = kArray;
+    uint32_t card = 0;        // values in the chunk
+    vector<uint16_t> values;  // array values, or run starts and lengths - 1
+    vector<uint64_t> words;   // bitmap
+  };
+
+  vector<chunk> chunks;  // by key
+  size_type items = 0;  // values in all chunks
+
+  size_t chunk_at(uint16_t key) const;  // first chunk with key >= key
+  void drop_chunks_if_empty();
+  void recount();
+  void seek(iterator &it, uint32_t from) const;  // first low >= from
+  void advance(iterator &it) const;
+
+  static size_t lower(const vector<uint16_t> &values, uint16_t x) {
+    return std::lower_bound(values.begin(), values.end(), x) -
+           values.begin();
+  }
+  static size_t run_before(const vector<uint16_t> &runs, uint32_t x);
+  static uint32_t run_last(const vector<uint16_t> &runs, size_t i) {
+    return uint32_t(runs[2 * i]) + runs[2 * i + 1];
+  }
+  static void push_run(vector<uint16_t> &runs, uint32_t first,
+                       uint32_t last) {
+    runs.push_back(uint16_t(first));
+    runs.push_back(uint16_t(last - first));
+  }
+  static bool has(const chunk &c, uint16_t x);
+  static bool add(chunk &c, uint16_t x);
+  static bool remove(chunk &c, uint16_t x);
+  template <typename F>
+  static void for_each_low(const chunk &c, F f);  // in order
+  static size_t count_runs(const chunk &c);
+  static void to_bitmap(chunk &c);
+  static void to_array(chunk &c);
+  static void to_runs(chunk &c);
+  static void settle(chunk &c);  // the smallest form after a change
+
+  static void set_range(uint64_t *words, uint32_t first, uint32_t last);
+  static void clear_range(uint64_t *words, uint32_t first, uint32_t last);
+  static uint32_t popcount(const uint64_t *words);
+  static uint32_t run_card(const vector<uint16_t> &runs);
+
+  static void or_into(chunk &a, const chunk &b);
+  static void and_into(chunk &a, const chunk &b);
+  static void andnot_into(chunk &a, const chunk &b);
+};
+
+//------------------FUNCTIONS------------------//
+inline std::pair<roaring_set::iterator, bool> roaring_set::insert(
+    value_type value) {
+  uint16_t high = uint16_t(value >> 16), low = uint16_t(value);
+  size_t at = chunk_at(high);
+  if (at == chunks.size() || chunks[at].key != high) {
+    chunk fresh;
+    fresh.key = high;
+    chunks.insert(chunks.begin() + at, fresh);
+  }
+  bool added = add(chunks[at], low);
+  if (added) ++items;
+  return {find(value), added};
+}
+
+inline bool roaring_set::erase(value_type value) {
+  uint16_t high = uint16_t(value >> 16), low = uint16_t(value);
+  size_t at = chunk_at(high);
+  if (at == chunks.size() || chunks[at].key != high) return false;
+  if (!remove(chunks[at], low)) return false;
+  --items;
+  if (chunks[at].card == 0) drop_chunks_if_empty();
+  return true;
+}
+
+inline bool roaring_set::contains(value_type value) const {
+  size_t at = chunk_at(uint16_t(value >> 16));
+  return at < chunks.size() && chunks[at].key == value >> 16 &&
+         has(chunks[at], uint16_t(value));
+}
+
+inline roaring_set::iterator roaring_set::lower_bound(value_type value) const {
+  iterator it;
+  it.owner = this;
+  it.at = chunk_at(uint16_t(value >> 16));
+  bool same = it.at < chunks.size() && chunks[it.at].key == value >> 16;
+  seek(it, same ? value & 0xFFFF : 0);
+  return it;
+}
+
+inline roaring_set::size_type roaring_set::memory_usage() const {
+  size_type bytes = sizeof(*this) + chunks.capacity() * sizeof(chunk);
+  for (const chunk &c : chunks)
+    bytes += c.values.capacity() * sizeof(uint16_t) +
+             c.words.capacity() * sizeof(uint64_t);
+  return bytes;
+}
+
+inline roaring_set &roaring_set::operator|=(const roaring_set &other) {
+  if (this == &other) return *this;
+  size_t fresh = 0;  // chunks only other has
+  for (size_t i = 0, j = 0; j < other.chunks.size();) {
+    if (i == chunks.size() || other.chunks[j].key < chunks[i].key) {
+      ++fresh;
+      ++j;
+    } else {
+      if (chunks[i].key == other.chunks[j].key) ++j;
+      ++i;
+    }
+  }
+  size_t i = chunks.size(), j = other.chunks.size();
+  for (size_t k = 0; k < fresh; k++) chunks.push_back(chunk());
+  for (size_t w = chunks.size(); j > 0;) {  // merge from the back, in place
+    const chunk &b = other.chunks[j - 1];
+    if (i > 0 && chunks[i - 1].key > b.key) {
+      chunks[--w] = std::move(chunks[--i]);
+    } else if (i > 0 && chunks[i - 1].key == b.key) {
+      or_into(chunks[i - 1], b);
+      chunks[--w] = std::move(chunks[--i]);
+      --j;
+    } else {
+      chunks[--w] = chunk(b);
+      --j;
+    }
+  }
+  recount();
+  return *this;
+}
+
+inline roaring_set &roaring_set::operator&=(const roaring_set &other) {
+  if (this == &other) return *this;
+  size_t j = 0;
+  for (chunk &a : chunks) {
+    while (j < other.chunks.size() && other.chunks[j].key < a.key) ++j;
+    if (j < other.chunks.size() && other.chunks[j].key == a.key)
+      and_into(a, other.chunks[j]);
+    else
+      a.card = 0;
+  }
+  drop_chunks_if_empty();
+  recount();
+  return *this;
+}
+
+inline roaring_set &roaring_set::operator-=(const roaring_set &other) {
+  if (this == &other) {
+    clear();
+    return *this;
+  }
+  size_t j = 0;
+  for (chunk &a : chunks) {
+    while (j < other.chunks.size() && other.chunks[j].key < a.key) ++j;
+    if (j < other.chunks.size() && other.chunks[j].key == a.key)
+      andnot_into(a, other.chunks[j]);
+  }
+  drop_chunks_if_empty();
+  recount();
+  return *this;
+}
+
+inline bool roaring_set::operator==(const roaring_set &other) const {
+  if (items != other.items || chunks.size() != other.chunks.size())
+    return false;
+  iterator a = begin(), b = other.begin();
+  for (size_type i = 0; i < items; i++, ++a, ++b)
+    if (*a != *b) return false;
+  return true;
+}
+
+inline bool roaring_set::run_optimize() {
+  bool changed = false;
+  for (chunk &c : chunks) {
+    if (c.type == kRun) {
+      uint8_t was = c.type;
+      settle(c);
+      changed |= c.type != was;
+      continue;
+    }
+    size_t now = c.type == kArray ? c.card * sizeof(uint16_t) : 8192;
+    if (count_runs(c) * 4 < now) {
+      to_runs(c);
+      changed = true;
+    } else if (c.type == kArray) {
+      c.values.shrink_to_fit();
+    }
+  }
+  return changed;
+}
+
+inline size_t roaring_set::chunk_at(uint16_t key) const {
+  size_t lo = 0, hi = chunks.size();
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (chunks[mid].key < key)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+inline void roaring_set::drop_chunks_if_empty() {
+  size_t kept = 0;  // moves, my::vector::erase would copy the payloads
+  for (size_t i = 0; i < chunks.size(); i++)
+    if (chunks[i].card != 0) {
+      if (kept != i) chunks[kept] = std::move(chunks[i]);
+      ++kept;
+    }
+  while (chunks.size() > kept) chunks.pop_back();
+}
+
+inline void roaring_set::recount() {
+  items = 0;
+  for (const chunk &c : chunks) items += c.card;
+}
+
+inline void roaring_set::seek(iterator &it, uint32_t from) const {
+  for (; it.at < chunks.size(); ++it.at, from = 0) {
+    const chunk &c = chunks[it.at];
+    if (from > 0xFFFF) continue;
+    if (c.type == kArray) {
+      size_t i = lower(c.values, uint16_t(from));
+      if (i < c.values.size()) {
+        it.slot = uint32_t(i);
+        it.low = c.values[i];
+        return;
+      }
+    } else if (c.type == kBitmap) {
+      size_t k = from >> 6;
+      uint64_t word = c.words[k] & (~uint64_t(0) << (from & 63));
+      while (!word && ++k < kWords) word = c.words[k];
+      if (word) {
+        it.low = uint32_t(k * 64 + __builtin_ctzll(word));
+        return;
+      }
+    } else {
+      size_t i = run_before(c.values, from);
+      if (i != kNone && from <= run_last(c.values, i)) {
+        it.slot = uint32_t(i);
+        it.low = from;
+        return;
+      }
+      if (i + 1 < c.values.size() / 2) {  // kNone + 1 is the first run
+        it.slot = uint32_t(i + 1);
+        it.low = c.values[2 * (i + 1)];
+        return;
+      }
+    }
+  }
+  it.slot = 0;
+  it.low = 0;
+}
+
+inline void roaring_set::advance(iterator &it) const {
+  const chunk &c = chunks[it.at];
+  if (c.type == kArray && it.slot + 1 < c.values.size()) {
+    it.low = c.values[++it.slot];
+    return;
+  }
+  if (c.type == kRun) {
+    if (it.low < run_last(c.values, it.slot)) {
+      ++it.low;
+      return;
+    }
+    if (it.slot + 1 < c.values.size() / 2) {
+      it.low = c.values[2 * ++it.slot];
+      return;
+    }
+  }
+  seek(it, it.low + 1);
+}
+
+inline size_t roaring_set::run_before(const vector<uint16_t> &runs,
+                                      uint32_t x) {
+  size_t lo = 0, hi = runs.size() / 2;  // first run that starts after x
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (runs[2 * mid] <= x)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo - 1;  // kNone when there is none
+}
+
+inline bool roaring_set::has(const chunk &c, uint16_t x) {
+  if (c.type == kArray) {
+    size_t i = lower(c.values, x);
+    return i < c.values.size() && c.values[i] == x;
+  }
+  if (c.type == kBitmap) return c.words[x >> 6] >> (x & 63) & 1;
+  size_t i = run_before(c.values, x);
+  return i != kNone && x <= run_last(c.values, i);
+}
+
+inline bool roaring_set::add(chunk &c, uint16_t x) {
+  if (c.type == kArray) {
+    size_t i = lower(c.values, x);
+    if (i < c.values.size() && c.values[i] == x) return false;
+    if (c.card < kArrayMax) {
+      c.values.insert(c.values.begin() + i, x);
+      ++c.card;
+      return true;
+    }
+    to_bitmap(c);
+  }
+  if (c.type == kBitmap) {
+    uint64_t &word = c.words[x >> 6], bit = uint64_t(1) << (x & 63);
+    if (word & bit) return false;
+    word |= bit;
+    ++c.card;
+    return true;
+  }
+  vector<uint16_t> &runs = c.values;
+  size_t i = run_before(runs, x), next = i + 1;
+  if (i != kNone) {
+    uint32_t last = run_last(runs, i);
+    if (x <= last) return false;
+    if (x == last + 1) {  // grows run i, maybe into the next one
+      ++runs[2 * i + 1];
+      if (next < runs.size() / 2 && runs[2 * next] == x + 1u) {
+        runs[2 * i + 1] = uint16_t(run_last(runs, next) - runs[2 * i]);
+        runs.erase(runs.begin() + 2 * next);
+        runs.erase(runs.begin() + 2 * next);
+      }
+      ++c.card;
+      return true;
+    }
+  }
+  if (next < runs.size() / 2 && runs[2 * next] == x + 1u) {
+    --runs[2 * next];
+    ++runs[2 * next + 1];
+  } else {
+    runs.insert(runs.begin() + 2 * next, uint16_t(0));
+    runs.insert(runs.begin() + 2 * next, x);
+  }
+  ++c.card;
+  settle(c);
+  return true;
+}
+
+inline bool roaring_set::remove(chunk &c, uint16_t x) {
+  if (c.type == kArray) {
+    size_t i = lower(c.values, x);
+    if (i == c.values.size() || c.values[i] != x) return false;
+    c.values.erase(c.values.begin() + i);
+    --c.card;
+    return true;
+  }
+  if (c.type == kBitmap) {
+    uint64_t &word = c.words[x >> 6], bit = uint64_t(1) << (x & 63);
+    if (!(word & bit)) return false;
+    word &= ~bit;
+    --c.card;
+    settle(c);
+    return true;
+  }
+  vector<uint16_t> &runs = c.values;
+  size_t i = run_before(runs, x);
+  if (i == kNone || x > run_last(runs, i)) return false;
+  uint32_t first = runs[2 * i], last = run_last(runs, i);
+  if (first == last) {
+    runs.erase(runs.begin() + 2 * i);
+    runs.erase(runs.begin() + 2 * i);
+  } else if (x == first) {
+    ++runs[2 * i];
+    --runs[2 * i + 1];
+  } else if (x == last) {
+    --runs[2 * i + 1];
+  } else {  // splits the run
+    runs[2 * i + 1] = uint16_t(x - 1 - first);
+    runs.insert(runs.begin() + 2 * i + 2, uint16_t(last - x - 1));
+    runs.insert(runs.begin() + 2 * i + 2, uint16_t(x + 1));
+  }
+  --c.card;
+  if (c.card) settle(c);
+  return true;
+}
+
+template <typename F>
+void roaring_set::for_each_low(const chunk &c, F f) {
+  if (c.type == kArray) {
+    for (uint16_t x : c.values) f(x);
+  } else if (c.type == kBitmap) {
+    for (size_t k = 0; k < kWords; k++)
+      for (uint64_t word = c.words[k]; word; word &= word - 1)
+        f(uint16_t(k * 64 + __builtin_ctzll(word)));
+  } else {
+    for (size_t i = 0; i < c.values.size() / 2; i++)
+      for (uint32_t x = c.values[2 * i]; x <= run_last(c.values, i); x++)
+        f(uint16_t(x));
+  }
+}
+
+inline size_t roaring_set::count_runs(const chunk &c) {
+  if (c.type == kRun) return c.values.size() / 2;
+  size_t runs = 0;
+  if (c.type == kArray) {
+    for (size_t i = 0; i < c.values.size(); i++)
+      runs += i == 0 || c.values[i] != c.values[i - 1] + 1;
+    return runs;
+  }
+  uint64_t carry = 0;  // a run starts at a set bit after a clear one
+  for (size_t k = 0; k < kWords; k++) {
+    uint64_t word = c.words[k];
+    runs += __builtin_popcountll(word & ~(word << 1 | carry));
+    carry = word >> 63;
+  }
+  return runs;
+}
+
+inline void roaring_set::to_bitmap(chunk &c) {
+  vector<uint64_t> words(kWords);
+  if (c.type == kArray) {
+    for (uint16_t x : c.values) words[x >> 6] |= uint64_t(1) << (x & 63);
+  } else if (c.type == kRun) {
+    for (size_t i = 0; i < c.values.size() / 2; i++)
+      set_range(words.begin(), c.values[2 * i], run_last(c.values, i));
+  } else {
+    return;
+  }
+  c.words = std::move(words);
+  c.values = vector<uint16_t>();
+  c.type = kBitmap;
+}
+
+inline void roaring_set::to_array(chunk &c) {
+  if (c.type == kArray) return;
+  vector<uint16_t> values;
+  values.reserve(c.card);
+  for_each_low(c, [&values](uint16_t x) { values.push_back(x); });
+  c.values = std::move(values);
+  c.words = vector<uint64_t>();
+  c.type = kArray;
+}
+
+inline void roaring_set::to_runs(chunk &c) {
+  if (c.type == kRun) return;
+  vector<uint16_t> runs;
+  runs.reserve(2 * count_runs(c));
+  uint32_t first = 0, last = 0;
+  bool open = false;
+  for_each_low(c, [&](uint16_t x) {
+    if (open && x == last + 1) {
+      last = x;
+      return;
+    }
+    if (open) push_run(runs, first, last);
+    first = last = x;
+    open = true;
+  });
+  if (open) push_run(runs, first, last);
+  c.values = std::move(runs);
+  c.words = vector<uint64_t>();
+  c.type = kRun;
+}
+
+inline void roaring_set::settle(chunk &c) {
+  if (c.type == kRun) {
+    size_t other = c.card <= kArrayMax ? c.card * sizeof(uint16_t) : 8192;
+    if (c.values.size() * sizeof(uint16_t) <= other) return;
+    if (c.card <= kArrayMax)
+      to_array(c);
+    else
+      to_bitmap(c);
+  } else if (c.type == kBitmap && c.card <= kArrayMax) {
+    to_array(c);
+  } else if (c.type == kArray && c.card > kArrayMax) {
+    to_bitmap(c);
+  }
+}
+
+inline void roaring_set::set_range(uint64_t *words, uint32_t first,
+                                   uint32_t last) {  // both included
+  size_t a = first >> 6, b = last >> 6;
+  uint64_t head = ~uint64_t(0) << (first & 63);
+  uint64_t tail = ~uint64_t(0) >> (63 - (last & 63));
+  if (a == b) {
+    words[a] |= head & tail;
+    return;
+  }
+  words[a] |= head;
+  for (size_t k = a + 1; k < b; k++) words[k] = ~uint64_t(0);
+  words[b] |= tail;
+}
+
+inline void roaring_set::clear_range(uint64_t *words, uint32_t first,
+                                     uint32_t last) {
+  size_t a = first >> 6, b = last >> 6;
+  uint64_t head = ~uint64_t(0) << (first & 63);
+  uint64_t tail = ~uint64_t(0) >> (63 - (last & 63));
+  if (a == b) {
+    words[a] &= ~(head & tail);
+    return;
+  }
+  words[a] &= ~head;
+  for (size_t k = a + 1; k < b; k++) words[k] = 0;
+  words[b] &= ~tail;
+}
+
+inline uint32_t roaring_set::popcount(const uint64_t *words) {
+  uint32_t bits = 0;
+  for (size_t k = 0; k < kWords; k++) bits += __builtin_popcountll(words[k]);
+  return bits;
+}
+
+inline uint32_t roaring_set::run_card(const vector<uint16_t> &runs) {
+  uint32_t card = 0;
+  for (size_t i = 0; i < runs.size(); i += 2) card += runs[i + 1] + 1u;
+  return card;
+}
+
+inline void roaring_set::or_into(chunk &a, const chunk &b) {
+  if (a.type == kRun && b.type == kRun) {  // interval union
+    vector<uint16_t> runs;
+    size_t i = 0, j = 0, na = a.values.size() / 2, nb = b.values.size() / 2;
+    uint32_t first = 0, last = 0;
+    bool open = false;
+    while (i < na || j < nb) {
+      bool take_a = j == nb || (i < na && a.values[2 * i] <= b.values[2 * j]);
+      const vector<uint16_t> &from = take_a ? a.values : b.values;
+      size_t k = take_a ? i++ : j++;
+      uint32_t s = from[2 * k], e = run_last(from, k);
+      if (open && s <= last + 1) {
+        last = std::max(last, e);
+        continue;
+      }
+      if (open) push_run(runs, first, last);
+      first = s;
+      last = e;
+      open = true;
+    }
+    if (open) push_run(runs, first, last);
+    a.values = std::move(runs);
+    a.card = run_card(a.values);
+    settle(a);
+    return;
+  }
+  if (a.type == kArray && b.type == kArray && a.card + b.card <= kArrayMax) {
+    vector<uint16_t> values;
+    values.reserve(a.card + b.card);
+    size_t i = 0, j = 0;
+    while (i < a.values.size() && j < b.values.size()) {
+      uint16_t x = a.values[i], y = b.values[j];
+      values.push_back(x < y ? x : y);
+      i += x <= y;
+      j += y <= x;
+    }
+    for (; i < a.values.size(); i++) values.push_back(a.values[i]);
+    for (; j < b.values.size(); j++) values.push_back(b.values[j]);
+    a.values = std::move(values);
+    a.card = uint32_t(a.values.size());
+    return;
+  }
+  to_bitmap(a);
+  uint64_t *to = a.words.begin();
+  if (b.type == kBitmap) {
+    const uint64_t *from = b.words.begin();
+    for (size_t k = 0; k < kWords; k++) to[k] |= from[k];
+  } else if (b.type == kArray) {
+    for (uint16_t x : b.values) to[x >> 6] |= uint64_t(1) << (x & 63);
+  } else {
+    for (size_t i = 0; i < b.values.size() / 2; i++)
+      set_range(to, b.values[2 * i], run_last(b.values, i));
+  }
+  a.card = popcount(to);
+  settle(a);
+}
+
+inline void roaring_set::and_into(chunk &a, const chunk &b) {
+  if (a.type == kRun && b.type == kRun) {  // interval intersection
+    vector<uint16_t> runs;
+    size_t i = 0, j = 0, na = a.values.size() / 2, nb = b.values.size() / 2;
+    while (i < na && j < nb) {
+      uint32_t ea = run_last(a.values, i), eb = run_last(b.values, j);
+      uint32_t s = std::max<uint32_t>(a.values[2 * i], b.values[2 * j]);
+      if (s <= std::min(ea, eb)) push_run(runs, s, std::min(ea, eb));
+      if (ea < eb)
+        ++i;
+      else
+        ++j;
+    }
+    a.values = std::move(runs);
+    a.card = run_card(a.values);
+    if (a.card) settle(a);
+    return;
+  }
+  if (a.type == kArray || b.type == kArray) {  // the array side filters
+    const chunk &small = a.type == kArray ? a : b;
+    const chunk &large = a.type == kArray ? b : a;
+    vector<uint16_t> values;
+    if (large.type == kArray) {  // merge
+      size_t i = 0, j = 0;
+      while (i < small.values.size() && j < large.values.size()) {
+        uint16_t x = small.values[i], y = large.values[j];
+        if (x == y) values.push_back(x);
+        i += x <= y;
+        j += y <= x;
+      }
+    } else {
+      for (uint16_t x : small.values)
+        if (has(large, x)) values.push_back(x);
+    }
+    a.values = std::move(values);
+    a.words = vector<uint64_t>();
+    a.type = kArray;
+    a.card = uint32_t(a.values.size());
+    return;
+  }
+  to_bitmap(a);
+  uint64_t *to = a.words.begin();
+  if (b.type == kBitmap) {
+    const uint64_t *from = b.words.begin();
+    for (size_t k = 0; k < kWords; k++) to[k] &= from[k];
+  } else {  // clear the gaps between the runs of b
+    uint32_t next = 0;
+    for (size_t i = 0; i < b.values.size() / 2; i++) {
+      if (b.values[2 * i] > next) clear_range(to, next, b.values[2 * i] - 1u);
+      next = run_last(b.values, i) + 1;
+    }
+    if (next <= 0xFFFF) clear_range(to, next, 0xFFFF);
+  }
+  a.card = popcount(to);
+  if (a.card) settle(a);
+}
+
+inline void roaring_set::andnot_into(chunk &a, const chunk &b) {
+  if (a.type == kRun && b.type == kRun) {  // interval difference
+    vector<uint16_t> runs;
+    size_t j = 0, nb = b.values.size() / 2;
+    for (size_t i = 0; i < a.values.size() / 2; i++) {
+      uint32_t s = a.values[2 * i], e = run_last(a.values, i);
+      while (j < nb && run_last(b.values, j) < s) ++j;
+      for (size_t k = j; k < nb && b.values[2 * k] <= e && s <= e; k++) {
+        if (b.values[2 * k] > s) push_run(runs, s, b.values[2 * k] - 1u);
+        s = std::max(s, run_last(b.values, k) + 1);
+      }
+      if (s <= e) push_run(runs, s, e);
+    }
+    a.values = std::move(runs);
+    a.card = run_card(a.values);
+    if (a.card) settle(a);
+    return;
+  }
+  if (a.type == kArray) {
+    vector<uint16_t> values;
+    for (uint16_t x : a.values)
+      if (!has(b, x)) values.push_back(x);
+    a.values = std::move(values);
+    a.card = uint32_t(a.values.size());
+    return;
+  }
+  to_bitmap(a);
+  uint64_t *to = a.words.begin();
+  if (b.type == kBitmap) {
+    const uint64_t *from = b.words.begin();
+    for (size_t k = 0; k < kWords; k++) to[k] &= ~from[k];
+  } else if (b.type == kArray) {
+    for (uint16_t x : b.values) to[x >> 6] &= ~(uint64_t(1) << (x & 63));
+  } else {
+    for (size_t i = 0; i < b.values.size() / 2; i++)
+      clear_range(to, b.values[2 * i], run_last(b.values, i));
+  }
+  a.card = popcount(to);
+  if (a.card) settle(a);
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_ROARING_SET_MY_ROARING_SET_H_
@@ -0,0 +1,142 @@
+#ifndef CONTAINERS_SRC_SERIAL_MY_SERIAL_H_
+#define CONTAINERS_SRC_SERIAL_MY_SERIAL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "../vector/my_vector.h"
+
+namespace my {
+namespace serial {
+
+// Binary stream layout shared by map, set and multiset:
+//   header  magic "MYCS", version, kind, byte order, key and value widths,
+//           element count
+//   keys    count keys in sorted order
+//   values  count values (map only)
+// Trivially copyable elements are written as one raw block of fixed width
+// (width = sizeof), anything else element by element through codec<T>.
+// Counts and lengths come from the stream, so readers never allocate
+// more than kChunk elements ahead of the data that has actually arrived;
+// a corrupt count ends as a truncated stream, not a huge allocation.
+
+constexpr char kMagic[4] = {'M', 'Y', 'C', 'S'};
+constexpr uint8_t kVersion = 1;
+constexpr uint16_t kByteOrder = 0x0102;  // reads back swapped on other endian
+constexpr uint64_t kChunk = 4096;        // elements allocated per read step
+
+enum kind : uint8_t { kMap = 1, kSet = 2, kMultiset = 3, kMerkleDigest = 4 };
+
+template <typename T, typename = void>
+struct codec {  // raw bytes for trivially copyable types
+  static_assert(std::is_trivially_copyable<T>::value,
+                "type needs a my::serial::codec specialization");
+  static constexpr uint32_t width = sizeof(T);
+
+  static void write(std::ostream &os, const T &value) {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+  static void read(std::istream &is, T &value) {
+    is.read(reinterpret_cast<char *>(&value), sizeof(T));
+  }
+};
+
+template <typename Char>
+struct codec<std::basic_string<Char>> {  // u64 length followed by the chars
+  static constexpr uint32_t width = 0;
+
+  static void write(std::ostream &os, const std::basic_string<Char> &value) {
+    uint64_t length = value.size();
+    os.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    os.write(reinterpret_cast<const char *>(value.data()),
+             length * sizeof(Char));
+  }
+  static void read(std::istream &is, std::basic_string<Char> &value) {
+    uint64_t length = 0;
+    is.read(reinterpret_cast<char *>(&length), sizeof(length));
+    value.clear();
+    while (length > 0 && is) {
+      size_t done = value.size(), n = size_t(std::min(length, kChunk));
+      value.resize(done + n);
+      is.read(reinterpret_cast<char *>(&value[done]), n * sizeof(Char));
+      length -= n;
+    }
+  }
+};
+
+template <typename T>
+void write_block(std::ostream &os, const T *data, size_t count) {
+  if (codec<T>::width != 0) {  // fixed width, one write for the whole block
+    os.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+  } else {
+    for (size_t i = 0; i < count; i++) codec<T>::write(os, data[i]);
+  }
+}
+
+template <typename T>
+void read_block(std::istream &is, T *data, size_t count) {
+  if (codec<T>::width != 0) {
+    is.read(reinterpret_cast<char *>(data), count * sizeof(T));
+  } else {
+    for (size_t i = 0; i < count && is; i++) codec<T>::read(is, data[i]);
+  }
+  if (!is) throw std::invalid_argument("Truncated container stream");
+}
+
+template <typename T>
+vector<T> read_vector(std::istream &is, uint64_t count) {
+  vector<T> out;
+  for (uint64_t done = 0; done < count;) {
+    uint64_t n = std::min(count - done, kChunk);
+    for (uint64_t i = 0; i < n; i++) out.push_back(T());
+    read_block(is, out.data() + done, n);
+    done += n;
+  }
+  return out;
+}
+
+template <typename Key, typename T>
+void write_header(std::ostream &os, kind type, uint64_t count) {
+  os.write(kMagic, sizeof(kMagic));
+  uint8_t version = kVersion, type_byte = type;
+  uint16_t order = kByteOrder;
+  uint32_t widths[2] = {codec<Key>::width, codec<T>::width};
+  os.write(reinterpret_cast<const char *>(&version), 1);
+  os.write(reinterpret_cast<const char *>(&type_byte), 1);
+  os.write(reinterpret_cast<const char *>(&order), sizeof(order));
+  os.write(reinterpret_cast<const char *>(widths), sizeof(widths));
+  os.write(reinterpret_cast<const char *>(&count), sizeof(count));
+}
+
+template <typename Key, typename T>
+uint64_t read_header(std::istream &is, kind type) {  // returns element count
+  char magic[4] = {};
+  uint8_t version = 0, type_byte = 0;
+  uint16_t order = 0;
+  uint32_t widths[2] = {};
+  uint64_t count = 0;
+  is.read(magic, sizeof(magic));
+  is.read(reinterpret_cast<char *>(&version), 1);
+  is.read(reinterpret_cast<char *>(&type_byte), 1);
+  is.read(reinterpret_cast<char *>(&order), sizeof(order));
+  is.read(reinterpret_cast<char *>(widths), sizeof(widths));
+  is.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!is || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    throw std::invalid_argument("Not a container stream");
+  if (version != kVersion)
+    throw std::invalid_argument("Unsupported container stream version");
+  if (type_byte != type || order != kByteOrder ||
+      widths[0] != codec<Key>::width || widths[1] != codec<T>::width)
+    throw std::invalid_argument("Container stream type mismatch");
+  return count;
+}
+
+}  // namespace serial
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_SERIAL_MY_SERIAL_H_
@@ -4,11 +4,15 @@
 #include <vector>
 
 #include "../bitree/my_bitree.h"
+#include "../bloom/my_bloom.h"
+#include "../serial/my_serial.h"
+#include "../sorted_ops/my_sorted_ops.h"
 #include "../vector/my_vector.h"
 
 namespace my {
 
-template <typename Key>
+template <typename Key, typename Compare = std::less<Key>,
+          typename Balance = rb_balance>
 class set {
  private:
   using key_type = Key;
@@ -16,22 +20,55 @@ class set {
   using reference = value_type&;
   using const_reference = const value_type&;
   using size_type = size_t;
-  bitree<Key, Key> tree;
+  bitree<Key, Key, Compare, Balance> tree;
+  bloom_index<Key> bloom;  // optional filter for misses
+
+  void sync_bloom() {  // rebuild now if needed, so lookups only read it
+    bloom.refresh(tree.get_size(), [this](auto add) {
+      tree.in_order([&add](const Key& k, const Key&) { add(k); });
+    });
+  }
+
+  static constexpr size_type kMergeRatio = 16;  // size skew to merge by
+                                                // inserts, not a rebuild
+
+  void flatten(vector<Key>& keys) const {  // sorted copy
+    keys.reserve(tree.get_size());
+    tree.in_order([&keys](const Key& key, const Key&) { keys.push_back(key); });
+  }
+  template <typename Op>  // Op(keys, keys, order) is the sorted result
+  static set combined(const set& a, const set& b, Op op) {
+    vector<Key> keys, other_keys;
+    a.flatten(keys);
+    b.flatten(other_keys);
+    vector<Key> out = op(keys, other_keys, a.key_comp());
+    set result(a.key_comp());
+    result.tree.build_sorted(out.data(), out.data(), out.size());
+    return result;
+  }
 
  public:
-  using iterator = typename bitree<Key, Key>::tree_iterator;
+  using iterator = typename bitree<Key, Key, Compare, Balance>::tree_iterator;
   set() {};
+  explicit set(const Compare& order) : tree(order) {}
   set(std::initializer_list<value_type> const& items) {
     for (const auto& item : items) {
       tree << std::make_pair(item, item);
     }
   };
-  set(const set& other) : tree(other.tree) {}
-  set(set&& other) noexcept : tree(std::move(other.tree)) {}
+  set(const set& other) : tree(other.tree), bloom(other.bloom) {}
+  set(set&& other) noexcept
+      : tree(std::move(other.tree)), bloom(std::move(other.bloom)) {}
   ~set() { tree.clear(); }
+  set& operator=(const set& other) {  // shares nodes like the copy
+    tree = other.tree;
+    bloom = other.bloom;
+    return *this;
+  }
   set& operator=(set&& other) noexcept {
     if (this != &other) {
       tree = std::move(other.tree);
+      bloom = std::move(other.bloom);
     }
     return *this;
   }
@@ -41,6 +78,8 @@ class set {
     for (const auto& item : items) {
       tree << std::make_pair(item, item);
     }
+    bloom.invalidate();
+    sync_bloom();
     return *this;
   }
 
@@ -56,45 +95,128 @@ class set {
   size_type size() { return tree.tree_size; }
   size_type max_size() { return 11111; }
 
-  void clear() { tree.clear(); }
+  void clear() {
+    tree.clear();
+    bloom.invalidate();
+    sync_bloom();
+  }
   std::pair<iterator, bool> insert(const value_type& value) {
-    iterator it = tree.begin();
-    if (contains(value)) return {it.set(value), false};
+    if (contains(value)) return {tree.iterator_to(value), false};
     tree << std::make_pair(value, value);
-    return {it.set(value), true};
+    bloom.inserted(value);
+    sync_bloom();
+    return {tree.iterator_to(value), true};
   }
   bool erase(const value_type& value) {
     if (!this->contains(value)) return false;
     tree >> value;
+    bloom.removed();
+    sync_bloom();
     return true;
   }
   iterator erase(iterator it) {
     iterator tmp = it;
     ++tmp;
     tree >> it.cget();
+    bloom.removed();
+    sync_bloom();
     return tmp;
   }
   void merge(set& other) {
-    iterator it = other.begin();
-    for (size_type i = 0; i < other.size(); i++) {
-      this->insert(it.cget());
-      ++it;
+    if (other.size() * kMergeRatio < size()) {  // few new keys, insert each
+      other.tree.in_order([this](const Key& key, const Key&) {
+        if (contains(key)) return;  // other is only read, stays shared
+        tree << std::make_pair(key, key);
+        bloom.inserted(key);
+        sync_bloom();
+      });
+      return;
     }
+    vector<Key> keys, other_keys;
+    flatten(keys);
+    other.flatten(other_keys);
+    vector<Key> merged = sorted_union(keys, other_keys, tree.key_comp());
+    tree.build_sorted(merged.data(), merged.data(), merged.size());
+    bloom.invalidate();
+    sync_bloom();
+  }
+
+  // set algebra over the flattened trees, see sorted_ops
+  friend set set_union(const set& a, const set& b) {
+    return combined(a, b, sorted_union<Key, Compare>);
+  }
+  friend set set_intersection(const set& a, const set& b) {
+    return combined(a, b, sorted_intersection<Key, Compare>);
+  }
+  friend set set_difference(const set& a, const set& b) {
+    return combined(a, b, sorted_difference<Key, Compare>);
   }
 
   iterator find(const Key& key) {
-    iterator it = this->end();
-    if (!this->contains(key)) return it;
-    return it.set(key);
+    if (!this->contains(key)) return this->end();
+    return tree.iterator_to(key);
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  iterator find(const K& key) {  // any type Compare orders against Key
+    return tree.iterator_to(key);
   }
 
-  bool contains(const Key& key) {
-    try {
-      tree.find_value(key);
-      return true;
-    } catch (const std::out_of_range& e) {
-      return false;
-    }
+  bool contains(const Key& key) const {
+    if (!bloom.may_contain(key))
+      return false;  // definite miss, no tree descent
+    return bloom.found(tree.contains(key));
+  }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  bool contains(const K& key) const {  // the filter hashes Key, so a
+    return tree.contains(key);         // foreign key goes to the tree
+  }
+  size_type count(const Key& key) const { return contains(key); }
+  template <typename K, typename C = Compare,
+            typename = typename C::is_transparent>
+  size_type count(const K& key) const {
+    return tree.contains(key);
+  }
+  Compare key_comp() const { return tree.key_comp(); }
+
+  void enable_bloom(double fp_rate = 0.01) {  // hashes with std::hash<Key>
+    static_assert(std::is_same<Compare, std::less<Key>>::value ||
+                      std::is_same<Compare, std::less<>>::value,
+                  "a Bloom filter on std::hash needs operator< order");
+    bloom.enable(fp_rate);
+    sync_bloom();
+  }
+  void disable_bloom() { bloom.disable(); }
+  bloom_stats get_bloom_stats() const { return bloom.get_stats(); }
+
+  // node relocation for locality, see bitree::compact
+  void compact(compact_order order = compact_order::in_order) {
+    tree.compact(order);
+  }
+  bool compact_step(size_type budget = 256) {
+    return tree.compact_step(budget);
+  }
+  double fragmentation() const { return tree.fragmentation(); }
+
+  void serialize(std::ostream& os) const {  // sorted binary dump
+    vector<Key> keys;
+    keys.reserve(tree.get_size());
+    tree.in_order(
+        [&keys](const Key& key, const Key&) { keys.push_back(key); });
+    serial::write_header<Key, Key>(os, serial::kSet, keys.size());
+    serial::write_block(os, keys.data(), keys.size());
+  }
+
+  void deserialize(std::istream& is) {  // O(n) reload through bulk build
+    size_type count = serial::read_header<Key, Key>(is, serial::kSet);
+    vector<Key> keys = serial::read_vector<Key>(is, count);
+    for (size_type i = 1; i < count; i++)
+      if (!tree.key_comp()(keys[i - 1], keys[i]))
+        throw std::invalid_argument("Container stream keys are not sorted");
+    tree.build_sorted(keys.data(), keys.data(), count);
+    bloom.invalidate();
+    sync_bloom();
   }
 
   template <typename... Args>
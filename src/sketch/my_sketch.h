@@ -0,0 +1,267 @@
+#ifndef CONTAINERS_SRC_SKETCH_MY_SKETCH_H_
+#define CONTAINERS_SRC_SKETCH_MY_SKETCH_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+namespace my {
+
+// Sketches answer what a set or multiset would, distinct count and counts
+// per key, approximately in a fixed amount of memory. Their state is flat
+// arrays aligned to cache lines; merge and the estimates are plain loops
+// over them that the compiler vectorizes.
+
+namespace sketch_detail {
+
+inline uint64_t mix(uint64_t h) {  // splitmix64 finalizer, every bit of h
+  h ^= h >> 30;                    // reaches every output bit
+  h *= 0xBF58476D1CE4E5B9ull;
+  h ^= h >> 27;
+  h *= 0x94D049BB133111EBull;
+  return h ^ (h >> 31);
+}
+
+struct free_deleter {
+  void operator()(void *p) const { std::free(p); }
+};
+
+template <typename Cell>
+std::unique_ptr<Cell[], free_deleter> aligned_cells(size_t count) {
+  size_t bytes = (count * sizeof(Cell) + 63) / 64 * 64;
+  void *memory = std::aligned_alloc(64, bytes);
+  if (!memory) throw std::bad_alloc();
+  std::memset(memory, 0, bytes);
+  return std::unique_ptr<Cell[], free_deleter>(static_cast<Cell *>(memory));
+}
+
+}  // namespace sketch_detail
+
+// Distinct count of a stream, like set::size without the set. 2^p one
+// byte registers keep the longest run of leading zeros seen among hashes
+// that start with their index; the standard error is 1.04 / sqrt(2^p).
+template <typename Key, typename Hash = std::hash<Key>>
+class hyperloglog {
+ public:
+  using size_type = size_t;
+  static constexpr int kMinPrecision = 4;
+  static constexpr int kMaxPrecision = 18;
+
+  explicit hyperloglog(double error = 0.01);  // relative standard error
+  hyperloglog(const hyperloglog &other);
+  hyperloglog &operator=(const hyperloglog &other);
+  hyperloglog(hyperloglog &&other) noexcept = default;
+  hyperloglog &operator=(hyperloglog &&other) noexcept = default;
+
+  // false when no register moved, the key may have been seen before
+  bool insert(const Key &key) {
+    uint64_t h = sketch_detail::mix(uint64_t(Hash()(key)));
+    size_type index = size_type(h >> (64 - p));
+    uint64_t rest = (h << p) | (1ull << (p - 1));  // rank stops at 65 - p
+    uint8_t rank = uint8_t(__builtin_clzll(rest) + 1);
+    if (registers[index] >= rank) return false;
+    registers[index] = rank;
+    return true;
+  }
+  double estimate() const;
+  void merge(const hyperloglog &other);  // union, same precision only
+  void clear() { std::memset(registers.get(), 0, count); }
+
+  int precision() const { return p; }
+  double error() const { return 1.04 / std::sqrt(double(count)); }
+  size_type bytes() const { return count; }
+
+ private:
+  int p;
+  size_type count;  // 2^p registers
+  std::unique_ptr<uint8_t[], sketch_detail::free_deleter> registers;
+};
+
+// Counts per key of a stream, like multiset::count without the multiset.
+// depth rows of width counters, each row hashes the key to one counter.
+// An estimate is the smallest of its counters: never below the true count
+// and, with probability 1 - delta, at most epsilon * total() above it.
+// Counters saturate at 2^32 - 1.
+template <typename Key, typename Hash = std::hash<Key>>
+class count_min_sketch {
+ public:
+  using size_type = size_t;
+
+  explicit count_min_sketch(double epsilon = 0.001, double delta = 0.01);
+  count_min_sketch(const count_min_sketch &other);
+  count_min_sketch &operator=(const count_min_sketch &other);
+  count_min_sketch(count_min_sketch &&other) noexcept = default;
+  count_min_sketch &operator=(count_min_sketch &&other) noexcept = default;
+
+  void insert(const Key &key, uint32_t times = 1);
+  uint32_t estimate(const Key &key) const;
+  size_type count(const Key &key) const { return estimate(key); }
+  void merge(const count_min_sketch &other);  // sum, same shape only
+  void clear();
+
+  uint64_t total() const { return inserted; }  // sum of all insert times
+  double error_bound() const { return epsilon * double(inserted); }
+  size_type width() const { return columns; }
+  size_type depth() const { return rows; }
+  size_type bytes() const { return rows * columns * sizeof(uint32_t); }
+
+ private:
+  double epsilon;
+  size_type columns;  // a power of two, the column is masked out
+  size_type rows;
+  uint64_t inserted = 0;
+  std::unique_ptr<uint32_t[], sketch_detail::free_deleter> counters;
+
+  // row i looks at column h1 + i * h2, the halves of one 64 bit hash
+  static uint64_t hash_of(const Key &key) {
+    return sketch_detail::mix(uint64_t(Hash()(key)));
+  }
+};
+
+//------------------FUNCTIONS------------------//
+template <typename Key, typename Hash>
+hyperloglog<Key, Hash>::hyperloglog(double error) {
+  if (!(error > 0 && error < 1))
+    throw std::invalid_argument("HyperLogLog error out of (0, 1)");
+  double wanted = 1.04 / error;  // registers for the error, as 2^p
+  p = int(std::ceil(std::log2(wanted * wanted)));
+  if (p < kMinPrecision) p = kMinPrecision;
+  if (p > kMaxPrecision) p = kMaxPrecision;
+  count = size_type(1) << p;
+  registers = sketch_detail::aligned_cells<uint8_t>(count);
+}
+
+template <typename Key, typename Hash>
+hyperloglog<Key, Hash>::hyperloglog(const hyperloglog &other)
+    : p(other.p),
+      count(other.count),
+      registers(sketch_detail::aligned_cells<uint8_t>(other.count)) {
+  std::memcpy(registers.get(), other.registers.get(), count);
+}
+
+template <typename Key, typename Hash>
+hyperloglog<Key, Hash> &hyperloglog<Key, Hash>::operator=(
+    const hyperloglog &other) {
+  if (this != &other) {
+    hyperloglog tmp(other);
+    *this = std::move(tmp);
+  }
+  return *this;
+}
+
+template <typename Key, typename Hash>
+double hyperloglog<Key, Hash>::estimate() const {
+  size_type histogram[66] = {};  // registers per rank, ranks are <= 65 - p
+  const uint8_t *r = registers.get();
+  for (size_type i = 0; i < count; i++) ++histogram[r[i]];
+  double sum = 0;
+  for (int rank = 65 - p; rank >= 0; rank--)  // Horner, from the top rank
+    sum = sum * 0.5 + double(histogram[rank]);
+  double m = double(count);
+  double alpha = count == 16   ? 0.673
+                 : count == 32 ? 0.697
+                 : count == 64 ? 0.709
+                               : 0.7213 / (1 + 1.079 / m);
+  double raw = alpha * m * m / sum;
+  if (raw <= 2.5 * m && histogram[0] > 0)  // small range: linear counting
+    return m * std::log(m / double(histogram[0]));
+  return raw;  // 64 bit hashes need no large range correction
+}
+
+template <typename Key, typename Hash>
+void hyperloglog<Key, Hash>::merge(const hyperloglog &other) {
+  if (other.p != p)
+    throw std::invalid_argument("HyperLogLog precisions differ");
+  uint8_t *to = registers.get();
+  const uint8_t *from = other.registers.get();
+  for (size_type i = 0; i < count; i++)
+    to[i] = to[i] > from[i] ? to[i] : from[i];
+}
+
+template <typename Key, typename Hash>
+count_min_sketch<Key, Hash>::count_min_sketch(double epsilon, double delta)
+    : epsilon(epsilon) {
+  if (!(epsilon > 0 && epsilon < 1) || !(delta > 0 && delta < 1))
+    throw std::invalid_argument("Count-min epsilon or delta out of (0, 1)");
+  columns = 1;
+  while (double(columns) < std::exp(1.0) / epsilon) columns *= 2;
+  rows = size_type(std::ceil(std::log(1 / delta)));
+  if (rows < 1) rows = 1;
+  counters = sketch_detail::aligned_cells<uint32_t>(rows * columns);
+}
+
+template <typename Key, typename Hash>
+count_min_sketch<Key, Hash>::count_min_sketch(const count_min_sketch &other)
+    : epsilon(other.epsilon),
+      columns(other.columns),
+      rows(other.rows),
+      inserted(other.inserted),
+      counters(sketch_detail::aligned_cells<uint32_t>(other.rows *
+                                                      other.columns)) {
+  std::memcpy(counters.get(), other.counters.get(), bytes());
+}
+
+template <typename Key, typename Hash>
+count_min_sketch<Key, Hash> &count_min_sketch<Key, Hash>::operator=(
+    const count_min_sketch &other) {
+  if (this != &other) {
+    count_min_sketch tmp(other);
+    *this = std::move(tmp);
+  }
+  return *this;
+}
+
+template <typename Key, typename Hash>
+void count_min_sketch<Key, Hash>::insert(const Key &key, uint32_t times) {
+  uint64_t h = hash_of(key);
+  uint32_t h1 = uint32_t(h), h2 = uint32_t(h >> 32) | 1;
+  uint32_t *row = counters.get();
+  for (size_type i = 0; i < rows; i++, row += columns) {
+    uint32_t &cell = row[(h1 + uint32_t(i) * h2) & (columns - 1)];
+    cell = cell > std::numeric_limits<uint32_t>::max() - times
+               ? std::numeric_limits<uint32_t>::max()
+               : cell + times;
+  }
+  inserted += times;
+}
+
+template <typename Key, typename Hash>
+uint32_t count_min_sketch<Key, Hash>::estimate(const Key &key) const {
+  uint64_t h = hash_of(key);
+  uint32_t h1 = uint32_t(h), h2 = uint32_t(h >> 32) | 1;
+  uint32_t least = std::numeric_limits<uint32_t>::max();
+  const uint32_t *row = counters.get();
+  for (size_type i = 0; i < rows; i++, row += columns) {
+    uint32_t cell = row[(h1 + uint32_t(i) * h2) & (columns - 1)];
+    if (cell < least) least = cell;
+  }
+  return least;
+}
+
+template <typename Key, typename Hash>
+void count_min_sketch<Key, Hash>::merge(const count_min_sketch &other) {
+  if (other.rows != rows || other.columns != columns)
+    throw std::invalid_argument("Count-min sketch shapes differ");
+  uint32_t *to = counters.get();
+  const uint32_t *from = other.counters.get();
+  for (size_type i = 0; i < rows * columns; i++) {
+    uint32_t sum = to[i] + from[i];
+    to[i] = sum < to[i] ? std::numeric_limits<uint32_t>::max() : sum;
+  }
+  inserted += other.inserted;
+}
+
+template <typename Key, typename Hash>
+void count_min_sketch<Key, Hash>::clear() {
+  std::memset(counters.get(), 0, bytes());
+  inserted = 0;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_SKETCH_MY_SKETCH_H_
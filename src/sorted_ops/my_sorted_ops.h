@@ -0,0 +1,294 @@
+#ifndef CONTAINERS_SRC_SORTED_OPS_MY_SORTED_OPS_H_
+#define CONTAINERS_SRC_SORTED_OPS_MY_SORTED_OPS_H_
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// Intersection, union and difference of strictly increasing ranges, the
+// flattened form of a set. The size ratio picks the algorithm. Past
+// kGallopRatio each element of the small side gallops through the large
+// one; a union, or a difference with the small side taken away, copies
+// the stretches of the large side between them past kCopyRatio. Up to
+// kBlockRatio intersection and difference compare blocks of both sides
+// at once in SIMD registers and union is a branchless merge; in between
+// the plain merges of <algorithm> predict well. The block compare works
+// for 4 and 8 byte integers ordered by std::less; other keys, and 8 byte
+// ones below SSE4.1, take the plain merges there too. Every
+// kernel writes to out and returns the count written; out has room for
+// the result, the smaller side for an intersection, a for a difference,
+// both sides for a union.
+
+namespace sorted_ops {
+
+constexpr size_t kGallopRatio = 32;  // skew to look up the small side
+constexpr size_t kCopyRatio = 64;    // skew to copy stretches of the large
+constexpr size_t kBlockRatio = 4;    // skew up to which blocks pay off
+
+namespace detail {
+
+// match(a, b) has bit i set when a[i] equals any of b[0, kWidth)
+template <size_t Bytes>
+struct simd {
+  static constexpr size_t kWidth = 0;
+  static unsigned match(const void *, const void *) { return 0; }
+};
+
+#if defined(__AVX2__)
+template <>
+struct simd<4> {
+  static constexpr size_t kWidth = 8;
+  static unsigned match(const void *a, const void *b) {
+    __m256i va = _mm256_loadu_si256(static_cast<const __m256i *>(a));
+    __m256i vb = _mm256_loadu_si256(static_cast<const __m256i *>(b));
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for (int k = 1; k < 8; k++) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+    return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+  }
+};
+
+template <>
+struct simd<8> {
+  static constexpr size_t kWidth = 4;
+  static unsigned match(const void *a, const void *b) {
+    __m256i va = _mm256_loadu_si256(static_cast<const __m256i *>(a));
+    __m256i vb = _mm256_loadu_si256(static_cast<const __m256i *>(b));
+    __m256i eq = _mm256_cmpeq_epi64(va, vb);
+    for (int k = 1; k < 4; k++) {
+      vb = _mm256_permute4x64_epi64(vb, _MM_SHUFFLE(0, 3, 2, 1));
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(va, vb));
+    }
+    return unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+  }
+};
+#elif defined(__SSE2__)
+template <>
+struct simd<4> {
+  static constexpr size_t kWidth = 4;
+  static unsigned match(const void *a, const void *b) {
+    __m128i va = _mm_loadu_si128(static_cast<const __m128i *>(a));
+    __m128i vb = _mm_loadu_si128(static_cast<const __m128i *>(b));
+    __m128i eq = _mm_cmpeq_epi32(va, vb);
+    for (int k = 1; k < 4; k++) {
+      vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, vb));
+    }
+    return unsigned(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+  }
+};
+
+#if defined(__SSE4_1__)
+template <>
+struct simd<8> {
+  static constexpr size_t kWidth = 2;
+  static unsigned match(const void *a, const void *b) {
+    __m128i va = _mm_loadu_si128(static_cast<const __m128i *>(a));
+    __m128i vb = _mm_loadu_si128(static_cast<const __m128i *>(b));
+    __m128i swapped = _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i eq = _mm_or_si128(_mm_cmpeq_epi64(va, vb),
+                              _mm_cmpeq_epi64(va, swapped));
+    return unsigned(_mm_movemask_pd(_mm_castsi128_pd(eq)));
+  }
+};
+#endif
+#endif
+
+template <typename T, typename Compare>
+constexpr size_t block_width() {  // 0 when the block compare does not apply
+  return std::is_integral<T>::value &&
+                 std::is_same<Compare, std::less<T>>::value
+             ? simd<sizeof(T)>::kWidth
+             : 0;
+}
+
+template <typename T, typename Compare>
+bool same(const T &x, const T &y, Compare comp) {
+  return !comp(x, y) && !comp(y, x);
+}
+
+// first index in [from, n) not below x, by doubling steps then bisection
+template <typename T, typename Compare>
+size_t gallop(const T *data, size_t from, size_t n, const T &x,
+              Compare comp) {
+  size_t lo = from, hi = from, step = 1;
+  while (hi < n && comp(data[hi], x)) {
+    lo = hi + 1;
+    hi += step;
+    step *= 2;
+  }
+  if (hi > n) hi = n;
+  return std::lower_bound(data + lo, data + hi, x, comp) - data;
+}
+
+// the elements of a found in b when Keep, the others when not; a small
+// against b large
+template <bool Keep, typename T, typename Compare>
+size_t filter_gallop(const T *a, size_t na, const T *b, size_t nb, T *out,
+                     Compare comp) {
+  size_t j = 0, n = 0;
+  for (size_t i = 0; i < na; i++) {
+    j = gallop(b, j, nb, a[i], comp);
+    bool hit = j < nb && same(b[j], a[i], comp);
+    if (hit == Keep) out[n++] = a[i];
+  }
+  return n;
+}
+
+// the same for sides of similar size. A block of a is compared against
+// blocks of b until b's block ends at or past it; b blocks that end
+// first can hold nothing of the later blocks of a.
+template <bool Keep, typename T, typename Compare>
+size_t filter_blocks(const T *a, size_t na, const T *b, size_t nb, T *out,
+                     Compare comp) {
+  constexpr size_t kWidth = block_width<T, Compare>();
+  size_t i = 0, j = 0, n = 0;
+  unsigned found = 0;  // lanes of a[i, i + kWidth) seen in b so far
+  while (i + kWidth <= na && j + kWidth <= nb) {
+    found |= simd<sizeof(T)>::match(a + i, b + j);
+    T a_last = a[i + kWidth - 1], b_last = b[j + kWidth - 1];
+    if (a_last <= b_last) {
+      unsigned take = Keep ? found : ~found & ((1u << kWidth) - 1);
+      for (; take; take &= take - 1) out[n++] = a[i + __builtin_ctz(take)];
+      i += kWidth;
+      found = 0;
+    }
+    if (b_last <= a_last) j += kWidth;
+  }
+  for (size_t k = i; k < na; k++) {  // the rest, scalar
+    while (j < nb && comp(b[j], a[k])) j++;
+    bool hit = (k - i < 32 && (found >> (k - i) & 1)) ||
+               (j < nb && same(b[j], a[k], comp));
+    if (hit == Keep) out[n++] = a[k];
+  }
+  return n;
+}
+
+template <bool Keep, typename T, typename Compare>
+size_t filter_similar(const T *a, size_t na, const T *b, size_t nb, T *out,
+                      Compare comp) {
+  if constexpr (block_width<T, Compare>() > 0)
+    return filter_blocks<Keep>(a, na, b, nb, out, comp);
+  else if constexpr (Keep)
+    return std::set_intersection(a, a + na, b, b + nb, out, comp) - out;
+  else
+    return std::set_difference(a, a + na, b, b + nb, out, comp) - out;
+}
+
+}  // namespace detail
+
+template <typename T, typename Compare = std::less<T>>
+size_t intersect(const T *a, size_t na, const T *b, size_t nb, T *out,
+                 Compare comp = Compare()) {
+  if (na * kGallopRatio < nb)
+    return detail::filter_gallop<true>(a, na, b, nb, out, comp);
+  if (nb * kGallopRatio < na)
+    return detail::filter_gallop<true>(b, nb, a, na, out, comp);
+  return detail::filter_similar<true>(a, na, b, nb, out, comp);
+}
+
+template <typename T, typename Compare = std::less<T>>
+size_t subtract(const T *a, size_t na, const T *b, size_t nb, T *out,
+                Compare comp = Compare()) {  // a without b
+  if (na * kGallopRatio < nb)
+    return detail::filter_gallop<false>(a, na, b, nb, out, comp);
+  if (nb * kCopyRatio < na) {  // copy the stretches of a between b's
+    size_t i = 0, n = 0;
+    for (size_t j = 0; j < nb && i < na; j++) {
+      size_t at = detail::gallop(a, i, na, b[j], comp);
+      out = std::copy(a + i, a + at, out);
+      n += at - i;
+      i = at < na && detail::same(a[at], b[j], comp) ? at + 1 : at;
+    }
+    std::copy(a + i, a + na, out);
+    return n + na - i;
+  }
+  if (na <= nb * kBlockRatio && nb <= na * kBlockRatio)
+    return detail::filter_similar<false>(a, na, b, nb, out, comp);
+  return std::set_difference(a, a + na, b, b + nb, out, comp) - out;
+}
+
+template <typename T, typename Compare = std::less<T>>
+size_t unite(const T *a, size_t na, const T *b, size_t nb, T *out,
+             Compare comp = Compare()) {
+  if (na * kCopyRatio < nb || nb * kCopyRatio < na) {
+    if (na > nb) {  // a is the small side below
+      std::swap(a, b);
+      std::swap(na, nb);
+    }
+    size_t j = 0, n = 0;
+    for (size_t i = 0; i < na; i++) {
+      size_t at = detail::gallop(b, j, nb, a[i], comp);
+      out = std::copy(b + j, b + at, out);
+      n += at - j;
+      *out++ = a[i];
+      ++n;
+      j = at < nb && detail::same(b[at], a[i], comp) ? at + 1 : at;
+    }
+    std::copy(b + j, b + nb, out);
+    return n + nb - j;
+  }
+  if (na >= nb * kBlockRatio || nb >= na * kBlockRatio)
+    return std::set_union(a, a + na, b, b + nb, out, comp) - out;
+  size_t i = 0, j = 0, n = 0;
+  while (i < na && j < nb) {  // branchless: both advance on a tie
+    const T &x = a[i], &y = b[j];
+    bool a_first = !comp(y, x), b_first = !comp(x, y);
+    out[n++] = a_first ? x : y;
+    i += a_first;
+    j += b_first;
+  }
+  std::copy(a + i, a + na, out + n);
+  n += na - i;
+  std::copy(b + j, b + nb, out + n);
+  return n + nb - j;
+}
+
+}  // namespace sorted_ops
+
+// The kernels above on the flattened form of a set
+template <typename T, typename Compare = std::less<T>>
+vector<T> sorted_intersection(const vector<T> &a, const vector<T> &b,
+                              Compare comp = Compare()) {
+  vector<T> out(std::min(a.size(), b.size()));
+  size_t n = sorted_ops::intersect(a.data(), a.size(), b.data(), b.size(),
+                                   out.data(), comp);
+  while (out.size() > n) out.pop_back();
+  return out;
+}
+
+template <typename T, typename Compare = std::less<T>>
+vector<T> sorted_union(const vector<T> &a, const vector<T> &b,
+                       Compare comp = Compare()) {
+  vector<T> out(a.size() + b.size());
+  size_t n = sorted_ops::unite(a.data(), a.size(), b.data(), b.size(),
+                               out.data(), comp);
+  while (out.size() > n) out.pop_back();
+  return out;
+}
+
+template <typename T, typename Compare = std::less<T>>
+vector<T> sorted_difference(const vector<T> &a, const vector<T> &b,
+                            Compare comp = Compare()) {
+  vector<T> out(a.size());
+  size_t n = sorted_ops::subtract(a.data(), a.size(), b.data(), b.size(),
+                                  out.data(), comp);
+  while (out.size() > n) out.pop_back();
+  return out;
+}
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_SORTED_OPS_MY_SORTED_OPS_H_
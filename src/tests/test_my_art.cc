@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "../my_containers_plus.h"
+
+TEST(my_art_map, insert_find_erase) {
+  my::art_map<int, std::string> map = {{3, "three"}, {-1, "minus one"}};
+  ASSERT_TRUE(map.insert(7, "seven").second);
+  ASSERT_FALSE(map.insert(7, "again").second);
+  ASSERT_EQ("seven", map.at(7));
+  ASSERT_EQ("minus one", map.find(-1)->second);
+  ASSERT_TRUE(map.find(4) == map.end());
+  ASSERT_THROW(map.at(4), std::out_of_range);
+  map[4] = "four";
+  map.insert_or_assign(3, "drei");
+  ASSERT_EQ("drei", map[3]);
+  ASSERT_EQ(4u, map.size());
+  ASSERT_TRUE(map.erase(3));
+  ASSERT_FALSE(map.erase(3));
+  ASSERT_FALSE(map.contains(3));
+  ASSERT_EQ(3u, map.size());
+}
+
+TEST(my_art_map, ordered_iteration_signed) {
+  my::art_map<long, int> map;
+  long keys[] = {5, -7, 0, 1L << 40, -(1L << 40), 300, -300, 255, 256};
+  for (long key : keys) map[key] = int(key % 1000);
+  long last = -(1L << 62);
+  size_t seen = 0;
+  for (const auto &item : map) {
+    ASSERT_LT(last, item.first);
+    last = item.first;
+    seen++;
+  }
+  ASSERT_EQ(map.size(), seen);
+  auto it = map.end();
+  --it;
+  ASSERT_EQ(1L << 40, it->first);
+}
+
+TEST(my_art_map, lower_bound) {
+  my::art_map<unsigned, unsigned> map;
+  for (unsigned i = 0; i < 2000; i++) map[i * 7 + 3] = i;
+  for (unsigned q = 0; q < 14100; q += 5) {
+    auto it = map.lower_bound(q);
+    unsigned expected = q <= 3 ? 3 : (q - 3 + 6) / 7 * 7 + 3;
+    if (expected > 1999 * 7 + 3) {
+      ASSERT_TRUE(it == map.end());
+    } else {
+      ASSERT_EQ(expected, it->first);
+    }
+  }
+  ASSERT_EQ(17u, map.upper_bound(10)->first);
+}
+
+TEST(my_art_map, strings_with_shared_prefixes) {
+  my::art_map<std::string, int> map;
+  std::map<std::string, int> model;
+  std::string words[] = {"",
+                         "a",
+                         "ab",
+                         "abc",
+                         std::string("a\0b", 3),
+                         "b",
+                         "abd",
+                         "abcde",
+                         "abcdefghijklmnopqrstuvwxyz",
+                         "abcdefghijklmnopqrstuvwxy",
+                         "abcdefghijklmnopq0",
+                         "zz",
+                         "http://example.com/a",
+                         "http://example.com/b"};
+  int i = 0;
+  for (const auto &word : words) {
+    map[word] = i;
+    model[word] = i++;
+  }
+  auto it = map.begin();
+  for (const auto &item : model) {
+    ASSERT_EQ(item.first, it->first);
+    ASSERT_EQ(item.second, it->second);
+    ++it;
+  }
+  ASSERT_EQ("abcdefghijklmnopq0", map.lower_bound("abcdefghijklmnop")->first);
+  ASSERT_EQ("b", map.lower_bound("abz")->first);
+  ASSERT_EQ("abcdefghijklmnopqrstuvwxy",
+            map.lower_bound("abcdefghijklmnopqr")->first);
+  for (const auto &word : words) ASSERT_TRUE(map.erase(word));
+  ASSERT_TRUE(map.empty());
+  ASSERT_TRUE(map.begin() == map.end());
+}
+
+TEST(my_art_map, random_against_std_map) {
+  my::art_map<uint64_t, int> map;
+  std::map<uint64_t, int> model;
+  uint64_t state = 88172645463325252ull;
+  for (int step = 0; step < 60000; step++) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    // a mix of dense small keys and sparse ones to hit every node size
+    uint64_t key = step % 3 ? state % 5000 : state >> (state % 48);
+    if (state % 5 < 3) {
+      map[key] = step;
+      model[key] = step;
+    } else {
+      ASSERT_EQ(model.erase(key) == 1, map.erase(key));
+    }
+    if (step % 997 == 0) {
+      auto lb = map.lower_bound(state);
+      auto expected = model.lower_bound(state);
+      ASSERT_EQ(expected == model.end(), lb == map.end());
+      if (lb != map.end()) {
+        ASSERT_EQ(expected->first, lb->first);
+      }
+    }
+  }
+  ASSERT_EQ(model.size(), map.size());
+  auto it = map.begin();
+  for (const auto &item : model) {
+    ASSERT_EQ(item.first, it->first);
+    ASSERT_EQ(item.second, it->second);
+    ++it;
+  }
+  ASSERT_TRUE(it == map.end());
+  for (const auto &item : model) ASSERT_TRUE(map.erase(item.first));
+  ASSERT_EQ(0u, map.size());
+}
+
+TEST(my_art_map, copy_move_merge) {
+  my::art_map<int, int> map;
+  for (int i = 0; i < 100; i++) map[i] = i;
+  my::art_map<int, int> copy(map), moved(std::move(map));
+  ASSERT_EQ(100u, copy.size());
+  ASSERT_EQ(100u, moved.size());
+  copy[5] = -5;
+  ASSERT_EQ(5, moved[5]);
+  my::art_map<int, int> other = {{5, 50}, {200, 2}};
+  moved.merge(other);
+  ASSERT_EQ(101u, moved.size());
+  ASSERT_EQ(50, moved[5]);
+  auto results = moved.insert_many(std::pair<const int, int>(300, 3),
+                                   std::pair<const int, int>(5, 0));
+  ASSERT_TRUE(results[0].second);
+  ASSERT_FALSE(results[1].second);
+}
+
+TEST(my_art_set, basics) {
+  my::art_set<std::string> set = {"pear", "apple", "fig"};
+  ASSERT_FALSE(set.insert("fig").second);
+  ASSERT_TRUE(set.contains("apple"));
+  ASSERT_EQ("apple", *set.begin());
+  auto it = set.erase(set.find("fig"));
+  ASSERT_EQ("pear", *it);
+  ASSERT_EQ(2u, set.size());
+  my::art_set<std::string> other = {"kiwi", "pear"};
+  set.merge(other);
+  std::string joined;
+  for (const auto &word : set) joined += word + " ";
+  ASSERT_EQ("apple kiwi pear ", joined);
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "../my_containers_plus.h"
+
+TEST(my_compact_map, insert_find_erase) {
+  my::compact_map<int, std::string> m = {{3, "three"}, {1, "one"}};
+  ASSERT_TRUE(m.insert(2, "two").second);
+  ASSERT_FALSE(m.insert(2, "again").second);
+  ASSERT_EQ("two", m.at(2));
+  ASSERT_THROW(m.at(7), std::out_of_range);
+  m[7] = "seven";
+  m.insert_or_assign(3, "drei");
+  ASSERT_EQ("drei", m.find(3)->second);
+  ASSERT_EQ(4u, m.size());
+  ASSERT_TRUE(m.erase(1));
+  ASSERT_FALSE(m.erase(1));
+  ASSERT_FALSE(m.contains(1));
+  ASSERT_EQ(2, m.begin().cget());
+  ASSERT_EQ(7, m.lower_bound(4).cget());
+  ASSERT_EQ(7, m.upper_bound(3)->first);
+  ASSERT_TRUE(m.upper_bound(7) == m.end());
+  std::string joined;
+  for (auto item : m) joined += item.second + " ";
+  ASSERT_EQ("two drei seven ", joined);
+}
+
+TEST(my_compact_map, random_against_std_map) {
+  my::compact_map<int, int> m;
+  std::map<int, int> model;
+  unsigned state = 2463534242u;
+  for (int step = 0; step < 50000; step++) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    int key = int(state % 3000);
+    if (state % 7 < 4) {
+      m[key] = step;
+      model[key] = step;
+    } else {
+      ASSERT_EQ(model.erase(key) == 1, m.erase(key));
+    }
+  }
+  ASSERT_EQ(model.size(), m.size());
+  auto it = m.begin();
+  for (const auto &item : model) {
+    ASSERT_EQ(item.first, it->first);
+    ASSERT_EQ(item.second, it->second);
+    ++it;
+  }
+  ASSERT_TRUE(it == m.end());
+  --it;
+  ASSERT_EQ(model.rbegin()->first, it.cget());
+  // erased slots are reused, the arrays never outgrow the peak size
+  ASSERT_LE(m.memory_usage(), 4096 * (12 + 2 * sizeof(int)));
+}
+
+TEST(my_compact_map, copy_move_merge) {
+  my::compact_map<int, int> m;
+  for (int i = 0; i < 100; i++) m[i] = i;
+  my::compact_map<int, int> copy(m);
+  copy[5] = -5;
+  ASSERT_EQ(5, m[5]);
+  my::compact_map<int, int> moved(std::move(copy));
+  ASSERT_EQ(-5, moved.at(5));
+  my::compact_map<int, int> other = {{5, 50}, {200, 2}};
+  moved.merge(other);
+  ASSERT_EQ(101u, moved.size());
+  ASSERT_EQ(50, moved[5]);
+  moved = m;
+  ASSERT_EQ(5, moved[5]);
+  moved.clear();
+  ASSERT_TRUE(moved.empty());
+}
+
+TEST(my_compact_map, memory_per_entry) {
+  my::compact_map<int, int> m;
+  m.reserve(10000);
+  for (int i = 0; i < 10000; i++) m[i * 3] = i;
+  ASSERT_EQ(20u * 10000, m.memory_usage());  // 12 link bytes + key + value
+}
+
+TEST(my_compact_map, references_across_inserts) {  // checked under ASan
+  my::compact_map<int, std::string> m;
+  m.reserve(2);
+  m[0] = "zero";
+  m[1] = m[0];  // reserved room, the insert of 1 moves nothing
+  ASSERT_EQ("zero", m.at(1));
+  std::string &zero = m.at(0);
+  auto it = m.find(0);
+  ASSERT_TRUE(m.erase(1));
+  m[5] = "five";  // reuses the erased slot
+  ASSERT_EQ("zero", zero);
+  std::string copy = m[0];  // copied before an insert that grows
+  m[7] = copy;
+  for (int i = 10; i < 100; i++) m[i] = std::to_string(i);
+  ASSERT_EQ("zero", it.value());  // the iterator survives the growth
+  ASSERT_EQ("zero", m.at(7));
+}
+
+TEST(my_compact_set, basics) {
+  my::compact_set<std::string> s = {"pear", "apple", "fig"};
+  ASSERT_FALSE(s.insert("fig").second);
+  ASSERT_TRUE(s.contains("apple"));
+  ASSERT_EQ("apple", *s.begin());
+  auto it = s.erase(s.find("fig"));
+  ASSERT_EQ("pear", *it);
+  my::compact_set<std::string> other = {"kiwi"};
+  s.merge(other);
+  std::string joined;
+  for (const auto &word : s) joined += word + " ";
+  ASSERT_EQ("apple kiwi pear ", joined);
+  my::compact_set<int, std::greater<int>> down = {1, 3, 2};
+  ASSERT_EQ(3, *down.begin());
+}
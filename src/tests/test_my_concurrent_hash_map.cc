@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+TEST(my_concurrent_hash_map, empty_constructor) {
+  my::concurrent_hash_map<int, int> m;
+  ASSERT_EQ(0u, m.size());
+  ASSERT_TRUE(m.empty());
+  ASSERT_FALSE(m.contains(1));
+  ASSERT_FALSE(m.erase(1));
+}
+
+TEST(my_concurrent_hash_map, insert_find_erase) {
+  my::concurrent_hash_map<int, std::string> m = {
+      {54, "Adam"}, {93, "Eva"}, {23, "Nastya"}};
+  ASSERT_EQ(3u, m.size());
+  ASSERT_EQ("Eva", m.at(93));
+  ASSERT_FALSE(m.insert(93, "Migel"));
+  ASSERT_EQ("Eva", m.at(93));
+  ASSERT_FALSE(m.insert_or_assign(93, "Migel"));
+  ASSERT_EQ("Migel", m.at(93));
+  ASSERT_TRUE(m.insert_or_assign(12, "Fahruh"));
+  std::string value;
+  ASSERT_TRUE(m.find(12, value));
+  ASSERT_EQ("Fahruh", value);
+  ASSERT_TRUE(m.erase(54));
+  ASSERT_FALSE(m.find(54, value));
+  ASSERT_THROW(m.at(54), std::out_of_range);
+  ASSERT_EQ(3u, m.size());
+}
+
+TEST(my_concurrent_hash_map, grow) {
+  my::concurrent_hash_map<int, int> m;
+  for (int i = 0; i < 10000; i++) ASSERT_TRUE(m.insert(i, -i));
+  ASSERT_EQ(10000u, m.size());
+  ASSERT_GE(m.bucket_count(), 8192u);
+  for (int i = 0; i < 10000; i++) ASSERT_EQ(-i, m.at(i));
+  for (int i = 0; i < 10000; i += 2) ASSERT_TRUE(m.erase(i));
+  for (int i = 0; i < 10000; i++) ASSERT_EQ(i % 2 == 1, m.contains(i));
+  m.clear();
+  ASSERT_TRUE(m.empty());
+  ASSERT_TRUE(m.insert(1, 1));
+}
+
+TEST(my_concurrent_hash_map, concurrent_insert_erase) {
+  my::concurrent_hash_map<int, int> m;
+  const int kThreads = 4, kPerThread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&m, t] {
+      for (int i = 0; i < kPerThread; i++) m.insert(i * kThreads + t, t);
+      for (int i = 0; i < kPerThread; i += 2) m.erase(i * kThreads + t);
+    });
+  }
+  for (auto &th : threads) th.join();
+  ASSERT_EQ(size_t(kThreads * kPerThread / 2), m.size());
+  for (int key = 0; key < kThreads * kPerThread; key++) {
+    bool kept = (key / kThreads) % 2 == 1;
+    ASSERT_EQ(kept, m.contains(key));
+    if (kept) {
+      ASSERT_EQ(key % kThreads, m.at(key));
+    }
+  }
+}
+
+TEST(my_concurrent_hash_map, readers_during_grow) {
+  my::concurrent_hash_map<int, int> m;
+  for (int i = 0; i < 1000; i++) m.insert(i, i);
+  std::atomic<bool> done(false);
+  std::atomic<int> misses(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&] {  // keys below 1000 never go away
+      while (!done.load())
+        for (int i = 0; i < 1000; i += 7)
+          if (m.at(i) != i) ++misses;
+    });
+  }
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([&m, t] {
+      for (int i = 0; i < 20000; i++) m.insert_or_assign(1000 + i * 2 + t, i);
+    });
+  }
+  for (size_t t = 2; t < threads.size(); t++) threads[t].join();
+  done = true;
+  threads[0].join();
+  threads[1].join();
+  ASSERT_EQ(0, misses.load());
+  ASSERT_EQ(41000u, m.size());
+}
+
+TEST(my_concurrent_hash_map, concurrent_same_keys) {
+  my::concurrent_hash_map<int, int> m;
+  std::atomic<int> inserted(0), erased(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 200; i++)
+          if (m.insert(i, round)) ++inserted;
+        for (int i = 0; i < 200; i++)
+          if (m.erase(i)) ++erased;
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+  ASSERT_EQ(inserted.load() - erased.load(), int(m.size()));
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+TEST(my_concurrent_skiplist, empty_constructor) {
+  my::concurrent_skiplist_set<int> s;
+  ASSERT_EQ(0u, s.size());
+  ASSERT_TRUE(s.empty());
+  ASSERT_TRUE(s.begin() == s.end());
+}
+
+TEST(my_concurrent_skiplist, insert_contains) {
+  my::concurrent_skiplist_set<int> s = {54, 93, 23, 58, 12, 02, 29};
+  ASSERT_EQ(7u, s.size());
+  ASSERT_TRUE(s.contains(58));
+  ASSERT_FALSE(s.contains(59));
+  auto res1 = s.insert(40);
+  ASSERT_TRUE(res1.second);
+  ASSERT_EQ(40, *res1.first);
+  auto res2 = s.insert(40);
+  ASSERT_FALSE(res2.second);
+  ASSERT_EQ(40, *res2.first);
+  ASSERT_EQ(8u, s.size());
+}
+
+TEST(my_concurrent_skiplist, iterator_order) {
+  my::concurrent_skiplist_set<int> s = {54, 93, 23, 58, 12, 02, 29};
+  std::vector<int> out;
+  for (auto it = s.begin(); it != s.end(); ++it) out.push_back(*it);
+  ASSERT_EQ(out, std::vector<int>({2, 12, 23, 29, 54, 58, 93}));
+}
+
+TEST(my_concurrent_skiplist, erase) {
+  my::concurrent_skiplist_set<int> s = {54, 93, 23, 58, 12, 02, 29};
+  ASSERT_TRUE(s.erase(23));
+  ASSERT_FALSE(s.erase(23));
+  ASSERT_FALSE(s.contains(23));
+  ASSERT_EQ(6u, s.size());
+  ASSERT_TRUE(s.insert(23).second);
+  ASSERT_TRUE(s.contains(23));
+}
+
+TEST(my_concurrent_skiplist, bounds) {
+  my::concurrent_skiplist_set<int> s = {54, 93, 23, 58, 12, 02, 29};
+  ASSERT_EQ(23, *s.lower_bound(23));
+  ASSERT_EQ(29, *s.lower_bound(24));
+  ASSERT_TRUE(s.lower_bound(94) == s.end());
+  ASSERT_EQ(58, *s.find(58));
+  ASSERT_TRUE(s.find(57) == s.end());
+}
+
+TEST(my_concurrent_skiplist, map) {
+  my::concurrent_skiplist_map<int, std::string> m = {
+      {54, "Adam"}, {93, "Eva"}, {23, "Nastya"}};
+  ASSERT_EQ("Eva", m.at(93));
+  ASSERT_FALSE(m.insert(93, "Migel").second);
+  ASSERT_EQ("Eva", m.at(93));
+  ASSERT_TRUE(m.insert(83, "Migel").second);
+  ASSERT_EQ("Migel", m.lower_bound(60)->second);
+  ASSERT_TRUE(m.erase(54));
+  ASSERT_THROW(m.at(54), std::out_of_range);
+  ASSERT_EQ(3u, m.size());
+}
+
+TEST(my_concurrent_skiplist, concurrent_insert_erase) {
+  my::concurrent_skiplist_set<int> s;
+  const int kThreads = 4, kPerThread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&s, t] {
+      for (int i = 0; i < kPerThread; i++) s.insert(i * kThreads + t);
+      for (int i = 0; i < kPerThread; i += 2) s.erase(i * kThreads + t);
+    });
+  }
+  for (auto &th : threads) th.join();
+  ASSERT_EQ(size_t(kThreads * kPerThread / 2), s.size());
+  int prev = -1;
+  size_t count = 0;
+  for (auto it = s.begin(); it != s.end(); ++it, ++count) {
+    ASSERT_LT(prev, *it);
+    ASSERT_EQ(1, (*it / kThreads) % 2);
+    prev = *it;
+  }
+  ASSERT_EQ(s.size(), count);
+}
+
+TEST(my_concurrent_skiplist, concurrent_same_keys) {
+  my::concurrent_skiplist_set<int> s;
+  std::atomic<int> inserted(0), erased(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < 200; i++)
+          if (s.insert(i).second) ++inserted;
+        for (int i = 0; i < 200; i++)
+          if (s.erase(i)) ++erased;
+      }
+    });
+  }
+  for (auto &th : threads) th.join();
+  ASSERT_EQ(inserted.load() - erased.load(), int(s.size()));
+}
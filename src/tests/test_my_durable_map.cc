@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+
+#include <csignal>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+static std::string fresh_dir(const char *name) {
+  auto dir = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove_all(dir);
+  return dir.string();
+}
+
+TEST(my_durable_map, recover_from_log) {
+  std::string dir = fresh_dir("my_durable_map_log");
+  {
+    my::durable_map<int, std::string> m(dir);
+    ASSERT_TRUE(m.insert(54, "Adam"));
+    ASSERT_FALSE(m.insert(54, "Eva"));
+    ASSERT_TRUE(m.insert(93, "Eva"));
+    ASSERT_TRUE(m.insert_or_assign(23, "Nastya"));
+    ASSERT_FALSE(m.insert_or_assign(54, "Denis"));
+    ASSERT_TRUE(m.erase(93));
+    ASSERT_FALSE(m.erase(93));
+  }
+  my::durable_map<int, std::string> m(dir);
+  ASSERT_EQ(2u, m.size());
+  ASSERT_EQ("Denis", m.at(54));
+  ASSERT_EQ("Nastya", m.at(23));
+  ASSERT_FALSE(m.contains(93));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(my_durable_map, checkpoint) {
+  std::string dir = fresh_dir("my_durable_map_checkpoint");
+  my::durable_map<int, int>::options opts;
+  opts.sync = my::durable_map<int, int>::sync_policy::every_op;
+  opts.checkpoint_every = 10;
+  {
+    my::durable_map<int, int> m(dir, opts);
+    for (int i = 0; i < 25; i++) m.insert(i, i * i);
+    m.erase(3);
+    ASSERT_EQ(2u, m.get_stats().checkpoints);
+    ASSERT_EQ(26u, m.get_stats().syncs);
+  }
+  ASSERT_TRUE(std::filesystem::exists(dir + "/snapshot"));
+  ASSERT_FALSE(std::filesystem::exists(dir + "/wal-0"));
+  my::durable_map<int, int> m(dir, opts);
+  ASSERT_EQ(24u, m.size());
+  ASSERT_EQ(576, m.at(24));
+  ASSERT_FALSE(m.contains(3));
+  ASSERT_THROW(m.at(3), std::out_of_range);
+  std::filesystem::remove_all(dir);
+}
+
+TEST(my_durable_map, torn_tail) {
+  std::string dir = fresh_dir("my_durable_map_torn");
+  {
+    my::durable_map<int, int> m(dir);
+    m.insert(1, 10);
+    m.insert(2, 20);
+  }
+  std::ofstream(dir + "/wal-0", std::ios::app | std::ios::binary) << "torn";
+  {
+    my::durable_map<int, int> m(dir);
+    ASSERT_EQ(2u, m.size());
+    m.insert(3, 30);
+  }
+  my::durable_map<int, int> m(dir);
+  ASSERT_EQ(3u, m.size());
+  ASSERT_EQ(30, m.at(3));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(my_durable_map, group_commit) {
+  std::string dir = fresh_dir("my_durable_map_group");
+  {
+    my::durable_map<int, int> m(dir);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+      threads.emplace_back([&m, t] {
+        for (int i = 0; i < 50; i++) m.insert_or_assign(t * 100 + i, i);
+      });
+    for (auto &th : threads) th.join();
+    ASSERT_EQ(200u, m.get_stats().logged);
+    ASSERT_LE(m.get_stats().syncs, 200u);
+  }
+  my::durable_map<int, int> m(dir);
+  ASSERT_EQ(200u, m.size());
+  ASSERT_EQ(49, m.at(349));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(my_durable_map, failed_write_leaves_data_unchanged) {
+  std::string dir = fresh_dir("my_durable_map_failed");
+  using durable = my::durable_map<int, std::string>;
+  for (auto policy : {durable::sync_policy::every_op,
+                      durable::sync_policy::group}) {
+    std::filesystem::remove_all(dir);
+    durable::options opts;
+    opts.sync = policy;
+    {
+      durable m(dir, opts);
+      ASSERT_TRUE(m.insert(1, "one"));
+      rlimit saved;
+      getrlimit(RLIMIT_FSIZE, &saved);
+      rlimit small = saved;  // the log may not grow past its current size
+      small.rlim_cur = std::filesystem::file_size(dir + "/wal-0") + 4;
+      auto old_handler = std::signal(SIGXFSZ, SIG_IGN);
+      setrlimit(RLIMIT_FSIZE, &small);
+      ASSERT_THROW(m.insert(2, std::string(64, 'x')), std::runtime_error);
+      setrlimit(RLIMIT_FSIZE, &saved);
+      std::signal(SIGXFSZ, old_handler);
+      ASSERT_FALSE(m.contains(2));
+      ASSERT_EQ(1u, m.size());
+      ASSERT_TRUE(m.get_stats().failed);
+      ASSERT_THROW(m.insert(3, "three"), std::runtime_error);
+      ASSERT_FALSE(m.contains(3));
+    }
+    durable m(dir, opts);
+    ASSERT_EQ(1u, m.size());
+    ASSERT_EQ("one", m.at(1));
+    ASSERT_FALSE(m.get_stats().failed);
+  }
+  std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <string>
+
+#include "../my_containers_plus.h"
+
+TEST(my_expiring_map, expires_after_last_put) {
+  my::manual_clock clock(1000);
+  my::expiring_map<int, std::string> sessions(30, clock.source());
+  sessions.put(1, "alice");
+  sessions.put(2, "bob");
+  clock.advance(20);
+  sessions.put(2, "bob again");  // re-armed until 1050
+  ASSERT_EQ("alice", *sessions.get(1));
+  ASSERT_EQ(10u, sessions.expires_in(1));
+  clock.advance(9);
+  ASSERT_TRUE(sessions.contains(1));
+  clock.advance(1);  // 1030
+  ASSERT_FALSE(sessions.contains(1));
+  ASSERT_EQ(nullptr, sessions.get(1));
+  ASSERT_EQ("bob again", *sessions.get(2));
+  clock.advance(20);
+  ASSERT_EQ(1u, sessions.expire());
+  ASSERT_TRUE(sessions.empty());
+  ASSERT_EQ(2u, sessions.reaped());
+  ASSERT_THROW((my::expiring_map<int, int>(0)), std::invalid_argument);
+}
+
+TEST(my_expiring_map, erase_cancels) {
+  my::manual_clock clock;
+  my::expiring_map<int, int> timers(100, clock.source());
+  for (int i = 0; i < 10; i++) timers.put(i, i);
+  for (int i = 0; i < 10; i += 2) ASSERT_TRUE(timers.erase(i));
+  ASSERT_FALSE(timers.erase(0));
+  clock.advance(100);
+  ASSERT_FALSE(timers.erase(1));  // due already
+  timers.expire();
+  ASSERT_EQ(0u, timers.size());
+  ASSERT_EQ(5u, timers.reaped());  // 1 went before the erase found it
+  timers.put(5, 50, 3);  // own ttl
+  timers.put(6, 60, my::expiring_map<int, int>::kNever);
+  clock.advance(1000000000000);
+  timers.expire();
+  ASSERT_EQ(6u, timers.reaped());
+  ASSERT_EQ(60, *timers.get(6));
+}
+
+TEST(my_expiring_map, matches_reference) {
+  // ttls from a tick to a few days in ms cross every cascade level
+  my::manual_clock clock(77);
+  my::expiring_map<int, int> map(1000, clock.source());
+  std::map<int, std::pair<int, my::ticks>> model;  // value and deadline
+  unsigned state = 5;
+  auto next = [&state] {
+    state = state * 1103515245u + 12345u;
+    return state >> 8;
+  };
+  for (int step = 0; step < 50000; step++) {
+    int key = int(next() % 500);
+    switch (next() % 4) {
+      case 0: {
+        my::ticks ttl = my::ticks(1) << (next() % 29);
+        ttl += next() % ttl;
+        map.put(key, step, ttl);
+        model[key] = {step, clock.now() + ttl};
+        break;
+      }
+      case 1: {
+        auto it = model.find(key);
+        bool live = it != model.end() && it->second.second > clock.now();
+        ASSERT_EQ(live, map.erase(key));
+        if (it != model.end()) model.erase(it);
+        break;
+      }
+      case 2: {
+        auto it = model.find(key);
+        const int *value = map.get(key);
+        if (it != model.end() && it->second.second > clock.now()) {
+          ASSERT_NE(nullptr, value);
+          ASSERT_EQ(it->second.first, *value);
+        } else {
+          ASSERT_EQ(nullptr, value);
+        }
+        break;
+      }
+      default:
+        clock.advance(my::ticks(1) << (next() % 24));
+    }
+    if (step % 5000 == 0) {
+      map.expire();
+      for (auto it = model.begin(); it != model.end();)
+        it = it->second.second <= clock.now() ? model.erase(it) : ++it;
+      ASSERT_EQ(model.size(), map.size());
+      for (const auto &item : model)
+        ASSERT_EQ(item.second.second - clock.now(), map.expires_in(item.first));
+    }
+  }
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <iterator>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+TEST(my_flat_map, matches_std_map) {
+  my::flat_map<int, int> m;
+  std::map<int, int> ref;
+  unsigned state = 11;
+  for (int i = 0; i < 20000; i++) {
+    state = state * 1103515245u + 12345u;
+    int key = int((state >> 8) % 3000) - 1000;
+    switch (i % 4) {
+      case 0:
+      case 1: {
+        auto got = m.insert(key, i);
+        ASSERT_EQ(ref.insert({key, i}).second, got.second);
+        ASSERT_EQ(key, got.first.cget());
+        break;
+      }
+      case 2:
+        ASSERT_EQ(ref.erase(key) == 1, m.erase(key));
+        break;
+      default:
+        m.insert_or_assign(key, -i);
+        ref[key] = -i;
+    }
+  }
+  ASSERT_EQ(ref.size(), m.size());
+  auto expected = ref.begin();
+  for (auto it = m.begin(); it != m.end(); ++it, ++expected) {
+    ASSERT_EQ(expected->first, it->first);
+    ASSERT_EQ(expected->second, it->second);
+  }
+  for (int key = -1100; key < 2100; key += 7) {
+    ASSERT_EQ(ref.count(key), m.count(key));
+    auto lower = ref.lower_bound(key);
+    auto upper = ref.upper_bound(key);
+    ASSERT_EQ(lower == ref.end(), m.lower_bound(key) == m.end());
+    if (lower != ref.end()) {
+      ASSERT_EQ(lower->first, m.lower_bound(key).cget());
+    }
+    if (upper != ref.end()) {
+      ASSERT_EQ(upper->first, m.upper_bound(key).cget());
+    }
+  }
+  ASSERT_THROW(m.at(5000), std::out_of_range);
+  m[5000] += 3;
+  ASSERT_EQ(3, m.at(5000));
+}
+
+TEST(my_flat_map, insert_many_and_merge) {
+  my::flat_map<std::string, int> m{{"b", 2}, {"d", 4}};
+  auto res = m.insert_many(std::make_pair(std::string("c"), 3),
+                           std::make_pair(std::string("a"), 1),
+                           std::make_pair(std::string("d"), 40),
+                           std::make_pair(std::string("c"), 30));
+  ASSERT_EQ(4u, res.size());
+  ASSERT_TRUE(res[0].second);
+  ASSERT_TRUE(res[1].second);
+  ASSERT_FALSE(res[2].second);  // existing key keeps its value
+  ASSERT_FALSE(res[3].second);  // the first of the batch wins
+  ASSERT_EQ("a", res[1].first.cget());
+  ASSERT_EQ(4u, m.size());
+  ASSERT_EQ(3, m.at("c"));
+  ASSERT_EQ(4, m.at("d"));
+
+  my::flat_map<std::string, int> other{{"d", 44}, {"e", 5}};
+  m.merge(other);
+  ASSERT_EQ(5u, m.size());
+  ASSERT_EQ(44, m.at("d"));  // values of other win
+  std::string order;
+  for (auto it = m.begin(); it != m.end(); ++it) order += it.cget();
+  ASSERT_EQ("abcde", order);
+  my::flat_map<std::string, int> copy = m;
+  copy.erase(copy.begin());
+  ASSERT_EQ(5u, m.size());
+  ASSERT_EQ(4u, copy.size());
+  auto last = copy.end();
+  --last;
+  ASSERT_EQ("e", last.cget());
+}
+
+TEST(my_flat_set, matches_std_set) {
+  my::flat_set<int, std::greater<int>> s;
+  std::set<int, std::greater<int>> ref;
+  unsigned state = 5;
+  for (int i = 0; i < 20000; i++) {
+    state = state * 1103515245u + 12345u;
+    int key = int((state >> 8) % 5000);
+    if (i % 3 == 2) {
+      ASSERT_EQ(ref.erase(key) == 1, s.erase(key));
+    } else {
+      ASSERT_EQ(ref.insert(key).second, s.insert(key).second);
+    }
+  }
+  ASSERT_EQ(std::vector<int>(ref.begin(), ref.end()),
+            std::vector<int>(s.begin(), s.end()));
+  auto res = s.insert_many(6000, *s.begin(), 7000, 6000);
+  ASSERT_TRUE(res[0].second);
+  ASSERT_FALSE(res[1].second);
+  ASSERT_TRUE(res[2].second);
+  ASSERT_FALSE(res[3].second);
+  ASSERT_EQ(7000, *s.begin());
+  ASSERT_EQ(ref.size() + 2, s.size());
+
+  my::flat_set<int> a{5, 1, 3}, b{4, 3, 2};
+  a.merge(b);
+  ASSERT_EQ((std::vector<int>{1, 2, 3, 4, 5}),
+            std::vector<int>(a.begin(), a.end()));
+  for (auto it = a.begin(); it != a.end();)
+    it = *it % 2 ? a.erase(it) : it + 1;
+  ASSERT_EQ((std::vector<int>{2, 4}), std::vector<int>(a.begin(), a.end()));
+}
+
+TEST(my_flat_multiset, matches_std_multiset) {
+  my::flat_multiset<int> s{3, 1, 3};
+  std::multiset<int> ref{3, 1, 3};
+  unsigned state = 9;
+  for (int i = 0; i < 5000; i++) {
+    state = state * 1103515245u + 12345u;
+    int key = int((state >> 8) % 300);
+    if (i % 4 == 3) {
+      auto it = ref.find(key);
+      ASSERT_EQ(it != ref.end(), s.erase(key));
+      if (it != ref.end()) ref.erase(it);
+    } else {
+      ASSERT_EQ(key, *s.insert(key));
+      ref.insert(key);
+    }
+  }
+  s.insert_many(7, 7, 400);
+  ref.insert({7, 7, 400});
+  my::flat_multiset<int> more{7, -1};
+  s.merge(more);
+  ref.insert({7, -1});
+  ASSERT_EQ(std::vector<int>(ref.begin(), ref.end()),
+            std::vector<int>(s.begin(), s.end()));
+  for (int key = -2; key < 402; key++) {
+    ASSERT_EQ(ref.count(key), s.count(key));
+    auto range = s.equal_range(key);
+    ASSERT_EQ(ref.count(key), size_t(range.second - range.first));
+  }
+  ASSERT_EQ(-1, s.select(0));
+  ASSERT_EQ(400, s.select(s.size() - 1));
+  ASSERT_EQ(size_t(std::distance(ref.begin(), ref.lower_bound(7))),
+            s.rank(7));
+  ASSERT_THROW(s.select(s.size()), std::out_of_range);
+}
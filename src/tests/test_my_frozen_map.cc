@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include "../my_containers_plus.h"
+
+namespace {
+
+enum class method { kGet, kPut, kDelete, kHead, kPost };
+
+constexpr auto kCommands = my::make_frozen_map<std::string_view, int>({
+    {"get", 1},
+    {"put", 2},
+    {"del", 3},
+    {"scan", 4},
+    {"flush", 5},
+    {"stats", 6},
+    {"ping", 7},
+});
+
+constexpr auto kMethods = my::make_frozen_map<method, std::string_view>({
+    {method::kGet, "GET"},
+    {method::kPut, "PUT"},
+    {method::kDelete, "DELETE"},
+    {method::kHead, "HEAD"},
+});
+
+constexpr auto kPrimes = my::make_frozen_set<int>({2, 3, 5, 7, 11, 13, 17});
+
+static_assert(kCommands.at("flush") == 5, "lookup at compile time");
+static_assert(!kCommands.contains("gets"), "miss at compile time");
+static_assert(kMethods.at(method::kDelete) == "DELETE", "enum keys");
+static_assert(kPrimes.contains(13) && !kPrimes.contains(9), "set lookup");
+
+}  // namespace
+
+TEST(my_frozen_map, lookup) {
+  ASSERT_EQ(7u, kCommands.size());
+  ASSERT_FALSE(kCommands.empty());
+  ASSERT_EQ(1, kCommands.at("get"));
+  ASSERT_EQ(7, kCommands["ping"]);
+  std::string key = "scan";
+  ASSERT_EQ(4, kCommands.find(key)->second);
+  ASSERT_TRUE(kCommands.find("scans") == kCommands.end());
+  ASSERT_EQ(1u, kCommands.count("stats"));
+  ASSERT_EQ(0u, kCommands.count(""));
+  ASSERT_THROW(kCommands.at("nope"), std::out_of_range);
+  ASSERT_FALSE(kMethods.contains(method::kPost));
+}
+
+TEST(my_frozen_map, iterate_in_list_order) {
+  int expected = 1;
+  for (const auto &item : kCommands) ASSERT_EQ(expected++, item.second);
+  ASSERT_EQ(8, expected);
+}
+
+TEST(my_frozen_map, set) {
+  ASSERT_EQ(7u, kPrimes.size());
+  for (int i = 0; i < 20; i++) {
+    bool prime = i == 2 || i == 3 || i == 5 || i == 7 || i == 11 || i == 13 ||
+                 i == 17;
+    ASSERT_EQ(prime, kPrimes.contains(i));
+  }
+  ASSERT_EQ(11, *kPrimes.find(11));
+  ASSERT_EQ(2, *kPrimes.begin());
+}
+
+TEST(my_frozen_map, many_keys) {
+  constexpr auto squares = my::make_frozen_set<long>(
+      {0,    1,    4,    9,    16,   25,   36,   49,   64,   81,   100,
+       121,  144,  169,  196,  225,  256,  289,  324,  361,  400,  441,
+       484,  529,  576,  625,  676,  729,  784,  841,  900,  961,  1024,
+       1089, 1156, 1225, 1296, 1369, 1444, 1521, 1600, 1681, 1764, 1849});
+  for (long i = 0; i < 1900; i++) {
+    long root = 0;
+    while ((root + 1) * (root + 1) <= i) root++;
+    ASSERT_EQ(root * root == i, squares.contains(i));
+  }
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "../my_containers_plus.h"
+
+TEST(my_hashtable, empty_constructor) {
+  my::unordered_set<int> s;
+  ASSERT_EQ(0u, s.size());
+  ASSERT_TRUE(s.empty());
+  ASSERT_FALSE(s.contains(1));
+  ASSERT_TRUE(s.begin() == s.end());
+  ASSERT_FALSE(s.erase(1));
+}
+
+TEST(my_hashtable, set_insert_contains) {
+  my::unordered_set<int> s = {54, 93, 23, 58, 12, 02, 29};
+  ASSERT_EQ(7u, s.size());
+  ASSERT_TRUE(s.contains(58));
+  ASSERT_FALSE(s.contains(59));
+  auto res1 = s.insert(40);
+  ASSERT_TRUE(res1.second);
+  ASSERT_EQ(40, *res1.first);
+  auto res2 = s.insert(40);
+  ASSERT_FALSE(res2.second);
+  ASSERT_EQ(40, *res2.first);
+  ASSERT_EQ(8u, s.size());
+  ASSERT_EQ(23, *s.find(23));
+  ASSERT_TRUE(s.find(24) == s.end());
+}
+
+TEST(my_hashtable, set_iterate_and_erase) {
+  my::unordered_set<int> s = {54, 93, 23, 58, 12, 02, 29};
+  std::set<int> seen;
+  for (auto it = s.begin(); it != s.end(); ++it) seen.insert(*it);
+  ASSERT_EQ(seen, std::set<int>({2, 12, 23, 29, 54, 58, 93}));
+  for (auto it = s.begin(); it != s.end();) {
+    if (*it % 2)
+      it = s.erase(it);
+    else
+      ++it;
+  }
+  ASSERT_EQ(4u, s.size());
+  ASSERT_FALSE(s.contains(93));
+  ASSERT_TRUE(s.contains(58));
+}
+
+TEST(my_hashtable, grow_and_tombstones) {
+  my::unordered_set<long> s;
+  std::set<long> model;
+  for (long i = 0; i < 20000; i++) {
+    long key = (i * 7919) % 5000;
+    if (i % 3 == 0) {
+      ASSERT_EQ(model.erase(key) == 1, s.erase(key));
+    } else {
+      ASSERT_EQ(model.insert(key).second, s.insert(key).second);
+    }
+  }
+  ASSERT_EQ(model.size(), s.size());
+  for (long key = 0; key < 5000; key++)
+    ASSERT_EQ(model.count(key) == 1, s.contains(key));
+  ASSERT_LE(s.load_factor(), 0.875);
+}
+
+TEST(my_hashtable, map_access) {
+  my::unordered_map<int, std::string> m = {
+      {54, "Adam"}, {93, "Eva"}, {23, "Nastya"}};
+  ASSERT_EQ("Eva", m.at(93));
+  ASSERT_THROW(m.at(94), std::out_of_range);
+  ASSERT_FALSE(m.insert(93, "Migel").second);
+  ASSERT_EQ("Eva", m.at(93));
+  ASSERT_FALSE(m.insert_or_assign(93, "Migel").second);
+  ASSERT_EQ("Migel", m.at(93));
+  m[12] = "Fahruh";
+  ASSERT_EQ(4u, m.size());
+  ASSERT_EQ("", m[13]);
+  ASSERT_EQ(5u, m.size());
+  ASSERT_TRUE(m.erase(13));
+  ASSERT_FALSE(m.erase(13));
+  m.erase(m.find(12));
+  ASSERT_FALSE(m.contains(12));
+  ASSERT_EQ(3u, m.size());
+}
+
+TEST(my_hashtable, map_copy_move_merge) {
+  my::unordered_map<std::string, int> m1 = {{"a", 1}, {"b", 2}};
+  my::unordered_map<std::string, int> m2(m1);
+  m2["c"] = 3;
+  ASSERT_EQ(2u, m1.size());
+  ASSERT_EQ(3u, m2.size());
+  my::unordered_map<std::string, int> m3(std::move(m2));
+  ASSERT_TRUE(m2.empty());
+  ASSERT_EQ(3, m3.at("c"));
+  m1 = m3;
+  ASSERT_EQ(3u, m1.size());
+  my::unordered_map<std::string, int> m4 = {{"a", 10}, {"d", 4}};
+  m1.merge(m4);
+  ASSERT_EQ(4u, m1.size());
+  ASSERT_EQ(10, m1.at("a"));
+  ASSERT_EQ(2u, m4.size());
+}
+
+TEST(my_hashtable, insert_many) {
+  my::unordered_map<int, int> m;
+  auto out = m.insert_many(std::make_pair(1, 1), std::make_pair(2, 2),
+                           std::make_pair(1, 3));
+  ASSERT_EQ(3u, out.size());
+  ASSERT_TRUE(out[0].second);
+  ASSERT_FALSE(out[2].second);
+  ASSERT_EQ(1, m.at(1));
+  my::unordered_set<int> s;
+  auto keys = s.insert_many(5, 6, 5);
+  ASSERT_EQ(2u, s.size());
+  ASSERT_FALSE(keys[2].second);
+}
+
+TEST(my_hashtable, matches_std_unordered_map) {
+  my::unordered_map<int, int> m;
+  std::unordered_map<int, int> model;
+  m.reserve(1000);
+  for (int i = 0; i < 30000; i++) {
+    int key = int((i * 104729L) % 3000);
+    if (i % 4 == 0) {
+      ASSERT_EQ(model.erase(key) == 1, m.erase(key));
+    } else {
+      m[key] += i;
+      model[key] += i;
+    }
+  }
+  ASSERT_EQ(model.size(), m.size());
+  size_t visited = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++visited)
+    ASSERT_EQ(model.at(it->first), it->second);
+  ASSERT_EQ(model.size(), visited);
+  m.clear();
+  ASSERT_TRUE(m.empty());
+  ASSERT_FALSE(m.contains(1));
+}
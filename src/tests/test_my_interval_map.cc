@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+TEST(my_interval_map, insert_erase) {
+  my::interval_map<int> m = {{10, 20}, {1, 5}};
+  ASSERT_TRUE(m.insert(7, 7));
+  ASSERT_FALSE(m.insert(7, 30));
+  ASSERT_EQ(7, m.at(7));
+  m.insert_or_assign(7, 30);
+  ASSERT_EQ(30, m.at(7));
+  ASSERT_EQ(3u, m.size());
+  ASSERT_THROW(m.insert(4, 3), std::invalid_argument);
+  ASSERT_THROW(m.at(2), std::out_of_range);
+  ASSERT_TRUE(m.erase(1));
+  ASSERT_FALSE(m.erase(1));
+  ASSERT_FALSE(m.contains(1));
+  std::vector<std::pair<int, int>> all;
+  m.for_each([&all](int start, int end) { all.push_back({start, end}); });
+  ASSERT_EQ((std::vector<std::pair<int, int>>{{7, 30}, {10, 20}}), all);
+  m.clear();
+  ASSERT_TRUE(m.empty());
+}
+
+TEST(my_interval_map, point_and_range_queries) {
+  my::interval_map<int> m = {{1, 3}, {2, 8}, {5, 6}, {9, 12}, {14, 14}};
+  auto hits = m.overlapping(5);
+  ASSERT_EQ(2u, hits.size());
+  ASSERT_EQ(std::make_pair(2, 8), hits[0]);
+  ASSERT_EQ(std::make_pair(5, 6), hits[1]);
+  ASSERT_EQ(0u, m.overlapping(13).size());
+  ASSERT_EQ(1u, m.overlapping(14).size());  // closed on both ends
+  hits = m.overlapping(7, 9);
+  ASSERT_EQ(2u, hits.size());
+  ASSERT_EQ(std::make_pair(9, 12), hits[1]);
+  ASSERT_TRUE(m.overlaps(12, 13));
+  ASSERT_FALSE(m.overlaps(13, 13));
+  ASSERT_FALSE(m.overlaps(15, 100));
+  ASSERT_EQ(5u, m.overlapping(-100, 100).size());
+}
+
+template <typename Balance>
+void check_against_scan() {
+  my::interval_map<int, std::less<int>, Balance> m;
+  std::map<int, int> model;
+  unsigned state = 777;
+  auto next = [&state](int range) {
+    state = state * 1103515245u + 12345u;
+    return int(state >> 16) % range;
+  };
+  for (int step = 0; step < 6000; step++) {
+    int start = next(2000);
+    if (step % 4 == 3) {
+      ASSERT_EQ(model.erase(start) == 1, m.erase(start));
+    } else {
+      int end = start + next(step % 2 ? 20 : 300);
+      m.insert_or_assign(start, end);
+      model[start] = end;
+    }
+    if (step % 20 == 0) {
+      int lo = next(2100), hi = lo + next(step % 3 ? 1 : 60);
+      std::vector<std::pair<int, int>> expected;
+      for (const auto& item : model)
+        if (item.first <= hi && item.second >= lo) expected.push_back(item);
+      auto hits = m.overlapping(lo, hi);
+      ASSERT_EQ(expected.size(), hits.size());
+      for (size_t i = 0; i < hits.size(); i++)
+        ASSERT_EQ(expected[i], hits[i]);
+      ASSERT_EQ(!expected.empty(), m.overlaps(lo, hi));
+    }
+  }
+  ASSERT_EQ(model.size(), m.size());
+}
+
+TEST(my_interval_map, matches_scan) {
+  check_against_scan<my::rb_balance>();
+  check_against_scan<my::avl_balance>();
+  check_against_scan<my::splay_balance>();
+}
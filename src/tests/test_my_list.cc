@@ -580,3 +580,30 @@ TEST(my_list, insert_many_front_function) {
     EXPECT_EQ(*std_it, *my_it);
   }
 }
+
+TEST(my_list, splice_one_element) {
+  my::list<int> my_list1 = {1, 2, 3, 4};
+  my::list<int> my_list2 = {10, 20};
+
+  auto it = my_list1.begin();
+  ++it;
+  ++it;  // 3 to the front of its own list
+  my_list1.splice(my_list1.cbegin(), my_list1, it);
+  std::list<int> std_list1 = {3, 1, 2, 4};
+  auto my_it = my_list1.begin();
+  for (auto std_it = std_list1.begin(); std_it != std_list1.end();
+       ++std_it, ++my_it) {
+    EXPECT_EQ(*std_it, *my_it);
+  }
+  EXPECT_EQ(3, *it);
+
+  my_list2.splice(my_list2.cend(), my_list1, my_list1.cbegin());
+  EXPECT_EQ(3u, my_list1.size());
+  EXPECT_EQ(3u, my_list2.size());
+  EXPECT_EQ(3, my_list2.back());
+  EXPECT_EQ(1, my_list1.front());
+
+  my::list<int> empty;
+  my_list1.splice(my_list1.cend(), empty);  // nothing to move
+  EXPECT_EQ(3u, my_list1.size());
+}
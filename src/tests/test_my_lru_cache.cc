@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "../my_containers_plus.h"
+
+TEST(my_lru_cache, evicts_least_recent) {
+  my::lru_cache<int, std::string> cache(2);
+  ASSERT_EQ(nullptr, cache.get(1));
+  cache.put(1, "one");
+  cache.put(2, "two");
+  ASSERT_EQ("one", *cache.get(1));  // 2 is now the oldest
+  cache.put(3, "three");
+  ASSERT_FALSE(cache.contains(2));
+  ASSERT_TRUE(cache.contains(1));
+  cache.put(1, "uno");
+  ASSERT_EQ("uno", *cache.get(1));
+  ASSERT_EQ(2u, cache.size());
+  ASSERT_TRUE(cache.erase(3));
+  ASSERT_FALSE(cache.erase(3));
+  const my::cache_stats &stats = cache.stats();
+  ASSERT_EQ(2u, stats.hits);
+  ASSERT_EQ(1u, stats.misses);
+  ASSERT_EQ(3u, stats.inserts);
+  ASSERT_EQ(1u, stats.updates);
+  ASSERT_EQ(1u, stats.evictions);
+  ASSERT_DOUBLE_EQ(2.0 / 3, stats.hit_rate());
+  ASSERT_THROW((my::lru_cache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(my_lru_cache, byte_capacity) {
+  my::lru_cache<int, std::string> cache(
+      10, [](const int &, const std::string &value) { return value.size(); });
+  cache.put(1, "aaaa");
+  cache.put(2, "bbbb");
+  ASSERT_EQ(8u, cache.used());
+  cache.put(3, "cccc");  // 1 goes
+  ASSERT_FALSE(cache.contains(1));
+  ASSERT_EQ(8u, cache.used());
+  cache.put(4, "dddddddddddd");  // more than everything
+  ASSERT_FALSE(cache.contains(4));
+  ASSERT_EQ(1u, cache.stats().rejected);
+  cache.put(2, "bbbbbbbbb");  // grows, 3 goes
+  ASSERT_EQ(1u, cache.size());
+  ASSERT_EQ(9u, cache.used());
+}
+
+TEST(my_lru_cache, matches_reference) {
+  my::lru_cache<int, int> cache(64);
+  std::list<std::pair<int, int>> order;  // most recent first
+  std::unordered_map<int, std::list<std::pair<int, int>>::iterator> index;
+  unsigned state = 17;
+  for (int step = 0; step < 20000; step++) {
+    state = state * 1103515245u + 12345u;
+    int key = int(state >> 16) % 150;
+    if (step % 2) {
+      const int *value = cache.get(key);
+      auto found = index.find(key);
+      ASSERT_EQ(found != index.end(), value != nullptr);
+      if (value) {
+        ASSERT_EQ(found->second->second, *value);
+        order.splice(order.begin(), order, found->second);
+      }
+    } else {
+      cache.put(key, step);
+      auto found = index.find(key);
+      if (found != index.end()) order.erase(found->second);
+      order.push_front({key, step});
+      index[key] = order.begin();
+      if (order.size() > 64) {
+        index.erase(order.back().first);
+        order.pop_back();
+      }
+    }
+  }
+  ASSERT_EQ(order.size(), cache.size());
+  for (const auto &item : order) ASSERT_TRUE(cache.contains(item.first));
+}
+
+TEST(my_lfu_cache, evicts_least_used) {
+  my::lfu_cache<int, int> cache(3);
+  cache.put(1, 10);
+  cache.put(2, 20);
+  cache.put(3, 30);
+  cache.get(1);
+  cache.get(1);
+  cache.get(3);
+  ASSERT_EQ(3u, cache.uses(1));
+  cache.put(4, 40);  // 2 has the fewest uses
+  ASSERT_FALSE(cache.contains(2));
+  cache.put(5, 50);  // 4 and none else at one use
+  ASSERT_FALSE(cache.contains(4));
+  ASSERT_EQ(10, *cache.get(1));
+  for (int key = 100; key < 200; key++) cache.put(key, key);  // a scan
+  ASSERT_TRUE(cache.contains(1));  // survives it
+  ASSERT_TRUE(cache.contains(3));
+  ASSERT_EQ(100u, cache.stats().evictions - 2);
+  ASSERT_TRUE(cache.erase(1));
+  ASSERT_EQ(2u, cache.size());
+}
+
+TEST(my_lfu_cache, byte_capacity) {
+  my::lfu_cache<int, std::string> cache(
+      10, [](const int &, const std::string &value) { return value.size(); });
+  cache.put(1, "aaa");
+  cache.put(2, "bbb");
+  cache.put(3, "ccc");
+  cache.get(1);
+  cache.get(3);
+  cache.put(1, "aaaaaa");  // grows, 2 goes, 1 keeps its uses
+  ASSERT_FALSE(cache.contains(2));
+  ASSERT_EQ(9u, cache.used());
+  ASSERT_EQ(3u, cache.uses(1));
+  cache.put(3, "cccccccc");  // 1 is used more than 3, yet 3 stays
+  ASSERT_TRUE(cache.contains(3));
+  ASSERT_FALSE(cache.contains(1));
+  cache.put(5, "eeeeeeeeeeee");
+  ASSERT_EQ(1u, cache.stats().rejected);
+  cache.clear();
+  ASSERT_TRUE(cache.empty());
+  ASSERT_EQ(0u, cache.used());
+}
@@ -1,5 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <strings.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "../my_containers.h"
 
 TEST(my_map, empty_constructor) {
@@ -311,3 +322,490 @@ TEST(my_map, insert_many) {
   ASSERT_EQ(out[2], std::make_pair(it.set(91), false));
   ASSERT_EQ(out[3], std::make_pair(it.set(71), false));
 }
+
+TEST(my_map, serialize) {
+  my::map<int, std::string> m1 = {
+    {54, "Adam"},
+    {93, "Eva"},
+    {23, "Nastya"},
+    {58, "Denis"},
+    {12, "Fahruh"},
+    {02, "Mila"},
+    {29, "Hamich"}
+  };
+  std::stringstream stream;
+  m1.serialize(stream);
+  my::map<int, std::string> m2 = {{1, "Old"}};
+  m2.deserialize(stream);
+  ASSERT_EQ(7u, m2.size());
+  ASSERT_FALSE(m2.contains(1));
+  ASSERT_EQ("Hamich", m2.at(29));
+  ASSERT_EQ("Mila", m2.at(02));
+  my::map<int, std::string>::iterator it = m2.begin();
+  ASSERT_EQ(02, it.cget());
+  ++it;
+  ASSERT_EQ(12, it.cget());
+  m2[40] = "Valentina";
+  ASSERT_EQ(8u, m2.size());
+  ASSERT_EQ("Valentina", m2.at(40));
+}
+
+TEST(my_map, serialize_bulk) {
+  my::map<int, double> m1;
+  for (int i = 0; i < 1000; i++) m1[i * 7 % 1000] = i * 0.5;
+  std::stringstream stream;
+  m1.serialize(stream);
+  my::map<int, double> m2;
+  m2.deserialize(stream);
+  ASSERT_EQ(1000u, m2.size());
+  for (int i = 0; i < 1000; i++) ASSERT_EQ(i * 0.5, m2.at(i * 7 % 1000));
+}
+
+TEST(my_map, deserialize_bad_stream) {
+  std::stringstream garbage("definitely not a map");
+  my::map<int, int> m;
+  ASSERT_THROW(m.deserialize(garbage), std::invalid_argument);
+  my::map<int, int> m1 = {{1, 2}};
+  std::stringstream stream;
+  m1.serialize(stream);
+  my::map<long, int> m2;
+  ASSERT_THROW(m2.deserialize(stream), std::invalid_argument);
+}
+
+TEST(my_map, deserialize_forged_sizes) {  // fails fast, no huge allocation
+  my::map<int, std::string> m1 = {{1, "one"}};
+  std::stringstream stream;
+  m1.serialize(stream);
+  uint64_t huge = uint64_t(1) << 40;
+  std::string bytes = stream.str();
+  std::memcpy(&bytes[16], &huge, sizeof(huge));  // element count
+  std::stringstream forged_count(bytes);
+  my::map<int, std::string> m2;
+  ASSERT_THROW(m2.deserialize(forged_count), std::invalid_argument);
+  bytes = stream.str();
+  std::memcpy(&bytes[28], &huge, sizeof(huge));  // length of "one"
+  std::stringstream forged_length(bytes);
+  ASSERT_THROW(m2.deserialize(forged_length), std::invalid_argument);
+}
+
+TEST(my_map, copy_on_write) {
+  my::map<int, std::string> m1 = {
+    {54, "Adam"},
+    {93, "Eva"},
+    {23, "Nastya"},
+    {58, "Denis"}
+  };
+  my::map<int, std::string> m2(m1);
+  const my::map<int, std::string>& view = m2;
+  ASSERT_EQ("Eva", view.at(93));
+  ASSERT_TRUE(m2.contains(23));
+  m2[93] = "Gaga";
+  m2.insert(12, "Fahruh");
+  ASSERT_NE(m1.begin().current_node, m2.begin().current_node);
+  ASSERT_EQ("Eva", m1.at(93));
+  ASSERT_EQ("Gaga", m2.at(93));
+  ASSERT_EQ(4u, m1.size());
+  ASSERT_EQ(5u, m2.size());
+  ASSERT_FALSE(m1.contains(12));
+  my::map<int, std::string>::iterator it = m2.begin();
+  ASSERT_EQ(12, it.cget());
+  ++it;
+  ASSERT_EQ(23, it.cget());
+}
+
+TEST(my_map, copy_on_write_nodes) {  // const reads share, begin() detaches
+  my::bitree<int, int> t1;
+  t1 << std::make_pair(1, 10) << std::make_pair(2, 20);
+  my::bitree<int, int> t2(t1);
+  ASSERT_EQ(t1.get_root(), t2.get_root());
+  const my::bitree<int, int>& view = t2;
+  ASSERT_EQ(20, view.find_value(2));
+  ASSERT_EQ(t1.get_root(), t2.get_root());
+  {
+    auto it = t2.begin();
+    ASSERT_NE(t1.get_root(), t2.get_root());
+    my::bitree<int, int> t3(t2);  // an iterator of t2 is out, no sharing
+    ASSERT_NE(t2.get_root(), t3.get_root());
+  }
+  my::bitree<int, int> t4(t2);  // it is gone, copies share again
+  ASSERT_EQ(t2.get_root(), t4.get_root());
+}
+
+TEST(my_map, insert_built_copies_share) {
+  my::map<int, int> m;
+  for (int i = 0; i < 100; i++) m.insert(i, i);
+  m.insert_or_assign(7, 70);
+  const my::map<int, int>& view = m;
+  my::map<int, int> copy(m);
+  const my::map<int, int>& copy_view = copy;
+  ASSERT_EQ(&view.at(5), &copy_view.at(5));  // same node
+  int sum = 0;
+  {
+    auto it = m.begin();
+    for (size_t i = 0; i < m.size(); i++, ++it) sum += it.cget();
+  }
+  ASSERT_EQ(4950, sum);
+  my::map<int, int> after_walk(m);  // the walk is over, copies share again
+  const my::map<int, int>& walk_view = after_walk;
+  ASSERT_EQ(&view.at(5), &walk_view.at(5));
+  auto held = m.insert(200, 200).first;  // while it is out, copies are deep
+  my::map<int, int> deep(m);
+  const my::map<int, int>& deep_view = deep;
+  ASSERT_NE(&view.at(5), &deep_view.at(5));
+  ASSERT_EQ(200, held.cget());
+}
+
+TEST(my_map, iterators_survive_copies) {  // checked under ASan as well
+  my::map<int, int> a = {{1, 1}, {2, 2}};
+  my::map<int, int> b = a;
+  b.begin().get() = 100;  // writes b's own nodes only
+  ASSERT_EQ(1, a.begin().cget());
+  my::map<int, int> c = {{1, 1}, {2, 2}, {3, 3}};
+  auto it = c.begin();
+  my::map<int, int> d = c;
+  c.insert(5, 5);
+  d.erase(1);
+  ASSERT_EQ(1, it.cget());
+  ++it;
+  ASSERT_EQ(2, it.cget());
+  ASSERT_FALSE(d.contains(1));
+  ASSERT_TRUE(c.contains(1));
+}
+
+TEST(my_map, copy_assignment_and_move) {
+  my::map<int, std::string> m1 = {{54, "Adam"}, {93, "Eva"}};
+  my::map<int, std::string> m2 = {{1, "Mila"}};
+  m2 = m1;
+  ASSERT_EQ(2u, m2.size());
+  m1.erase(54);
+  ASSERT_TRUE(m2.contains(54));
+  ASSERT_FALSE(m1.contains(54));
+  auto root = m2.begin().current_node;
+  my::map<int, std::string> m3(std::move(m2));
+  ASSERT_EQ(root, m3.begin().current_node);
+  ASSERT_TRUE(m2.empty());
+  my::map<int, std::string> m4;
+  m4 = std::move(m3);
+  ASSERT_EQ(root, m4.begin().current_node);
+  ASSERT_TRUE(m3.empty());
+  ASSERT_EQ("Adam", m4.at(54));
+}
+
+TEST(my_map, merge_rebuild) {
+  my::map<int, std::string> m1 = {{1, "a"}, {3, "b"}, {5, "c"}};
+  my::map<int, std::string> m2 = {{2, "x"}, {3, "y"}, {6, "z"}};
+  m1.merge(m2);
+  ASSERT_EQ(5u, m1.size());
+  ASSERT_EQ("y", m1.at(3));
+  ASSERT_EQ("x", m1.at(2));
+  ASSERT_EQ(3u, m2.size());
+  int expected[] = {1, 2, 3, 5, 6};
+  my::map<int, std::string>::iterator it = m1.begin();
+  for (int key : expected) {
+    ASSERT_EQ(key, it.cget());
+    ++it;
+  }
+  m1.insert(4, "d");
+  ASSERT_EQ("d", m1.at(4));
+}
+
+TEST(my_map, merge_small_side) {
+  my::map<int, int> m1;
+  for (int i = 0; i < 100; i++) m1[i] = i;
+  my::map<int, int> m2 = {{50, -1}, {200, -2}};
+  my::map<int, int> twin(m2);
+  m1.merge(m2);
+  ASSERT_EQ(101u, m1.size());
+  ASSERT_EQ(-1, m1.at(50));
+  ASSERT_EQ(-2, m1.at(200));
+  const my::map<int, int>& m2_view = m2;  // only read, still shared
+  const my::map<int, int>& twin_view = twin;
+  ASSERT_EQ(&m2_view.at(200), &twin_view.at(200));
+}
+
+struct case_insensitive {
+  bool operator()(const std::string& a, const std::string& b) const {
+    return strcasecmp(a.c_str(), b.c_str()) < 0;
+  }
+};
+
+TEST(my_map, case_insensitive_lookups) {  // enable_bloom does not compile
+  my::map<std::string, int, case_insensitive> m = {{"key", 1}};
+  ASSERT_TRUE(m.contains("KEY"));
+  ASSERT_EQ(1, m.at("Key"));
+  m["KEY"] = 2;
+  ASSERT_EQ(1u, m.size());
+  ASSERT_EQ(2, m.at("key"));
+}
+
+TEST(my_map, bloom_filter) {
+  my::map<std::string, int> m = {{"Adam", 1}, {"Eva", 2}};
+  m.enable_bloom(0.001);
+  ASSERT_FALSE(m.contains("Nastya"));
+  m["Nastya"] = 3;
+  m.insert("Denis", 4);
+  m.insert_or_assign("Mila", 5);
+  ASSERT_TRUE(m.contains("Nastya"));
+  ASSERT_TRUE(m.contains("Denis"));
+  ASSERT_TRUE(m.contains("Mila"));
+  ASSERT_TRUE(m.erase("Eva"));
+  ASSERT_FALSE(m.contains("Eva"));
+  std::stringstream stream;
+  my::map<std::string, int> other = {{"Gaga", 7}};
+  other.serialize(stream);
+  m.deserialize(stream);
+  ASSERT_TRUE(m.contains("Gaga"));
+  ASSERT_FALSE(m.contains("Adam"));
+  ASSERT_EQ(2u, m.get_bloom_stats().rebuilds);
+}
+
+TEST(my_map, bloom_concurrent_readers) {  // const lookups only read
+  my::map<int, int> m;
+  for (int i = 0; i < 2000; i++) m.insert(i * 2, i);
+  m.enable_bloom();
+  for (int i = 0; i < 500; i++) m.erase(i * 2);  // rebuilt here, if at all
+  const my::map<int, int>& view = m;
+  size_t before = m.get_bloom_stats().lookups;
+  std::atomic<int> found{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; t++)
+    readers.emplace_back([&view, &found] {
+      for (int key = 0; key < 4000; key++) found += view.contains(key);
+    });
+  for (auto& reader : readers) reader.join();
+  ASSERT_EQ(4 * 1500, found.load());
+  ASSERT_EQ(before + 16000, m.get_bloom_stats().lookups);
+}
+
+namespace {
+
+struct counted_key {  // counts how many keys get built
+  static int built;
+  std::string name;
+  counted_key(const char* text = "") : name(text) { ++built; }
+  counted_key(const counted_key& other) : name(other.name) { ++built; }
+  counted_key& operator=(const counted_key&) = default;
+};
+int counted_key::built = 0;
+
+struct by_name {  // transparent: orders keys and plain string_views
+  using is_transparent = void;
+  static std::string_view view(const counted_key& key) { return key.name; }
+  static std::string_view view(std::string_view text) { return text; }
+  template <typename A, typename B>
+  bool operator()(const A& a, const B& b) const {
+    return view(a) < view(b);
+  }
+};
+
+}  // namespace
+
+template <>
+struct std::hash<counted_key> {  // for the optional Bloom filter
+  size_t operator()(const counted_key& key) const {
+    return std::hash<std::string>()(key.name);
+  }
+};
+
+TEST(my_map, transparent_lookup) {
+  my::map<counted_key, int, by_name> m;
+  m["Adam"] = 1;
+  m["Eva"] = 2;
+  int built = counted_key::built;
+  std::string_view eva = "Eva";
+  ASSERT_TRUE(m.contains(eva));
+  ASSERT_FALSE(m.contains(std::string_view("Nastya")));
+  ASSERT_EQ(1u, m.count(std::string_view("Adam")));
+  ASSERT_EQ(2, m.at(eva));
+  ASSERT_EQ(built, counted_key::built);  // no key was built for the probes
+
+  my::map<std::string, int, std::less<>> s = {{"one", 1}, {"two", 2}};
+  ASSERT_TRUE(s.contains("one"));
+  ASSERT_EQ(2, s.at(std::string_view("two")));
+  ASSERT_EQ(0u, s.count("three"));
+}
+
+TEST(my_map, custom_compare) {
+  my::map<int, int, std::greater<int>> m = {{1, 1}, {3, 3}, {2, 2}};
+  int expected = 3;
+  auto it = m.begin();
+  for (size_t i = 0; i < m.size(); i++, ++it)
+    ASSERT_EQ(expected--, it.cget());
+  my::map<int, int, std::greater<int>> other = {{5, 5}, {2, 20}};
+  m.merge(other);
+  ASSERT_EQ(4u, m.size());
+  ASSERT_EQ(5, m.begin().cget());
+  ASSERT_EQ(20, m.at(2));
+  std::stringstream stream;
+  m.serialize(stream);
+  my::map<int, int, std::greater<int>> copy;
+  copy.deserialize(stream);
+  ASSERT_EQ(20, copy.at(2));
+  ASSERT_TRUE(m.erase(3));
+  ASSERT_FALSE(m.contains(3));
+}
+
+template <typename Balance>
+void check_balance_policy() {
+  my::map<int, int, std::less<int>, Balance> m;
+  std::map<int, int> model;
+  unsigned state = 12345;
+  for (int step = 0; step < 20000; step++) {
+    state = state * 1103515245u + 12345u;
+    int key = int(state >> 16) % 700;
+    if (step % 3 == 2) {
+      ASSERT_EQ(model.erase(key) == 1, m.erase(key));
+    } else {
+      m[key] = step;
+      model[key] = step;
+    }
+    if (model.count(key)) {
+      ASSERT_EQ(model[key], m.at(key));
+    }
+  }
+  ASSERT_EQ(model.size(), m.size());
+  auto it = m.begin();
+  for (const auto& item : model) {
+    ASSERT_EQ(item.first, it.cget());
+    ++it;
+  }
+  my::map<int, int, std::less<int>, Balance> copy(m);
+  copy[-1] = 0;
+  ASSERT_FALSE(m.contains(-1));
+  ASSERT_EQ(model.size() + 1, copy.size());
+}
+
+TEST(my_map, balance_policies) {
+  check_balance_policy<my::rb_balance>();
+  check_balance_policy<my::avl_balance>();
+  check_balance_policy<my::splay_balance>();
+}
+
+template <typename Map>
+void churn(Map& m, std::map<int, int>& model, int steps, unsigned seed) {
+  for (int step = 0; step < steps; step++) {
+    seed = seed * 1103515245u + 12345u;
+    int key = int(seed >> 16) % 3000;
+    if (step % 3 == 2) {
+      m.erase(key);
+      model.erase(key);
+    } else {
+      m[key] = step;
+      model[key] = step;
+    }
+  }
+}
+
+template <typename Map>
+void expect_same(Map& m, const std::map<int, int>& model) {
+  ASSERT_EQ(model.size(), m.size());
+  auto it = m.begin();
+  for (const auto& item : model) {
+    ASSERT_EQ(item.first, it.cget());
+    ASSERT_EQ(item.second, m.at(item.first));
+    ++it;
+  }
+}
+
+TEST(my_map, compact) {
+  my::map<int, int> m;
+  std::map<int, int> model;
+  churn(m, model, 20000, 7);
+  ASSERT_GT(m.fragmentation(), 0.5);
+  my::map<int, int> copy(m);  // keeps the old nodes
+  m.compact();
+  ASSERT_LT(m.fragmentation(), 0.01);
+  expect_same(m, model);
+  expect_same(copy, model);
+  m.compact(my::compact_order::van_emde_boas);
+  expect_same(m, model);
+  churn(m, model, 5000, 8);  // compacted nodes are freed and reused fine
+  expect_same(m, model);
+
+  my::map<int, int, std::less<int>, my::splay_balance> splay;
+  std::map<int, int> splay_model;
+  churn(splay, splay_model, 5000, 9);
+  splay.compact(my::compact_order::van_emde_boas);
+  expect_same(splay, splay_model);
+  splay.compact();
+  ASSERT_LT(splay.fragmentation(), 0.01);
+}
+
+TEST(my_map, compact_step) {
+  my::map<int, int> m;
+  std::map<int, int> model;
+  churn(m, model, 20000, 11);
+  unsigned seed = 5;
+  int steps = 0;
+  while (!m.compact_step(50)) {  // changes between the steps
+    churn(m, model, 20, seed++);
+    ASSERT_LT(++steps, 10000);
+  }
+  expect_same(m, model);
+  while (!m.compact_step(1000)) {
+  }
+  ASSERT_LT(m.fragmentation(), 0.01);
+  auto it = m.begin();  // still valid while other nodes move
+  int first = it.cget();
+  my::map<int, int> copy(m);
+  ASSERT_FALSE(m.compact_step(0));
+  ASSERT_EQ(first, it.cget());
+  expect_same(copy, model);
+}
+
+struct tagged_key {  // equal under operator< whatever the tag
+  int id;
+  int tag;
+  bool operator<(const tagged_key& other) const { return id < other.id; }
+};
+
+template <>
+struct std::hash<tagged_key> {  // hashes the tag too
+  size_t operator()(const tagged_key& key) const {
+    return std::hash<int>()(key.id * 31 + key.tag);
+  }
+};
+
+TEST(my_map, hot_cache_erase_by_equal_key) {  // checked under ASan as well
+  my::map<tagged_key, int> m;
+  m.enable_hot_cache(8);
+  m[{1, 0}] = 1;
+  ASSERT_EQ(1, m.at({1, 7}));  // cached under the stored key {1, 0}
+  ASSERT_TRUE(m.erase({1, 7}));
+  ASSERT_FALSE(m.contains({1, 7}));
+  m[{1, 3}] = 2;
+  ASSERT_EQ(2, m.at({1, 7}));
+  ASSERT_EQ(2, m.at({1, 3}));
+}
+
+TEST(my_map, hot_cache) {
+  my::map<int, int> m;
+  ASSERT_FALSE(m.get_hot_cache_stats().enabled);
+  m.enable_hot_cache(16);  // small, so sets are fought over
+  std::map<int, int> model;
+  churn(m, model, 20000, 21);  // erased nodes leave the cache
+  expect_same(m, model);
+  for (int i = 0; i < 100; i++) m.at(model.begin()->first);
+  my::hot_cache_stats stats = m.get_hot_cache_stats();
+  ASSERT_TRUE(stats.enabled);
+  ASSERT_EQ(16u, stats.slots);
+  ASSERT_GE(stats.hits, 99u);
+  ASSERT_GT(stats.hit_rate(), 0.0);
+
+  my::map<int, int> copy(m);  // the next write copies the nodes
+  churn(m, model, 2000, 22);
+  ASSERT_GE(m.get_hot_cache_stats().flushes, 1u);
+  expect_same(m, model);
+  while (!m.compact_step(100)) expect_same(m, model);  // nodes move
+  m.compact(my::compact_order::van_emde_boas);
+  expect_same(m, model);
+  m.disable_hot_cache();
+  ASSERT_FALSE(m.get_hot_cache_stats().enabled);
+  expect_same(m, model);
+
+  my::map<int, int, std::less<int>, my::splay_balance> splay;
+  std::map<int, int> splay_model;
+  splay.enable_hot_cache(64);
+  churn(splay, splay_model, 20000, 23);
+  expect_same(splay, splay_model);
+}
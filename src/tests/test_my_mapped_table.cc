@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "../my_containers.h"
+#include "../my_containers_plus.h"
+
+static std::string table_path(const char *name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+TEST(my_mapped_table, fixed_width) {
+  my::map<int, double> m;
+  for (int i = 0; i < 1000; i++) m[i * 3] = i * 0.5;
+  std::string path = table_path("my_mapped_table_fixed.tbl");
+  my::write_table(m, path, 16);
+  my::mapped_table<int, double> t(path);
+  ASSERT_EQ(1000u, t.size());
+  ASSERT_FALSE(t.empty());
+  ASSERT_EQ(0.5 * 333, t.at(999));
+  ASSERT_TRUE(t.contains(0));
+  ASSERT_FALSE(t.contains(1));
+  ASSERT_TRUE(t.find(3000) == t.end());
+  ASSERT_EQ(6, t.lower_bound(4).key());
+  ASSERT_EQ(48, t.lower_bound(46).key());
+  ASSERT_EQ(48, t.lower_bound(48).key());
+  ASSERT_TRUE(t.lower_bound(2998) == t.end());
+  ASSERT_EQ(0, t.lower_bound(-5).key());
+  ASSERT_THROW(t.at(2), std::out_of_range);
+  int expected = 0;
+  for (auto it = t.begin(); it != t.end(); ++it, expected += 3)
+    ASSERT_EQ(expected, (*it).first);
+  ASSERT_EQ(3000, expected);
+  std::remove(path.c_str());
+}
+
+TEST(my_mapped_table, offset_indexed) {
+  my::map<std::string, std::string> m = {
+    {"Adam", "54"},
+    {"Eva", "93"},
+    {"Nastya", "23"},
+    {"Denis", "58"},
+    {"Fahruh", "12"},
+    {"Mila", ""}
+  };
+  std::string path = table_path("my_mapped_table_strings.tbl");
+  my::write_table(m, path, 2);
+  my::mapped_table<std::string, std::string> t(path);
+  ASSERT_EQ(6u, t.size());
+  ASSERT_EQ("93", t.at("Eva"));
+  ASSERT_EQ("", t.at("Mila"));
+  ASSERT_FALSE(t.contains("Eve"));
+  auto it = t.lower_bound("E");
+  ASSERT_EQ("Eva", it.key());
+  ++it;
+  ASSERT_EQ("Fahruh", it.key());
+  ASSERT_EQ("12", it.value());
+  my::mapped_table<std::string, std::string> moved(std::move(t));
+  ASSERT_EQ("Adam", moved.begin().key());
+  std::remove(path.c_str());
+}
+
+TEST(my_mapped_table, empty) {
+  my::map<int, int> m;
+  std::string path = table_path("my_mapped_table_empty.tbl");
+  my::write_table(m, path);
+  my::mapped_table<int, int> t(path);
+  ASSERT_TRUE(t.empty());
+  ASSERT_TRUE(t.begin() == t.end());
+  ASSERT_FALSE(t.contains(1));
+  std::remove(path.c_str());
+}
+
+TEST(my_mapped_table, bad_files) {
+  ASSERT_THROW((my::mapped_table<int, int>(table_path("my_missing.tbl"))),
+               std::runtime_error);
+  std::string path = table_path("my_mapped_table_bad.tbl");
+  my::map<int, int> m = {{1, 2}};
+  my::write_table(m, path);
+  ASSERT_THROW((my::mapped_table<long, int>(path)), std::invalid_argument);
+  std::ofstream(path) << "garbage garbage garbage garbage garbage garbage "
+                         "garbage garbage garbage garbage garbage garbage";
+  ASSERT_THROW((my::mapped_table<int, int>(path)), std::invalid_argument);
+  std::remove(path.c_str());
+}
+
+TEST(my_mapped_table, corrupt_extents) {  // rejected before any lookup
+  std::string path = table_path("my_mapped_table_corrupt.tbl");
+  my::map<std::string, std::string> m = {{"a", "1"}, {"b", "22"}};
+  my::write_table(m, path, 1);
+  std::string good;
+  {
+    std::ifstream in(path, std::ios::binary);
+    good.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  auto rewrite = [&](auto corrupt) {
+    my::table::file_header hdr;
+    std::memcpy(&hdr, good.data(), sizeof(hdr));
+    corrupt(hdr);
+    std::string bytes = good;
+    std::memcpy(&bytes[0], &hdr, sizeof(hdr));
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << bytes;
+  };
+  using table = my::mapped_table<std::string, std::string>;
+  rewrite([](my::table::file_header &hdr) { hdr.count = uint64_t(1) << 60; });
+  ASSERT_THROW(table{path}, std::invalid_argument);
+  rewrite([](my::table::file_header &hdr) { hdr.values.offset += 1 << 20; });
+  ASSERT_THROW(table{path}, std::invalid_argument);
+  rewrite([](my::table::file_header &hdr) { hdr.keys.heap_offset = 8; });
+  ASSERT_THROW(table{path}, std::invalid_argument);
+  rewrite([](my::table::file_header &hdr) { hdr.block_size = 2; });
+  ASSERT_THROW(table{path}, std::invalid_argument);
+  rewrite([](my::table::file_header &) {});
+  ASSERT_EQ("22", table(path).at("b"));
+  std::remove(path.c_str());
+}
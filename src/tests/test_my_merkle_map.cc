@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+using change_list = std::vector<std::pair<int, my::merkle_change>>;
+
+template <typename Other>
+change_list diff_of(const my::merkle_map<int, int>& m, const Other& other) {
+  change_list out;
+  m.diff(other, [&out](int key, my::merkle_change change) {
+    out.push_back({key, change});
+  });
+  return out;
+}
+
+TEST(my_merkle_map, insert_erase) {
+  my::merkle_map<int, std::string> m = {{1, "one"}, {2, "two"}};
+  ASSERT_TRUE(m.insert(3, "three"));
+  ASSERT_FALSE(m.insert(3, "drei"));
+  m.insert_or_assign(3, "drei");
+  ASSERT_EQ("drei", m.at(3));
+  ASSERT_THROW(m.at(4), std::out_of_range);
+  ASSERT_TRUE(m.erase(1));
+  ASSERT_FALSE(m.erase(1));
+  ASSERT_EQ(2u, m.size());
+  std::vector<int> keys;
+  m.for_each([&keys](int key, const std::string&) { keys.push_back(key); });
+  ASSERT_EQ((std::vector<int>{2, 3}), keys);
+}
+
+TEST(my_merkle_map, hash_does_not_depend_on_shape) {
+  my::merkle_map<int, int> up, down;
+  for (int i = 0; i < 1000; i++) up.insert(i, i * 3);
+  for (int i = 999; i >= 0; i--) down.insert(i, i * 3);
+  down.insert(5000, 1);
+  down.erase(5000);
+  ASSERT_EQ(up.root_hash(), down.root_hash());
+  ASSERT_TRUE(diff_of(up, down).empty());
+  down.insert_or_assign(500, 0);
+  ASSERT_NE(up.root_hash(), down.root_hash());
+  ASSERT_EQ((change_list{{500, my::merkle_change::changed}}),
+            diff_of(up, down));
+}
+
+TEST(my_merkle_map, diff_between_replicas) {
+  my::merkle_map<int, int> here, there;
+  std::map<int, int> model_here, model_there;
+  unsigned state = 99;
+  auto next = [&state](int range) {
+    state = state * 1103515245u + 12345u;
+    return int(state >> 16) % range;
+  };
+  for (int i = 0; i < 20000; i++) {
+    int key = next(100000), value = next(10);
+    here.insert_or_assign(key, value);
+    there.insert_or_assign(key, value);
+    model_here[key] = value;
+    model_there[key] = value;
+  }
+  for (int i = 0; i < 300; i++) {  // drift apart on both sides
+    int key = next(100000);
+    if (i % 3 == 0) {
+      here.erase(key);
+      model_here.erase(key);
+    } else {
+      auto& side = i % 3 == 1 ? here : there;
+      auto& model = i % 3 == 1 ? model_here : model_there;
+      side.insert_or_assign(key, 10 + i);
+      model[key] = 10 + i;
+    }
+  }
+  change_list expected;
+  auto a = model_here.begin(), b = model_there.begin();
+  while (a != model_here.end() || b != model_there.end()) {
+    if (b == model_there.end() ||
+        (a != model_here.end() && a->first < b->first)) {
+      expected.push_back({(a++)->first, my::merkle_change::only_here});
+    } else if (a == model_here.end() || b->first < a->first) {
+      expected.push_back({(b++)->first, my::merkle_change::only_there});
+    } else {
+      if (a->second != b->second)
+        expected.push_back({a->first, my::merkle_change::changed});
+      a++;
+      b++;
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+  ASSERT_EQ(expected, diff_of(here, there));
+
+  std::stringstream stream;  // the same through a shipped digest
+  there.digest().write(stream);
+  my::merkle_digest<int> digest;
+  digest.read(stream);
+  ASSERT_EQ(there.size(), digest.size());
+  ASSERT_EQ(expected, diff_of(here, digest));
+}
+
+TEST(my_merkle_map, digest_edges) {
+  my::merkle_map<int, int> empty, m = {{1, 1}, {2, 2}};
+  ASSERT_EQ((change_list{{1, my::merkle_change::only_here},
+                         {2, my::merkle_change::only_here}}),
+            diff_of(m, empty.digest()));
+  ASSERT_EQ((change_list{{1, my::merkle_change::only_there},
+                         {2, my::merkle_change::only_there}}),
+            diff_of(empty, m.digest()));
+  ASSERT_TRUE(diff_of(m, m.digest()).empty());
+  std::stringstream stream;
+  m.digest().write(stream);
+  my::merkle_digest<long> wrong;
+  ASSERT_THROW(wrong.read(stream), std::invalid_argument);
+}
+
+TEST(my_merkle_map, digest_forged_count) {  // fails fast, no huge allocation
+  my::merkle_map<int, int> m = {{1, 1}, {2, 2}};
+  std::stringstream stream;
+  m.digest().write(stream);
+  uint64_t huge = uint64_t(1) << 40;
+  std::string bytes = stream.str();
+  std::memcpy(&bytes[16], &huge, sizeof(huge));  // entry count
+  std::stringstream forged(bytes);
+  my::merkle_digest<int> digest;
+  ASSERT_THROW(digest.read(forged), std::invalid_argument);
+  ASSERT_EQ(0u, digest.size());
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
 #include "../my_containers_plus.h"
 
 TEST(my_multiset, empty_constructor) {
@@ -168,3 +172,130 @@ TEST(my_multiset, insert_many) {
   ASSERT_EQ(out[3].second, true);
   ASSERT_EQ(out[4].second, true);
 }
+
+TEST(my_multiset, serialize) {
+  my::multiset<int> ms1 = {
+    54, 93, 23, 23, 23, 02, 29, 67, 83, 83, 83, 83, 83, 13
+  };
+  std::stringstream stream;
+  ms1.serialize(stream);
+  my::multiset<int> ms2;
+  ms2.deserialize(stream);
+  ASSERT_EQ(14u, ms2.size());
+  ASSERT_EQ(5u, ms2.count(83));
+  ASSERT_EQ(02, ms2.begin().cget());
+}
+
+TEST(my_multiset, merge_rebuild) {
+  my::multiset<int> ms1 = {5, 1, 3, 3};
+  my::multiset<int> ms2 = {3, 2, 5, 7};
+  ms1.merge(ms2);
+  ASSERT_EQ(8u, ms1.size());
+  ASSERT_EQ(3u, ms1.count(3));
+  ASSERT_EQ(2u, ms1.count(5));
+  ASSERT_EQ(4u, ms2.size());
+  int expected[] = {1, 2, 3, 3, 3, 5, 5, 7};
+  my::multiset<int>::iterator it = ms1.begin();
+  for (int key : expected) {
+    ASSERT_EQ(key, it.cget());
+    ++it;
+  }
+  ms1.erase(ms1.find(3));
+  ASSERT_EQ(2u, ms1.count(3));
+}
+
+TEST(my_multiset, merge_small_side) {
+  my::multiset<int> ms1;
+  for (int i = 0; i < 100; i++) ms1.add(i % 50);
+  my::multiset<int> ms2 = {7, 500};
+  my::multiset<int> twin(ms2);
+  ms1.merge(ms2);
+  ASSERT_EQ(102u, ms1.size());
+  ASSERT_EQ(3u, ms1.count(7));
+  ASSERT_EQ(500, ms1.select(101));
+  ASSERT_EQ(&ms2.select(1), &twin.select(1));  // only read, still shared
+}
+
+TEST(my_multiset, count_keeps_nodes_shared) {
+  my::multiset<int> ms = {4, 1, 4, 9, 4, 2};
+  my::multiset<int> twin(ms);
+  const my::multiset<int>& view = ms;
+  ASSERT_EQ(3u, view.count(4));
+  ASSERT_EQ(0u, view.count(3));
+  ASSERT_EQ(1u, ms.count(9));
+  ASSERT_EQ(&ms.select(0), &twin.select(0));  // counting did not detach
+}
+
+TEST(my_multiset, transparent_lookup) {
+  my::multiset<std::string, std::less<>> ms = {"b", "a", "b", "c", "b"};
+  std::string_view b = "b";
+  ASSERT_TRUE(ms.contains(b));
+  ASSERT_EQ(3u, ms.count(b));
+  ASSERT_EQ("b", ms.find(b).cget());
+  auto range = ms.equal_range(b);
+  ASSERT_EQ("c", range.second.cget());
+  ASSERT_EQ("c", ms.lower_bound(b).cget());
+  ASSERT_EQ("b", ms.upper_bound(b).cget());
+}
+
+TEST(my_multiset, custom_compare) {
+  my::multiset<int, std::greater<int>> ms = {1, 3, 3, 2};
+  ASSERT_EQ(3, ms.begin().cget());
+  ASSERT_EQ(2u, ms.count(3));
+  ms.erase(3);
+  ASSERT_EQ(1u, ms.count(3));
+  my::multiset<int, std::greater<int>> other = {5, 0};
+  ms.merge(other);
+  int expected[] = {5, 3, 2, 1, 0};
+  auto it = ms.begin();
+  for (int key : expected) {
+    ASSERT_EQ(key, it.cget());
+    ++it;
+  }
+}
+
+TEST(my_multiset, avl_and_splay) {
+  my::multiset<int, std::less<int>, my::avl_balance> avl = {3, 1, 3, 2, 3};
+  my::multiset<int, std::less<int>, my::splay_balance> splay = {3, 1, 3, 2};
+  ASSERT_EQ(3u, avl.count(3));
+  ASSERT_EQ(2u, splay.count(3));
+  avl.erase(3);
+  splay.erase(3);
+  ASSERT_EQ(2u, avl.count(3));
+  ASSERT_EQ(1u, splay.count(3));
+  ASSERT_EQ(1, avl.begin().cget());
+  ASSERT_EQ(1, splay.begin().cget());
+}
+
+TEST(my_multiset, select_and_rank) {
+  my::multiset<int> ms;
+  std::vector<int> model;
+  unsigned state = 4242;
+  for (int step = 0; step < 3000; step++) {
+    state = state * 1103515245u + 12345u;
+    int key = int(state >> 16) % 200;
+    if (step % 3 == 2) {
+      auto pos = std::find(model.begin(), model.end(), key);
+      ASSERT_EQ(pos != model.end(), ms.erase(key));
+      if (pos != model.end()) model.erase(pos);
+    } else {
+      ms.insert(key);
+      model.push_back(key);
+    }
+  }
+  std::sort(model.begin(), model.end());
+  for (size_t k = 0; k < model.size(); k++) ASSERT_EQ(model[k], ms.select(k));
+  ASSERT_THROW(ms.select(model.size()), std::out_of_range);
+  for (int key = -1; key <= 200; key++) {
+    size_t below = std::lower_bound(model.begin(), model.end(), key) -
+                   model.begin();
+    size_t equal = std::upper_bound(model.begin(), model.end(), key) -
+                   model.begin() - below;
+    ASSERT_EQ(below, ms.rank(key));
+    ASSERT_EQ(equal, ms.count(key));
+    if (equal) {
+      ASSERT_EQ(below, ms.find(key).position);
+      ASSERT_EQ(key, ms.find(key).cget());
+    }
+  }
+}
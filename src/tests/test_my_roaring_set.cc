@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+namespace {
+
+std::vector<uint32_t> values_of(const my::roaring_set &s) {
+  std::vector<uint32_t> out;
+  for (auto it = s.begin(); it != s.end(); ++it) out.push_back(*it);
+  return out;
+}
+
+std::vector<uint32_t> values_of(const std::set<uint32_t> &s) {
+  return std::vector<uint32_t>(s.begin(), s.end());
+}
+
+// sparse values, a dense range past the array limit and a few long runs
+void fill(my::roaring_set &s, std::set<uint32_t> &ref, unsigned seed) {
+  unsigned state = seed;
+  for (int i = 0; i < 3000; i++) {
+    state = state * 1103515245u + 12345u;
+    uint32_t v = state % 400000;
+    s.insert(v);
+    ref.insert(v);
+  }
+  for (uint32_t v = 0x30000 + seed; v < 0x32000; v += 1 + seed % 2) {
+    s.insert(v);
+    ref.insert(v);
+  }
+  for (uint32_t start = 0x50000; start < 0x60000; start += 3000 + seed)
+    for (uint32_t v = start; v < start + 1000; v++) {
+      s.insert(v);
+      ref.insert(v);
+    }
+}
+
+}  // namespace
+
+TEST(my_roaring_set, matches_std_set) {
+  my::roaring_set s;
+  std::set<uint32_t> ref;
+  unsigned state = 7;
+  for (int i = 0; i < 60000; i++) {
+    state = state * 1103515245u + 12345u;
+    uint32_t v = (state >> 8) % 20000;
+    if (i % 3 == 0) v |= 0x70000;  // one chunk goes bitmap and back
+    if (i % 5 == 4) {
+      ASSERT_EQ(ref.erase(v) == 1, s.erase(v));
+    } else {
+      auto got = s.insert(v);
+      ASSERT_EQ(ref.insert(v).second, got.second);
+      ASSERT_EQ(v, *got.first);
+    }
+    if (i % 1000 == 0) {
+      ASSERT_EQ(values_of(ref), values_of(s));
+    }
+  }
+  ASSERT_EQ(ref.size(), s.size());
+  ASSERT_EQ(values_of(ref), values_of(s));
+  s.run_optimize();
+  ASSERT_EQ(values_of(ref), values_of(s));
+  for (uint32_t v = 0; v < 20000; v += 7) {
+    ASSERT_EQ(ref.count(v), s.count(v));
+    auto it = s.lower_bound(v);
+    auto expected = ref.lower_bound(v);
+    if (expected == ref.end())
+      ASSERT_TRUE(it == s.end());
+    else
+      ASSERT_EQ(*expected, *it);
+  }
+  for (auto it = s.begin(); it != s.end();) it = s.erase(it);
+  ASSERT_TRUE(s.empty());
+  ASSERT_TRUE(s.begin() == s.end());
+}
+
+TEST(my_roaring_set, runs_edit_in_place) {
+  my::roaring_set s;
+  for (uint32_t v = 100; v < 70000; v++) s.insert(v);
+  s.insert(0xFFFFFFFF);
+  ASSERT_TRUE(s.run_optimize());
+  size_t packed = s.memory_usage();
+  ASSERT_LT(packed, 1024u);
+  std::set<uint32_t> ref(s.begin(), s.end());
+  for (uint32_t v : {99u, 98u, 70000u, 500u, 501u, 499u, 65535u, 65536u}) {
+    ASSERT_EQ(ref.insert(v).second, s.insert(v).second);
+    ASSERT_EQ(values_of(ref), values_of(s));
+  }
+  for (uint32_t v : {100u, 500u, 1000u, 1002u, 1001u, 0xFFFFFFFFu, 5u}) {
+    ASSERT_EQ(ref.erase(v) == 1, s.erase(v));
+    ASSERT_EQ(values_of(ref), values_of(s));
+  }
+  for (uint32_t v = 2000; v < 20000; v += 2) {  // runs lose to a bitmap
+    s.erase(v);
+    ref.erase(v);
+  }
+  ASSERT_EQ(values_of(ref), values_of(s));
+  ASSERT_EQ(ref.size(), s.size());
+  ASSERT_TRUE(s.contains(65535));
+  ASSERT_FALSE(s.contains(2000));
+  ASSERT_TRUE(s.find(2001) != s.end());
+  ASSERT_TRUE(s.find(2000) == s.end());
+}
+
+TEST(my_roaring_set, set_algebra) {
+  for (bool optimize : {false, true}) {
+    my::roaring_set a, b;
+    std::set<uint32_t> ra, rb;
+    fill(a, ra, 1);
+    fill(b, rb, 2);
+    if (optimize) {
+      a.run_optimize();
+      b.run_optimize();
+    }
+    std::vector<uint32_t> both, either, only_a;
+    std::set_intersection(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                          std::back_inserter(both));
+    std::set_union(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                   std::back_inserter(either));
+    std::set_difference(ra.begin(), ra.end(), rb.begin(), rb.end(),
+                        std::back_inserter(only_a));
+    ASSERT_EQ(both, values_of(a & b));
+    ASSERT_EQ(either, values_of(a | b));
+    ASSERT_EQ(only_a, values_of(a - b));
+    ASSERT_EQ(both.size(), (a & b).size());
+    ASSERT_EQ(either.size(), (a | b).size());
+    ASSERT_EQ(a, (a - b) | (a & b));
+    ASSERT_TRUE((a - a).empty());
+    my::roaring_set c = a;
+    c.merge(b);
+    ASSERT_EQ(a | b, c);
+    ASSERT_NE(a, c);
+    c = b;
+    ASSERT_EQ(b, c);
+  }
+}
+
+TEST(my_roaring_set, dense_memory) {
+  my::roaring_set s{5, 3, 1};
+  ASSERT_EQ((std::vector<uint32_t>{1, 3, 5}), values_of(s));
+  s.clear();
+  for (uint32_t v = 0; v < 1000000; v++) s.insert(v * 2);
+  ASSERT_EQ(1000000u, s.size());
+  ASSERT_LT(s.memory_usage(), 300000u);  // 31 bitmaps, 8 KiB each
+  my::roaring_set moved(std::move(s));
+  ASSERT_EQ(1000000u, moved.size());
+  ASSERT_EQ(1999998u, *moved.lower_bound(1999997));
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <strings.h>
+
+#include <string>
+
 #include "../my_containers.h"
 
 TEST(my_set, empty_constructor) {
@@ -139,3 +143,169 @@ TEST(my_set, insert_many) {
   ASSERT_EQ(out[3], std::make_pair(it.set(43), true));
   ASSERT_EQ(out[4], std::make_pair(it.set(47), false));
 }
+
+TEST(my_set, serialize) {
+  my::set<std::string> s1 = {"Adam", "Eva", "Nastya", "Denis", "Mila"};
+  std::stringstream stream;
+  s1.serialize(stream);
+  my::set<std::string> s2;
+  s2.deserialize(stream);
+  ASSERT_EQ(5u, s2.size());
+  ASSERT_TRUE(s2.contains("Nastya"));
+  ASSERT_EQ("Adam", s2.begin().cget());
+  ASSERT_TRUE(s2.insert("Basil").second);
+  ASSERT_FALSE(s2.insert("Eva").second);
+}
+
+TEST(my_set, copy_on_write) {
+  my::set<int> s1 = {54, 93, 23, 58, 12, 02, 29};
+  my::set<int> s2(s1);
+  my::set<int> s3(s1);
+  s2.erase(23);
+  s3.insert(24);
+  ASSERT_TRUE(s1.contains(23));
+  ASSERT_FALSE(s2.contains(23));
+  ASSERT_FALSE(s1.contains(24));
+  ASSERT_TRUE(s3.contains(24));
+  s1.clear();
+  ASSERT_EQ(6u, s2.size());
+  ASSERT_EQ(8u, s3.size());
+}
+
+struct case_insensitive {
+  bool operator()(const std::string& a, const std::string& b) const {
+    return strcasecmp(a.c_str(), b.c_str()) < 0;
+  }
+};
+
+TEST(my_set, case_insensitive_lookups) {  // enable_bloom does not compile
+  my::set<std::string, case_insensitive> s = {"Hello", "World"};
+  ASSERT_TRUE(s.contains("hello"));
+  ASSERT_TRUE(s.contains("WORLD"));
+  ASSERT_EQ(1u, s.count("HELLO"));
+  ASSERT_FALSE(s.insert("hELLO").second);
+  ASSERT_EQ(2u, s.size());
+  ASSERT_TRUE(s.erase("world"));
+  ASSERT_FALSE(s.contains("World"));
+}
+
+TEST(my_set, bloom_filter) {
+  my::set<int> s;
+  for (int i = 0; i < 1000; i++) s.insert(i * 2);
+  s.enable_bloom(0.01);
+  size_t hits = 0;
+  for (int i = 0; i < 4000; i++) hits += s.contains(i);
+  ASSERT_EQ(1000u, hits);
+  my::bloom_stats stats = s.get_bloom_stats();
+  ASSERT_TRUE(stats.enabled);
+  ASSERT_EQ(1u, stats.rebuilds);
+  ASSERT_EQ(4000u, stats.lookups);
+  ASSERT_GT(stats.filtered, 2800u);
+  ASSERT_EQ(3000u, stats.filtered + stats.false_positives);
+  ASSERT_GT(stats.bytes, 0u);
+  ASSERT_LT(stats.expected_fp, 0.02);
+
+  s.insert(1);  // goes straight into the filter
+  ASSERT_TRUE(s.contains(1));
+  for (int i = 0; i < 1000; i += 2) s.erase(i * 2);
+  for (int i = 0; i < 2000; i++) ASSERT_EQ(i % 4 == 2 || i == 1, s.contains(i));
+  ASSERT_GE(s.get_bloom_stats().rebuilds, 2u);
+
+  my::set<int> copy(s);
+  ASSERT_TRUE(copy.get_bloom_stats().enabled);
+  ASSERT_TRUE(copy.contains(6));
+  copy.clear();
+  ASSERT_FALSE(copy.contains(6));
+  ASSERT_TRUE(s.contains(6));
+  s.disable_bloom();
+  ASSERT_FALSE(s.get_bloom_stats().enabled);
+  ASSERT_TRUE(s.contains(6));
+  ASSERT_THROW(s.enable_bloom(0), std::invalid_argument);
+}
+
+TEST(my_set, insert_into_empty) {
+  my::set<int> s;
+  auto res = s.insert(5);
+  ASSERT_TRUE(res.second);
+  ASSERT_EQ(5, res.first.cget());
+  ASSERT_EQ(1u, s.size());
+}
+
+TEST(my_set, transparent_lookup) {
+  my::set<std::string, std::less<>> s = {"apple", "fig", "pear"};
+  std::string_view fig = "fig";
+  ASSERT_TRUE(s.contains(fig));
+  ASSERT_FALSE(s.contains("kiwi"));
+  ASSERT_EQ(1u, s.count("pear"));
+  ASSERT_EQ("fig", s.find(fig).cget());
+  ASSERT_TRUE(s.find("kiwi") == s.end());
+  s.enable_bloom();
+  ASSERT_TRUE(s.contains(fig));
+  ASSERT_TRUE(s.contains(std::string("apple")));
+}
+
+TEST(my_set, custom_compare) {
+  my::set<int, std::greater<int>> s = {4, 1, 3};
+  s.insert(2);
+  ASSERT_FALSE(s.insert(3).second);
+  int expected = 4;
+  auto it = s.begin();
+  for (size_t i = 0; i < s.size(); i++, ++it)
+    ASSERT_EQ(expected--, it.cget());
+  ASSERT_EQ(2, s.find(2).cget());
+  ASSERT_TRUE(s.erase(4));
+  ASSERT_EQ(3, s.begin().cget());
+}
+
+TEST(my_set, avl_and_splay) {
+  my::set<int, std::less<int>, my::avl_balance> avl;
+  my::set<int, std::less<int>, my::splay_balance> splay;
+  for (int i = 0; i < 1000; i++) {
+    avl.insert(i * 7 % 1000);
+    splay.insert(i * 7 % 1000);
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    ASSERT_TRUE(avl.erase(i));
+    ASSERT_TRUE(splay.erase(i));
+  }
+  ASSERT_EQ(500u, avl.size());
+  ASSERT_EQ(500u, splay.size());
+  auto a = avl.begin();
+  auto s = splay.begin();
+  for (int i = 1; i < 1000; i += 2, ++a, ++s) {
+    ASSERT_EQ(i, a.cget());
+    ASSERT_EQ(i, s.cget());
+  }
+}
+
+TEST(my_set, merge_and_algebra) {
+  my::set<int> a, b;
+  for (int i = 0; i < 3000; i++) {
+    a.insert(i * 3);
+    b.insert(i * 5);
+  }
+  my::set<int> both = set_intersection(a, b);
+  my::set<int> either = set_union(a, b);
+  my::set<int> only_a = set_difference(a, b);
+  ASSERT_EQ(600u, both.size());
+  ASSERT_EQ(5400u, either.size());
+  ASSERT_EQ(2400u, only_a.size());
+  auto it = both.begin();
+  for (int i = 0; i < 600; i++, ++it) ASSERT_EQ(i * 15, it.cget());
+  ASSERT_TRUE(only_a.contains(3));
+  ASSERT_FALSE(only_a.contains(15));
+
+  a.merge(b);  // similar sizes, rebuilt from the union
+  ASSERT_EQ(5400u, a.size());
+  ASSERT_EQ(3000u, b.size());
+  my::set<int> few{-1, 5, 7};
+  a.merge(few);  // few new keys, inserted
+  ASSERT_EQ(5402u, a.size());
+  auto at = a.begin();
+  ASSERT_EQ(-1, at.cget());
+  for (size_t i = 1; i < a.size(); i++) {
+    int last = at.cget();
+    ++at;
+    ASSERT_LT(last, at.cget());
+  }
+}
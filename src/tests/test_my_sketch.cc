@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "../my_containers_plus.h"
+
+TEST(my_hyperloglog, estimates_distinct_count) {
+  my::hyperloglog<int> small(0.02);
+  ASSERT_EQ(0.0, small.estimate());
+  for (int i = 0; i < 20; i++) small.insert(i % 10);
+  ASSERT_NEAR(10.0, small.estimate(), 0.5);  // linear counting is exact-ish
+
+  my::hyperloglog<int> hll(0.01);
+  ASSERT_EQ(14, hll.precision());
+  ASSERT_EQ(16384u, hll.bytes());
+  for (int round = 0; round < 2; round++)  // repeats change nothing
+    for (int i = 0; i < 200000; i++) hll.insert(i);
+  ASSERT_FALSE(hll.insert(7));
+  ASSERT_NEAR(200000.0, hll.estimate(), 200000 * 4 * hll.error());
+  hll.clear();
+  ASSERT_EQ(0.0, hll.estimate());
+  ASSERT_THROW(my::hyperloglog<int>(0), std::invalid_argument);
+}
+
+TEST(my_hyperloglog, merge_is_union) {
+  my::hyperloglog<std::string> a(0.02), b(0.02), both(0.02);
+  for (int i = 0; i < 60000; i++) {
+    std::string key = "user" + std::to_string(i);
+    (i < 40000 ? a : b).insert(key);  // overlap of 10000 below
+    if (i >= 30000 && i < 40000) b.insert(key);
+    both.insert(key);
+  }
+  my::hyperloglog<std::string> copy(a);
+  copy.merge(b);
+  ASSERT_EQ(both.estimate(), copy.estimate());  // same registers
+  ASSERT_NEAR(60000.0, copy.estimate(), 60000 * 4 * copy.error());
+  my::hyperloglog<std::string> coarse(0.1);
+  ASSERT_THROW(coarse.merge(a), std::invalid_argument);
+}
+
+TEST(my_count_min_sketch, bounds_hold) {
+  my::count_min_sketch<int> cms(0.001, 0.01);
+  ASSERT_EQ(4096u, cms.width());
+  ASSERT_EQ(5u, cms.depth());
+  std::unordered_map<int, uint32_t> exact;
+  unsigned state = 3;
+  for (int i = 0; i < 200000; i++) {
+    state = state * 1103515245u + 12345u;
+    int key = int((state >> 16) % 1000);
+    key = key * key % 50000;  // a skewed spread over 50000 keys
+    cms.insert(key);
+    ++exact[key];
+  }
+  cms.insert(-1, 5000);
+  exact[-1] += 5000;
+  ASSERT_EQ(205000u, cms.total());
+  int over = 0;
+  for (const auto &item : exact) {
+    uint32_t estimate = cms.estimate(item.first);
+    ASSERT_GE(estimate, item.second);  // never below
+    if (estimate - item.second > cms.error_bound()) ++over;
+  }
+  ASSERT_LE(over, int(exact.size() / 100));
+  ASSERT_EQ(cms.estimate(-1), cms.count(-1));
+  ASSERT_THROW((my::count_min_sketch<int>(0.001, 0)), std::invalid_argument);
+}
+
+TEST(my_count_min_sketch, merge_adds) {
+  my::count_min_sketch<int> a(0.01, 0.05), b(0.01, 0.05), both(0.01, 0.05);
+  for (int i = 0; i < 5000; i++) {
+    (i % 3 ? a : b).insert(i % 700, 2);
+    both.insert(i % 700, 2);
+  }
+  a.merge(b);
+  ASSERT_EQ(both.total(), a.total());
+  for (int key = 0; key < 700; key++)
+    ASSERT_EQ(both.estimate(key), a.estimate(key));
+  my::count_min_sketch<int> copy = a;
+  copy.clear();
+  ASSERT_EQ(0u, copy.estimate(1));
+  ASSERT_NE(0u, a.estimate(1));
+  my::count_min_sketch<int> wide(0.001, 0.05);
+  ASSERT_THROW(a.merge(wide), std::invalid_argument);
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+namespace {
+
+template <typename T>
+my::vector<T> sorted_sample(size_t count, uint64_t range, unsigned seed) {
+  std::set<T> picked;
+  uint64_t state = seed * 0x9E3779B97F4A7C15ull + 1;
+  while (picked.size() < count) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    picked.insert(T(state % range) - T(range / 3));  // negatives if signed
+  }
+  my::vector<T> out;
+  for (const T &value : picked) out.push_back(value);
+  return out;
+}
+
+template <typename T>
+std::vector<T> plain(const my::vector<T> &v) {
+  return std::vector<T>(v.begin(), v.end());
+}
+
+// every kernel against the std algorithms, over size ratios that take
+// the block compare, galloping from either side and the scalar tails
+template <typename T>
+void check_kernels() {
+  const size_t sizes[][2] = {{0, 0},    {0, 50},   {7, 9},     {64, 64},
+                             {1000, 1000}, {997, 1203}, {5, 3000},
+                             {3000, 5},  {40, 4000}, {4000, 100}};
+  for (auto size : sizes)
+    for (uint64_t range : {uint64_t(9000), uint64_t(100000)}) {
+      my::vector<T> a = sorted_sample<T>(size[0], range, 1);
+      my::vector<T> b = sorted_sample<T>(size[1], range, 2);
+      std::vector<T> both, either, only_a, only_b;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                            std::back_inserter(both));
+      std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                     std::back_inserter(either));
+      std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(only_a));
+      std::set_difference(b.begin(), b.end(), a.begin(), a.end(),
+                          std::back_inserter(only_b));
+      ASSERT_EQ(both, plain(my::sorted_intersection(a, b)));
+      ASSERT_EQ(both, plain(my::sorted_intersection(b, a)));
+      ASSERT_EQ(either, plain(my::sorted_union(a, b)));
+      ASSERT_EQ(either, plain(my::sorted_union(b, a)));
+      ASSERT_EQ(only_a, plain(my::sorted_difference(a, b)));
+      ASSERT_EQ(only_b, plain(my::sorted_difference(b, a)));
+    }
+}
+
+}  // namespace
+
+TEST(my_sorted_ops, integer_kernels) {
+  check_kernels<int32_t>();
+  check_kernels<uint32_t>();
+  check_kernels<int64_t>();
+  check_kernels<uint64_t>();
+  check_kernels<int16_t>();  // no block compare, scalar only
+}
+
+TEST(my_sorted_ops, matches_at_block_edges) {
+  my::vector<int32_t> a, b;  // every ninth value of b is off by one
+  for (int32_t i = 0; i < 64; i++) {
+    a.push_back(i * 2);
+    b.push_back(i * 2 + (i % 9 == 0 ? 1 : 0));
+  }
+  b.push_back(1000);
+  std::vector<int32_t> both, only_a;
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(both));
+  std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                      std::back_inserter(only_a));
+  ASSERT_EQ(56u, both.size());
+  ASSERT_EQ(both, plain(my::sorted_intersection(a, b)));
+  ASSERT_EQ(only_a, plain(my::sorted_difference(a, b)));
+}
+
+TEST(my_sorted_ops, custom_order) {
+  my::vector<std::string> a{"pear", "kiwi", "fig"};  // descending
+  my::vector<std::string> b{"plum", "kiwi", "apple"};
+  auto order = std::greater<std::string>();
+  ASSERT_EQ((std::vector<std::string>{"kiwi"}),
+            plain(my::sorted_intersection(a, b, order)));
+  ASSERT_EQ(
+      (std::vector<std::string>{"plum", "pear", "kiwi", "fig", "apple"}),
+      plain(my::sorted_union(a, b, order)));
+  ASSERT_EQ((std::vector<std::string>{"pear", "fig"}),
+            plain(my::sorted_difference(a, b, order)));
+}
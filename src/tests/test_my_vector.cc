@@ -518,3 +518,32 @@ TEST(my_vector, insert_many_back_empty) {
   EXPECT_EQ('o', vec[2]);
   EXPECT_EQ('l', vec[3]);
 }
+
+TEST(my_vector, move_constructor_leaves_source_empty) {
+  my::vector<int> vec;
+  vec.push_back(1);
+  vec.push_back(2);
+  my::vector<int> moved(std::move(vec));
+  EXPECT_EQ(static_cast<size_t>(2), moved.size());
+  EXPECT_EQ(static_cast<size_t>(0), vec.size());
+  EXPECT_EQ(static_cast<size_t>(0), vec.capacity());
+  EXPECT_EQ(vec.data(), nullptr);
+  vec.push_back(3);
+  moved.push_back(4);
+  EXPECT_EQ(static_cast<size_t>(1), vec.size());
+  EXPECT_EQ(3, vec[0]);
+  EXPECT_EQ(static_cast<size_t>(3), moved.size());
+  EXPECT_EQ(4, moved[2]);
+}
+
+TEST(my_vector, empty_after_pop_back) {
+  my::vector<int> vec;
+  EXPECT_TRUE(vec.empty());
+  vec.push_back(1);
+  EXPECT_FALSE(vec.empty());
+  vec.pop_back();
+  EXPECT_TRUE(vec.empty());
+  vec.push_back(2);
+  vec.clear();
+  EXPECT_TRUE(vec.empty());
+}
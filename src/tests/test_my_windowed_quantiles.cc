@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+
+#include "../my_containers_plus.h"
+
+TEST(my_windowed_quantiles, small_window) {
+  my::windowed_quantiles<double> w(4);
+  ASSERT_THROW(w.median(), std::out_of_range);
+  for (double sample : {5.0, 1.0, 3.0}) w.push(sample);
+  ASSERT_EQ(3.0, w.median());
+  ASSERT_EQ(1.0, w.quantile(0));
+  ASSERT_EQ(5.0, w.quantile(1));
+  w.push(3.0);
+  w.push(9.0);  // evicts 5
+  ASSERT_EQ(4u, w.size());
+  ASSERT_EQ(9.0, w.quantile(1));
+  ASSERT_EQ(3.0, w.median());
+  ASSERT_EQ(1u, w.count_below(3.0));
+  ASSERT_THROW(w.quantile(1.5), std::invalid_argument);
+  ASSERT_THROW(my::windowed_quantiles<int>(0), std::invalid_argument);
+  ASSERT_THROW(w.push(std::nan("")), std::invalid_argument);
+  ASSERT_EQ(4u, w.size());  // refused, nothing evicted
+  ASSERT_EQ(9.0, w.quantile(1));
+  w.clear();
+  ASSERT_TRUE(w.empty());
+}
+
+TEST(my_windowed_quantiles, matches_sorting_the_window) {
+  my::windowed_quantiles<int> w(257);
+  std::deque<int> recent;
+  unsigned state = 31337;
+  for (int step = 0; step < 5000; step++) {
+    state = state * 1103515245u + 12345u;
+    int sample = int(state >> 16) % 1000;
+    w.push(sample);
+    recent.push_back(sample);
+    if (recent.size() > 257) recent.pop_front();
+    if (step % 97 != 0) continue;
+    std::vector<int> sorted(recent.begin(), recent.end());
+    std::sort(sorted.begin(), sorted.end());
+    for (double q : {0.0, 0.01, 0.5, 0.9, 0.99, 1.0}) {
+      size_t rank = size_t(std::llround(q * double(sorted.size() - 1)));
+      ASSERT_EQ(sorted[rank], w.quantile(q));
+    }
+  }
+  ASSERT_EQ(257u, w.size());
+}
@@ -302,7 +302,7 @@ void my::vector<T>::insert_many_back(Args&&... args) {
 /* Проверяет пустой ли контейнер */
 template <typename T>
 bool my::vector<T>::empty() const noexcept {
-  return capacity() == 0;
+  return begin_ == end_;
 }
 
 /* Возвращает количество элементов */
@@ -426,7 +426,7 @@ my::vector<T>::vector(vector&& v) noexcept
     : begin_(v.begin_), end_(v.end_), AllEnd_(v.AllEnd_) {
   v.begin_ = nullptr;
   v.end_ = nullptr;
-  AllEnd_ = nullptr;
+  v.AllEnd_ = nullptr;
 }
 /* Деструктор */
 template <typename T>
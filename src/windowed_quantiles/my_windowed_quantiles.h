@@ -0,0 +1,72 @@
+#ifndef CONTAINERS_SRC_WINDOWED_QUANTILES_MY_WINDOWED_QUANTILES_H_
+#define CONTAINERS_SRC_WINDOWED_QUANTILES_MY_WINDOWED_QUANTILES_H_
+
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../multiset/my_multiset.h"
+#include "../vector/my_vector.h"
+
+namespace my {
+
+// Quantiles of the last `window` samples, like latencies of recent
+// requests. A ring buffer remembers arrival order, a multiset keeps the
+// samples sorted with subtree sizes: push, eviction of the oldest sample
+// and any quantile each cost O(log window).
+template <typename T, typename Compare = std::less<T>>
+class windowed_quantiles {
+ public:
+  using size_type = size_t;
+
+  explicit windowed_quantiles(size_type window)
+      : ring(window ? window : 1), window_(window) {
+    if (window == 0) throw std::invalid_argument("Empty quantile window");
+  }
+
+  // Evicts the oldest sample of a full window. NaN is refused: it compares
+  // false both ways and would break the order of the sorted samples.
+  void push(const T &sample) {
+    if constexpr (std::is_floating_point<T>::value)
+      if (std::isnan(sample)) throw std::invalid_argument("NaN sample");
+    if (count == window_)
+      sorted.erase(ring[head]);
+    else
+      ++count;
+    ring[head] = sample;
+    head = head + 1 == window_ ? 0 : head + 1;
+    sorted.add(sample);
+  }
+
+  // The sample at rank round(q * (size - 1)) of the sorted window: q = 0
+  // is the smallest, q = 1 the largest, no interpolation between samples.
+  const T &quantile(double q) const {
+    if (count == 0) throw std::out_of_range("No samples in the window");
+    if (!(q >= 0 && q <= 1))
+      throw std::invalid_argument("Quantile out of [0, 1]");
+    return sorted.select(size_type(std::llround(q * double(count - 1))));
+  }
+  const T &median() const { return quantile(0.5); }  // the upper one
+                                                     // of an even window
+  size_type count_below(const T &value) const { return sorted.rank(value); }
+
+  size_type size() const { return count; }
+  size_type window() const { return window_; }
+  bool empty() const { return count == 0; }
+  void clear() {
+    sorted.clear();
+    count = 0;
+    head = 0;
+  }
+
+ private:
+  vector<T> ring;       // samples by arrival, the oldest at head
+  size_type window_;
+  size_type head = 0;   // next slot to write
+  size_type count = 0;  // samples in the window
+  multiset<T, Compare> sorted;
+};
+
+}  // namespace my
+
+#endif  // CONTAINERS_SRC_WINDOWED_QUANTILES_MY_WINDOWED_QUANTILES_H_